@@ -0,0 +1,137 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 20.10.2025
+ * @description: Key-value store that partitions keys across N independent skip lists,
+ * each with its own lock, so writers to different shards never contend. Exposes the
+ * same put/get/erase API as ThreadByteTree plus ordered range scans and per-shard contention
+ * counters.
+ */
+
+#pragma once
+
+#include "skiplist.h"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace tbt {
+
+    /*
+     * How keys are assigned to shards.
+     *   - Hash: by a hash of the whole key; spreads any key distribution evenly but
+     *     loses ordering across shards.
+     *   - Prefix: by the first two key bytes (big-endian), split into equal ranges; shard i
+     *     only holds keys smaller than those of shard i+1, so scan walks shards in order
+     *     and touches only those overlapping the range. Skewed prefixes lead to skewed shards.
+     */
+    enum class Partitioning {
+        Hash,
+        Prefix
+    };
+
+    class ShardedThreadByteTree {
+    private:
+        std::vector<std::unique_ptr<List>> shards;
+        Partitioning partitioning;
+
+    public:
+        /*
+         * Construct a store made of shardCount skip lists.
+         * Parameters:
+         *   - shardCount: number of independent skip lists (>=1; at most 65536 for Prefix).
+         *   - maxLevel: number of levels of each skip list (>=1), indexed 0..maxLevel-1.
+         *   - probability: node promotion probability of each skip list; must be in (0,1).
+         *   - partitioning: key-to-shard assignment (Hash by default).
+         *   - concurrency: synchronization strategy of each skip list.
+         * Throws:
+         *   - std::invalid_argument if shardCount is out of range or probability is not strictly
+         *     between 0 and 1 (propagated from List).
+         */
+        ShardedThreadByteTree(std::size_t shardCount, std::size_t maxLevel, float probability,
+                              Partitioning partitioning = Partitioning::Hash,
+                              Concurrency concurrency = Concurrency::Locked);
+
+        /*
+         * Insert or update a value by key (synchronous, thread-safe).
+         * Parameters:
+         *   - key: byte-vector key.
+         *   - value: byte-vector value to associate with key.
+         * Thread-safety:
+         *   - Only the key's shard is locked; writers to other shards proceed in parallel.
+         */
+        void put(ByteView key, ByteView value);
+
+        /*
+         * Retrieve a value by key (synchronous, thread-safe).
+         * Parameters:
+         *   - key: byte-vector key to search for.
+         * Returns:
+         *   - Associated value if found; otherwise an empty ByteVector.
+         */
+        ByteVector get(ByteView key) const;
+
+        /*
+         * Retrieve a value by key into a caller-provided buffer, reusing its capacity.
+         * Returns:
+         *   - true if the key was found; false otherwise (out is then cleared).
+         */
+        bool get_into(ByteView key, ByteVector& out) const;
+
+        /*
+         * Retrieve a pinned, zero-copy view of a value (see ThreadByteTree::get_view).
+         * Returns:
+         *   - A ValueView pinning the key's shard; empty (false) if the key is absent.
+         */
+        ValueView get_view(ByteView key) const;
+
+        /*
+         * Remove a key and its value (synchronous, thread-safe).
+         * Parameters:
+         *   - key: byte-vector key to remove.
+         * Returns:
+         *   - true if the key was present and has been removed; false otherwise.
+         */
+        bool erase(ByteView key);
+
+        /*
+         * Entries with begin <= key < end in ascending order (empty bounds are open).
+         * Parameters:
+         *   - begin: inclusive lower bound; empty means from the smallest key.
+         *   - end: exclusive upper bound; empty means up to the largest key.
+         *   - limit: maximum number of entries returned.
+         * Complexity:
+         *   - Prefix: walks only the shards whose ranges overlap [begin, end), in order, and stops
+         *     once limit entries are collected.
+         *   - Hash: every shard holds part of any range, so each is scanned for up to limit entries
+         *     and the results are merged.
+         * Notes:
+         *   - Each shard is read through List::Scan; shards are not read at one point in time, so a
+         *     write concurrent with the scan may show up in one shard and not yet in another.
+         */
+        std::vector<Entry> scan(ByteView begin, ByteView end, std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+
+        /*
+         * Shard a key is stored in.
+         * Parameters:
+         *   - key: byte-vector key.
+         * Returns:
+         *   - Index in [0, shardCount()).
+         */
+        std::size_t shardOf(ByteView key) const;
+
+        /*
+         * Number of shards.
+         */
+        std::size_t shardCount() const;
+
+        /*
+         * Writer contention counters of every shard, indexed like shardOf.
+         * Returns:
+         *   - One LockStats per shard; a shard whose Contended/Acquisitions ratio stays high is
+         *     a hint to raise the shard count.
+         */
+        std::vector<LockStats> shardStats() const;
+    };
+
+}
@@ -2,26 +2,103 @@
  * @author: Viktor Shishmarev
  * @date: 16.10.2025
  * @description: Small wrapper around a concurrent SkipList to provide a simple
- * key-value API with byte-vector keys and values. Exposes thread-safe put/get.
+ * key-value API with byte-vector keys and values. Exposes thread-safe put/get/erase and an
+ * optional write-ahead log that makes writes durable.
+ * BasicThreadByteTree takes the skip list's key order policy; ThreadByteTree uses byte order.
  */
 
 
 #pragma once
 
+#include "hash.h"
 #include "skiplist.h"
+#include "snapshot.h"
+#include "wal.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
 
 namespace tbt {
 
-    class ThreadByteTree {
+    template <KeyOrder Order = ByteOrder>
+    class BasicThreadByteTree {
     private:
-        List skipList;
+        // Few enough that a batch holding all of them stays within the sanitizers' lock limits.
+        static constexpr std::size_t LogStripes = 32;
+
+        BasicList<Order> skipList;
+        std::unique_ptr<WriteAheadLog> log;
+        // Writes of one key append to the log and apply to the list under the same stripe, so the
+        // log orders updates of a key exactly as the list applied them.
+        std::array<std::mutex, LogStripes> stripes;
+
+        void apply(const WalRecord& record) {
+            if (record.Type == WalRecordType::Put) {
+                skipList.Insert(record.Key, record.Value);
+            } else {
+                skipList.Remove(record.Key);
+            }
+        }
+
+        std::mutex& stripeOf(ByteView key) {
+            return stripes[ByteVectorHash(key) % LogStripes];
+        }
+
+        // Apply a read-modify-write under the key's stripe, then log the value it left as a put:
+        // every logged write of the key holds the stripe, so that is the value just written. If
+        // eviction already took the key out again, the write is logged as an erase instead.
+        template <typename Write>
+        bool loggedRewrite(ByteView key, Write write) {
+            std::unique_lock<std::mutex> stripe(stripeOf(key));
+            if (!write()) {
+                return false;
+            }
+            ByteVector value;
+            const bool kept = skipList.SearchInto(key, value);
+            const WalRecord record{kept ? WalRecordType::Put : WalRecordType::Erase, key, value};
+            const std::uint64_t lsn = log->Append({&record, 1});
+            stripe.unlock();
+            log->Commit(lsn);
+            return true;
+        }
+
+        // Apply a batch under the stripes of its keys (taken in index order, so concurrent batches
+        // cannot deadlock), log it once applied, and wait for durability once the stripes are
+        // released. A batch the list rejects throws before anything is appended.
+        template <typename Write>
+        void loggedBatch(std::span<const WalRecord> records, Write write) {
+            std::uint64_t touched = 0;
+            for (const WalRecord& record : records) {
+                touched |= std::uint64_t{1} << (ByteVectorHash(record.Key) % LogStripes);
+            }
+            std::uint64_t lsn;
+            {
+                std::array<std::unique_lock<std::mutex>, LogStripes> locks;
+                for (std::size_t i = 0; i < LogStripes; i++) {
+                    if ((touched >> i) & 1) {
+                        locks[i] = std::unique_lock<std::mutex>(stripes[i]);
+                    }
+                }
+                write();
+                lsn = log->Append(records);
+            }
+            log->Commit(lsn);
+        }
 
     public:
+        using Cursor = typename BasicList<Order>::Cursor;
+        using Snapshot = typename BasicList<Order>::Snapshot;
+
         /*
          * Construct a ThreadByteTree backed by a SkipList.
          * Parameters:
          *   - maxLevel: number of levels in the internal skip list (>=1), indexed 0..maxLevel-1.
          *   - probability: node promotion probability used by the skip list; must be in (0,1).
+         *   - concurrency: synchronization strategy of the skip list; Locked serializes writers,
+         *     LockFree lets writers splice nodes concurrently with CAS, Combining serializes them
+         *     but batches the writes of threads that find the lock held.
          * Returns:
          *   - N/A
          * Throws:
@@ -29,21 +106,41 @@ namespace tbt {
          * Effects:
          *   - Initializes the internal skip list with the specified parameters.
          */
-        ThreadByteTree(std::size_t maxLevel, float probability);
+        BasicThreadByteTree(std::size_t maxLevel, float probability, Concurrency concurrency = Concurrency::Locked)
+            : skipList(maxLevel, probability, concurrency) {}
 
         /*
          * Insert or update a value by key (synchronous, thread-safe).
          * Parameters:
-         *   - key: byte-vector key.
-         *   - value: byte-vector value to associate with key.
+         *   - key: key bytes; any contiguous byte range (ByteVector, std::span, AsBytes of a string).
+         *   - value: value bytes to associate with key, copied once into the store.
          * Returns:
          *   - N/A
          * Effects:
          *   - If the key exists, its value is replaced; otherwise a new entry is created.
          * Thread-safety:
-         *   - Safe for concurrent calls; internally serialized for writers.
+         *   - Safe for concurrent calls; serialized for writers in Locked and Combining modes, CAS-based in LockFree mode.
+         * Durability:
+         *   - With a log attached (open_log), returns once the write is logged as the sync policy requires.
          */
-        void put(const ByteVector& key, const ByteVector& value);
+        void put(ByteView key, ByteView value) {
+            if (!log) {
+                skipList.Insert(key, value);
+                return;
+            }
+            // Logged only once applied, so a write the list rejects never reaches the log; wait for
+            // durability outside the stripe so that writers of other keys join the same group.
+            const WalRecord record{WalRecordType::Put, key, value};
+            std::unique_lock<std::mutex> stripe(stripeOf(key));
+            skipList.Insert(key, value);
+            const std::uint64_t lsn = log->Append({&record, 1});
+            stripe.unlock();
+            log->Commit(lsn);
+        }
+
+        void put(std::string_view key, std::string_view value) {
+            put(AsBytes(key), AsBytes(value));
+        }
 
         /*
          * Retrieve a value by key (synchronous, thread-safe).
@@ -52,9 +149,471 @@ namespace tbt {
          * Returns:
          *   - Associated value if found; otherwise an empty ByteVector.
          * Thread-safety:
-         *   - Safe for concurrent calls; multiple readers proceed concurrently.
+         *   - Safe for concurrent calls; readers take no lock.
          */
-        ByteVector get(const ByteVector& key) const;
+        ByteVector get(ByteView key) const {
+            return skipList.Search(key);
+        }
+
+        ByteVector get(std::string_view key) const {
+            return skipList.Search(AsBytes(key));
+        }
+
+        /*
+         * Retrieve a value by key into a caller-provided buffer (synchronous, thread-safe).
+         * Parameters:
+         *   - key: byte-vector key to search for.
+         *   - out: receives the value; its existing capacity is reused.
+         * Returns:
+         *   - true if the key was found; false otherwise (out is then cleared).
+         */
+        bool get_into(ByteView key, ByteVector& out) const {
+            return skipList.SearchInto(key, out);
+        }
+
+        bool get_into(std::string_view key, ByteVector& out) const {
+            return skipList.SearchInto(AsBytes(key), out);
+        }
+
+        /*
+         * Retrieve a pinned, zero-copy view of a value (synchronous, thread-safe).
+         * Parameters:
+         *   - key: byte-vector key to search for.
+         * Returns:
+         *   - A ValueView over the stored bytes; empty (false) if the key is absent.
+         * Notes:
+         *   - The bytes stay valid until the view is destroyed; destroy it on the calling thread and
+         *     keep it short-lived, as it holds back memory reclamation of the whole store.
+         */
+        ValueView get_view(ByteView key) const {
+            return skipList.Find(key);
+        }
+
+        ValueView get_view(std::string_view key) const {
+            return skipList.Find(AsBytes(key));
+        }
+
+        /*
+         * Remove a key and its value (synchronous, thread-safe).
+         * Parameters:
+         *   - key: byte-vector key to remove.
+         * Returns:
+         *   - true if the key was present and has been removed; false otherwise.
+         * Thread-safety:
+         *   - Safe for concurrent calls; readers running at the same time keep seeing valid memory,
+         *     the node is freed once they have left their epoch.
+         */
+        bool erase(ByteView key) {
+            if (!log) {
+                return skipList.Remove(key);
+            }
+            const WalRecord record{WalRecordType::Erase, key, {}};
+            std::unique_lock<std::mutex> stripe(stripeOf(key));
+            const bool removed = skipList.Remove(key);
+            const std::uint64_t lsn = log->Append({&record, 1});
+            stripe.unlock();
+            log->Commit(lsn);
+            return removed;
+        }
+
+        bool erase(std::string_view key) {
+            return erase(AsBytes(key));
+        }
+
+        /*
+         * Atomic read-modify-write of one key (see BasicList::Update): fn gets the current value
+         * (std::nullopt if absent) and returns true to store what it wrote to out.
+         * Returns:
+         *   - true if a value was stored.
+         * Durability:
+         *   - With a log attached, the stored value is logged as a put.
+         */
+        bool update(ByteView key, const UpdateFunction& fn) {
+            if (!log) {
+                return skipList.Update(key, fn);
+            }
+            return loggedRewrite(key, [&]() { return skipList.Update(key, fn); });
+        }
+
+        /*
+         * Store desired only if the current value equals expected (std::nullopt: only if the key
+         * is absent). Returns true if desired was stored.
+         */
+        bool compare_and_put(ByteView key, std::optional<ByteView> expected, ByteView desired) {
+            if (!log) {
+                return skipList.CompareAndInsert(key, expected, desired);
+            }
+            return loggedRewrite(key, [&]() { return skipList.CompareAndInsert(key, expected, desired); });
+        }
+
+        /*
+         * Insert only if the key is absent. Returns true if it was inserted.
+         */
+        bool put_if_absent(ByteView key, ByteView value) {
+            return compare_and_put(key, std::nullopt, value);
+        }
+
+        /*
+         * Register the operator merge applies (see BasicList::SetMergeOperator).
+         * Thread-safety:
+         *   - Call before the store is shared between threads.
+         */
+        void set_merge_operator(MergeOperator op) {
+            skipList.SetMergeOperator(std::move(op));
+        }
+
+        /*
+         * Combine the key's value with operand through the merge operator, atomically, without
+         * reading the value out first (see BasicList::Merge).
+         * Throws:
+         *   - std::logic_error if no merge operator is set; whatever the operator throws.
+         */
+        void merge(ByteView key, ByteView operand) {
+            if (!log) {
+                skipList.Merge(key, operand);
+                return;
+            }
+            loggedRewrite(key, [&]() { skipList.Merge(key, operand); return true; });
+        }
+
+        /*
+         * Look up a batch of keys at once (synchronous, thread-safe).
+         * Parameters:
+         *   - keys: keys in any order; sorted internally so each search resumes from the previous one.
+         * Returns:
+         *   - One slot per key, in the order of keys: the value, or std::nullopt if absent.
+         */
+        std::vector<std::optional<ByteVector>> multi_get(std::span<const ByteView> keys) const {
+            return skipList.MultiSearch(keys);
+        }
+
+        std::vector<std::optional<ByteVector>> multi_get(std::span<const ByteVector> keys) const {
+            const std::vector<ByteView> views(keys.begin(), keys.end());
+            return skipList.MultiSearch(views);
+        }
+
+        /*
+         * Insert or update a batch of entries at once (synchronous, thread-safe).
+         * Parameters:
+         *   - entries: key/value pairs in any order; for a key given several times the last one wins.
+         * Thread-safety:
+         *   - Locked mode takes the writer lock once per batch; readers are never blocked.
+         */
+        void multi_put(std::span<const std::pair<ByteView, ByteView>> entries) {
+            if (!log) {
+                skipList.MultiInsert(entries);
+                return;
+            }
+            std::vector<WalRecord> records;
+            records.reserve(entries.size());
+            for (const auto& [key, value] : entries) {
+                records.push_back({WalRecordType::Put, key, value});
+            }
+            loggedBatch(records, [&] { skipList.MultiInsert(entries); });
+        }
+
+        void multi_put(std::span<const std::pair<ByteVector, ByteVector>> entries) {
+            const std::vector<std::pair<ByteView, ByteView>> views(entries.begin(), entries.end());
+            multi_put(views);
+        }
+
+        /*
+         * Fill an empty store from entries sorted by key, e.g. when reloading at startup.
+         * Parameters:
+         *   - entries: random-access range of key/value pairs sorted by key (std::pair<ByteVector,
+         *     ByteVector>, std::pair<ByteView, ByteView>, ...); for equal keys the last one wins.
+         *   - threads: number of threads copying and linking entries.
+         * Throws:
+         *   - std::invalid_argument if entries are not sorted; std::logic_error if the store is not empty.
+         * Notes:
+         *   - Links every node in one pass with evenly spaced tower heights (see BasicList::BulkLoad).
+         *   - With a log attached every entry is logged as well, once the load succeeded; load
+         *     before open_log to avoid that.
+         */
+        template <std::ranges::random_access_range Entries>
+            requires std::convertible_to<std::ranges::range_reference_t<Entries>, std::pair<ByteView, ByteView>>
+        void bulk_load(const Entries& entries, std::size_t threads = 1) {
+            if (!log) {
+                skipList.BulkLoad(entries, threads);
+                return;
+            }
+            std::vector<WalRecord> records;
+            records.reserve(static_cast<std::size_t>(std::ranges::distance(entries)));
+            for (const auto& entry : entries) {
+                const std::pair<ByteView, ByteView> view = entry;
+                records.push_back({WalRecordType::Put, view.first, view.second});
+            }
+            loggedBatch(records, [&] { skipList.BulkLoad(entries, threads); });
+        }
+
+        /*
+         * Make writes durable through a write-ahead log: replay the file into the store, then
+         * append every later put, multi_put, bulk_load and erase to it.
+         * Parameters:
+         *   - path: log file; created if missing. A torn record at its end (from a crash mid-write)
+         *     is dropped.
+         *   - options: sync policy; by default each write returns only once it is fdatasync'd, with
+         *     concurrent writers sharing one write and one sync (group commit).
+         * Returns:
+         *   - Number of records replayed.
+         * Throws:
+         *   - std::logic_error if a log is already attached.
+         *   - std::invalid_argument for a non-positive interval with SyncPolicy::Interval (from
+         *     WriteAheadLog); the file is then replayed but no log is attached.
+         *   - std::system_error if the file cannot be read, truncated or opened.
+         * Thread-safety:
+         *   - Call before the store is shared between threads.
+         * Notes:
+         *   - A write is visible to readers as soon as it is applied, i.e. possibly just before it
+         *     is durable. If the log fails, the write that observed the failure throws and the log
+         *     refuses every later write.
+         *   - The log only grows; it is not compacted.
+         */
+        std::uint64_t open_log(const std::string& path, WalOptions options = {}) {
+            if (log) {
+                throw std::logic_error("a write-ahead log is already attached");
+            }
+            const std::uint64_t replayed = WriteAheadLog::Replay(path, [this](const WalRecord& record) { apply(record); });
+            log = std::make_unique<WriteAheadLog>(path, options);
+            return replayed;
+        }
+
+        /*
+         * Force everything logged so far to stable storage, whatever the sync policy.
+         */
+        void sync_log() {
+            if (log) {
+                log->Sync();
+            }
+        }
+
+        /*
+         * Counters of the attached log (all zero without one).
+         */
+        WalStats logStats() const {
+            return log ? log->Stats() : WalStats{};
+        }
+
+        /*
+         * Entries with begin <= key < end in ascending order (synchronous, thread-safe).
+         * Parameters:
+         *   - begin: inclusive lower bound; empty means from the smallest key.
+         *   - end: exclusive upper bound; empty means up to the largest key.
+         *   - limit: maximum number of entries returned (e.g. a page size).
+         * Returns:
+         *   - Copies of the matching entries.
+         */
+        std::vector<Entry> scan(ByteView begin, ByteView end, std::size_t limit = std::numeric_limits<std::size_t>::max()) const {
+            return skipList.Scan(begin, end, limit);
+        }
+
+        /*
+         * Entries whose key starts with prefix, in ascending order (byte order only).
+         */
+        std::vector<Entry> scan_prefix(ByteView prefix, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+            requires std::same_as<Order, ByteOrder> {
+            return skipList.ScanPrefix(prefix, limit);
+        }
+
+        /*
+         * First entry whose key is not less than key, or std::nullopt.
+         */
+        std::optional<Entry> lower_bound(ByteView key) const {
+            return skipList.LowerBound(key);
+        }
+
+        /*
+         * Batched cursor over [begin, end) for paginated walks (see BasicList::Cursor).
+         * Notes:
+         *   - Holds no lock or pin between batches; concurrent puts and erases may or may not be seen.
+         */
+        Cursor cursor(ByteView begin = {}, ByteView end = {}, ScanOrder order = ScanOrder::Ascending) const {
+            return skipList.OpenCursor(begin, end, order);
+        }
+
+        /*
+         * Write every entry to an immutable snapshot file that MappedSnapshot serves without loading
+         * it (byte order only).
+         * Parameters:
+         *   - path: destination; replaced atomically once the file is complete and synced.
+         * Returns:
+         *   - Number of entries written.
+         * Throws:
+         *   - std::system_error on I/O failure; path is then left untouched.
+         * Thread-safety:
+         *   - Walks level 0 with a Cursor, so no lock is held and each epoch pin covers 64 entries:
+         *     readers and writers keep running. The result is weakly consistent, like the cursor:
+         *     entries left alone during the walk are all included, concurrent writes may or may not be.
+         */
+        std::uint64_t snapshot(const std::string& path) const
+            requires std::same_as<Order, ByteOrder> {
+            SnapshotWriter writer(path);
+            for (Cursor cursor = skipList.OpenCursor(); cursor.Valid(); cursor.Next()) {
+                writer.Add(cursor.Key(), cursor.Value());
+            }
+            writer.Finish();
+            return writer.Entries();
+        }
+
+        /*
+         * Point-in-time view of the store: get and scan through it see every write completed
+         * before it was taken and none after (see BasicList::Snapshot).
+         * Throws:
+         *   - std::logic_error unless enable_snapshots was called.
+         * Thread-safety:
+         *   - Takes the writer lock once, briefly; the snapshot's reads take no lock. Old versions
+         *     are kept while any snapshot that can read them is open.
+         */
+        Snapshot snapshot() {
+            return skipList.OpenSnapshot();
+        }
+
+        /*
+         * Keep versions of overwritten and erased keys for open snapshots (see
+         * BasicList::EnableSnapshots).
+         * Throws:
+         *   - std::logic_error if the store is not empty, is LockFree, or already keeps versions.
+         * Thread-safety:
+         *   - Call before the store is shared between threads, and before open_log or bulk_load.
+         */
+        void enable_snapshots() {
+            skipList.EnableSnapshots();
+        }
+
+        /*
+         * Answer most lookups of absent keys from a counting Bloom filter instead of a full descent
+         * (see BasicList::EnableFilter).
+         * Parameters:
+         *   - expectedKeys: number of keys the store is expected to hold.
+         *   - falsePositiveRate: share of absent keys still searched for, in (0, 1).
+         * Throws:
+         *   - std::invalid_argument for bad parameters; std::logic_error if the store is not empty
+         *     or already has a filter.
+         * Thread-safety:
+         *   - Call before the store is shared between threads, and before open_log or bulk_load so
+         *     that the keys they load are counted.
+         */
+        void enable_filter(std::size_t expectedKeys, double falsePositiveRate) {
+            skipList.EnableFilter(expectedKeys, falsePositiveRate);
+        }
+
+        /*
+         * Filter outcomes: misses answered by the filter alone, hits, and false positives.
+         */
+        FilterStats filterStats() const {
+            return skipList.GetFilterStats();
+        }
+
+        /*
+         * Serve get, get_into, get_view and updates of existing keys from a hash index over the
+         * nodes instead of a descent (see BasicList::EnableIndex); the skip list still orders scans.
+         * Parameters:
+         *   - expectedKeys: number of keys the store is expected to hold.
+         * Throws:
+         *   - std::invalid_argument if expectedKeys is 0; std::logic_error if the store is not
+         *     empty or already has an index.
+         * Thread-safety:
+         *   - Call before the store is shared between threads, and before open_log or bulk_load.
+         */
+        void enable_index(std::size_t expectedKeys) {
+            skipList.EnableIndex(expectedKeys);
+        }
+
+        /*
+         * Let the skip list's tower limit follow the number of entries (see
+         * BasicList::EnableAdaptiveLevels).
+         * Throws:
+         *   - std::logic_error if already enabled.
+         * Thread-safety:
+         *   - Call before the store is shared between threads.
+         */
+        void enable_adaptive_levels() {
+            skipList.EnableAdaptiveLevels();
+        }
+
+        /*
+         * Re-tower up to `nodes` nodes to the current tower limit; true once a pass over the store
+         * is complete (see BasicList::RebalanceStep). Holds the writer lock for one step only, so
+         * it can run in the background next to normal traffic.
+         * Throws:
+         *   - std::logic_error for a LockFree store.
+         */
+        bool rebalance_step(std::size_t nodes = 256) {
+            return skipList.RebalanceStep(nodes);
+        }
+
+        /*
+         * Tower limit, levels in use and measured search depth of the skip list (see LevelStats).
+         */
+        LevelStats levelStats() const {
+            return skipList.GetLevelStats();
+        }
+
+        /*
+         * Use the store as a bounded cache: once its entries take more than budgetBytes, cold
+         * entries are evicted by CLOCK, with get, get_into, get_view and multi_get marking the
+         * entries they find (see BasicList::EnableEviction).
+         * Throws:
+         *   - std::invalid_argument if budgetBytes is 0; std::logic_error if already enabled or
+         *     the store keeps versions for snapshots.
+         * Thread-safety:
+         *   - Call before the store is shared between threads.
+         * Notes:
+         *   - Evictions are not written to the log: replaying it brings evicted keys back, and the
+         *     next write trims the store to the budget again. The one exception is a key evicted
+         *     by its own update, compare_and_put or merge before the result was logged: that
+         *     write is logged as an erase, so replay never stores a value the store did not keep.
+         */
+        void enable_eviction(std::size_t budgetBytes) {
+            skipList.EnableEviction(budgetBytes);
+        }
+
+        /*
+         * Budget, charged bytes, hit rate and eviction counters (see CacheStats).
+         */
+        CacheStats cacheStats() const {
+            return skipList.GetCacheStats();
+        }
+
+        /*
+         * Memory used by the store.
+         * Returns:
+         *   - ArenaStats of the skip list arena: reserved, used and recyclable bytes.
+         * Thread-safety:
+         *   - Safe for concurrent calls.
+         */
+        ArenaStats memoryStats() const {
+            return skipList.GetMemoryStats();
+        }
+
+        /*
+         * Writer contention of the store.
+         * Returns:
+         *   - LockStats of the skip list: lock acquisitions, contended writes, time spent waiting
+         *     and writes applied by combining.
+         * Thread-safety:
+         *   - Safe for concurrent calls.
+         */
+        LockStats lockStats() const {
+            return skipList.GetLockStats();
+        }
+
+        /*
+         * Usage report of the store: entries, key/value/overhead bytes, tower-height histogram
+         * against maxLevel and probability, nodes visited per lookup and writer contention.
+         * Returns:
+         *   - ListMetrics of the skip list; the counted fields are 0 unless the library is built
+         *     with THREADBYTETREE_METRICS=ON (see BasicList::GetMetrics).
+         * Thread-safety:
+         *   - Safe for concurrent calls.
+         */
+        ListMetrics metrics() const {
+            return skipList.GetMetrics();
+        }
     };
 
+    using ThreadByteTree = BasicThreadByteTree<>;
+
+    extern template class BasicThreadByteTree<ByteOrder>;
+
 }
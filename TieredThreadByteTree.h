@@ -0,0 +1,239 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 02.11.2025
+ * @description: Key-value store that keeps recent writes in a skip list (the memtable) and moves
+ * older data to immutable sorted run files on disk, LSM-style, so the data set can outgrow RAM.
+ * A full memtable is frozen and flushed by a background thread; another background thread merges
+ * runs of similar size. Every run has a Bloom filter, so lookups of absent keys rarely touch it.
+ */
+
+#pragma once
+
+#include "filter.h"
+#include "skiplist.h"
+#include "snapshot.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tbt {
+
+    struct TieredOptions {
+        /*
+         * Approximate bytes of keys, values and node overhead at which the memtable is frozen.
+         */
+        std::size_t MemtableBytes = 64 << 20;
+        /*
+         * Frozen memtables waiting for their flush; when this many are pending, writers stall
+         * until the flusher catches up.
+         */
+        std::size_t MaxFrozen = 2;
+        /*
+         * Number of runs of similar size (within a factor of 2) that are merged into one.
+         */
+        std::size_t CompactionTrigger = 4;
+        /*
+         * Bloom filter memory per key of a run; 10 bits give about 1% false positives.
+         */
+        std::size_t BloomBitsPerKey = 10;
+        /*
+         * Skip list parameters of the memtables (see BasicList).
+         */
+        std::size_t MaxLevel = 20;
+        float Probability = 0.25f;
+        Concurrency Mode = Concurrency::Locked;
+    };
+
+    /*
+     * Counters of a TieredThreadByteTree.
+     *   - Memtables: the active memtable plus the frozen ones awaiting a flush.
+     *   - Runs, RunBytes: run files currently read, and their total size.
+     *   - Flushes, Compactions: runs written by each background thread.
+     *   - Stalls: writes that waited for a flush because MaxFrozen memtables were pending.
+     *   - FilterSkips: run lookups answered "absent" by the Bloom filter alone.
+     *   - FilterFalsePositives: run lookups the filter let through for a key the run does not hold.
+     *   - RetiredVersions: replaced views of the store kept until no reader can still use them;
+     *     each may hold a flushed memtable or compacted runs. The flusher frees them once idle.
+     */
+    struct TieredStats {
+        std::size_t Memtables;
+        std::size_t Runs;
+        std::uint64_t RunBytes;
+        std::uint64_t Flushes;
+        std::uint64_t Compactions;
+        std::uint64_t Stalls;
+        std::uint64_t FilterSkips;
+        std::uint64_t FilterFalsePositives;
+        std::size_t RetiredVersions;
+    };
+
+    class TieredThreadByteTree {
+    private:
+        struct Run;
+        struct Version;
+
+        std::string directory;
+        TieredOptions options;
+
+        // Writers insert into the active memtable under a shared gate; freezing takes it
+        // exclusively, so no write can still land in a memtable once it is handed to the flusher.
+        mutable std::shared_mutex writeGate;
+        List* active = nullptr;
+        std::atomic<std::size_t> activeBytes{0};
+
+        // The current Version is swapped under stateMux; scans copy the pointer and then read
+        // without any lock, from memtables and runs that stay alive as long as they hold it.
+        mutable std::mutex stateMux;
+        std::shared_ptr<const Version> current;
+        std::condition_variable_any changed;
+        std::exception_ptr failure;
+
+        // Point reads neither lock nor touch a reference count: they pin this domain and read
+        // the published Version. A replaced Version waits in retiredVersions (under stateMux),
+        // tagged with the epoch of its replacement, until no reader can still be using it; the
+        // flusher keeps collecting them while it has nothing to flush.
+        mutable EpochManager readers;
+        std::atomic<const Version*> published{nullptr};
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<const Version>>> retiredVersions;
+
+        // Serializes the two background threads' updates of the run list and of the manifest.
+        std::mutex installMux;
+        std::uint64_t nextRunNumber = 1;
+
+        // Counted by readers, so spread over cache lines by thread (see ThreadIndex).
+        struct alignas(64) ReadCounters {
+            std::atomic<std::uint64_t> FilterSkips{0};
+            std::atomic<std::uint64_t> FilterFalsePositives{0};
+        };
+        mutable std::array<ReadCounters, 16> readCounters;
+        std::atomic<std::uint64_t> flushes{0};
+        std::atomic<std::uint64_t> compactions{0};
+        std::atomic<std::uint64_t> stalls{0};
+
+        std::jthread flusher;
+        std::jthread compactor;
+
+        std::shared_ptr<const Version> acquire() const;
+        void publish(std::shared_ptr<const Version> next);
+        void reclaimVersions();
+        void write(ByteView key, ByteView value, bool tombstone);
+        void freeze(bool force);
+        void flushLoop(std::stop_token stop);
+        void compactLoop(std::stop_token stop);
+        std::shared_ptr<Run> openRun(std::uint64_t number) const;
+        void writeManifest(const std::vector<std::shared_ptr<Run>>& runs);
+        std::string runPath(std::uint64_t number, const char* suffix) const;
+
+    public:
+        /*
+         * Open (or create) a store in a directory.
+         * Parameters:
+         *   - directory: holds the MANIFEST, the run files (run-N.sst) and their filters
+         *     (run-N.filter); created if missing. Files the manifest does not list, left over by
+         *     a crash, are removed.
+         *   - options: memtable budget, compaction trigger, filter size and skip list parameters.
+         * Throws:
+         *   - std::invalid_argument if MemtableBytes or MaxFrozen is 0, if CompactionTrigger is below
+         *     2, or (as BasicList) for bad skip list parameters.
+         *   - std::system_error if the directory or a run cannot be read.
+         *   - std::runtime_error if the manifest or a run is damaged.
+         */
+        TieredThreadByteTree(const std::string& directory, TieredOptions options = {});
+
+        /*
+         * Flush the memtables to runs (see flush), then stop the background threads. An I/O
+         * failure at this point loses the unflushed writes.
+         */
+        ~TieredThreadByteTree();
+
+        TieredThreadByteTree(const TieredThreadByteTree&) = delete;
+        TieredThreadByteTree& operator=(const TieredThreadByteTree&) = delete;
+
+        /*
+         * Insert or update a value by key (synchronous, thread-safe).
+         * Throws:
+         *   - The background failure (e.g. std::system_error) if a flush failed and the write had
+         *     to wait for it.
+         * Notes:
+         *   - The write lives in memory until its memtable is flushed; call flush() to make it
+         *     durable.
+         */
+        void put(ByteView key, ByteView value);
+
+        void put(std::string_view key, std::string_view value) {
+            put(AsBytes(key), AsBytes(value));
+        }
+
+        /*
+         * Retrieve a value by key (synchronous, thread-safe).
+         * Returns:
+         *   - Associated value if found; otherwise an empty ByteVector.
+         * Complexity:
+         *   - The memtables first, then the runs newest first; a run whose filter rules the key
+         *     out costs one cache line.
+         * Thread-safety:
+         *   - Takes no lock and writes no memory shared with other readers, so reads scale with
+         *     the number of threads.
+         */
+        ByteVector get(ByteView key) const;
+
+        ByteVector get(std::string_view key) const {
+            return get(AsBytes(key));
+        }
+
+        /*
+         * Retrieve a value by key into a caller-provided buffer, reusing its capacity.
+         * Returns:
+         *   - true if the key was found; false otherwise (out is then cleared).
+         */
+        bool get_into(ByteView key, ByteVector& out) const;
+
+        bool get_into(std::string_view key, ByteVector& out) const {
+            return get_into(AsBytes(key), out);
+        }
+
+        /*
+         * Remove a key (synchronous, thread-safe).
+         * Notes:
+         *   - Writes a tombstone that hides older values of the key; it is dropped once a
+         *     compaction merges it into the oldest run. Unlike ThreadByteTree::erase, it does not
+         *     report whether the key existed, which would cost a lookup.
+         */
+        void erase(ByteView key);
+
+        void erase(std::string_view key) {
+            erase(AsBytes(key));
+        }
+
+        /*
+         * Entries with begin <= key < end in ascending order, merged across memtables and runs
+         * (empty bounds are open).
+         * Notes:
+         *   - Reads the memtables through cursors, so it is weakly consistent like
+         *     ThreadByteTree::cursor; runs are immutable.
+         */
+        std::vector<Entry> scan(ByteView begin, ByteView end, std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+
+        /*
+         * Freeze the active memtable and wait until every frozen memtable is written to a run
+         * and recorded in the manifest.
+         * Throws:
+         *   - The background failure if a flush failed.
+         */
+        void flush();
+
+        /*
+         * Counters of the store.
+         */
+        TieredStats stats() const;
+    };
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Per-key cost of List::MultiSearch / List::MultiInsert against point Search / Insert, by batch size.
+ * get_ns draws keys uniformly; clustered_get_ns draws each batch from a window of about 2x its size
+ * of neighbouring keys (e.g. a page of related records), where the finger path is short.
+ * Usage: threadbytetree_bench_batch [keys=1000000] [operations=262144] [keyBytes=16]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "include/skiplist.h"
+
+using namespace tbt;
+
+static ByteVector random_key(std::mt19937_64& rng, std::size_t size) {
+    ByteVector v(size);
+    for (auto& byte : v) byte = static_cast<uint8_t>(rng());
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t operations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 262144;
+    const std::size_t keyBytes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+
+    std::mt19937_64 rng(42);
+    std::vector<ByteVector> present;
+    present.reserve(keys);
+    for (std::size_t i = 0; i < keys; ++i) present.push_back(random_key(rng, keyBytes));
+
+    List list(32, 0.5f);
+    const ByteVector value(8, 0x5A);
+    for (const auto& key : present) list.Insert(key, value);
+
+    std::uniform_int_distribution<std::size_t> pick(0, keys - 1);
+    std::vector<ByteView> lookups(operations);
+    for (auto& key : lookups) key = present[pick(rng)];
+    std::vector<ByteVector> sorted = present;
+    std::sort(sorted.begin(), sorted.end(), [](const ByteVector& a, const ByteVector& b) { return ByteVectorLess(a, b); });
+
+    std::vector<ByteVector> fresh(operations);
+    for (auto& key : fresh) key = random_key(rng, keyBytes + 1);
+
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [operations](Clock::duration elapsed) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(operations);
+    };
+
+    std::size_t found = 0;
+    std::cout << "batch get_ns clustered_get_ns put_ns\n";
+    for (const std::size_t batch : {1, 4, 16, 64, 256, 1024, 4096}) {
+        auto start = Clock::now();
+        if (batch == 1) {
+            for (const ByteView key : lookups) found += list.Search(key).empty() ? 0 : 1;
+        } else {
+            for (std::size_t at = 0; at < operations; at += batch) {
+                const std::span<const ByteView> slice(lookups.data() + at, std::min(batch, operations - at));
+                for (const auto& result : list.MultiSearch(slice)) found += result ? 1 : 0;
+            }
+        }
+        const double getNs = nsPerOp(Clock::now() - start);
+
+        std::vector<ByteView> clustered(operations);
+        for (std::size_t at = 0; at < operations; at += batch) {
+            const std::size_t window = std::min(keys, 2 * batch);
+            const std::size_t base = std::uniform_int_distribution<std::size_t>(0, keys - window)(rng);
+            for (std::size_t i = at; i < std::min(at + batch, operations); ++i) clustered[i] = sorted[base + pick(rng) % window];
+            std::shuffle(clustered.begin() + static_cast<std::ptrdiff_t>(at), clustered.begin() + static_cast<std::ptrdiff_t>(std::min(at + batch, operations)), rng);
+        }
+        start = Clock::now();
+        if (batch == 1) {
+            for (const ByteView key : clustered) found += list.Search(key).empty() ? 0 : 1;
+        } else {
+            for (std::size_t at = 0; at < operations; at += batch) {
+                const std::span<const ByteView> slice(clustered.data() + at, std::min(batch, operations - at));
+                for (const auto& result : list.MultiSearch(slice)) found += result ? 1 : 0;
+            }
+        }
+        const double clusteredNs = nsPerOp(Clock::now() - start);
+
+        // Each round writes the same fresh keys: the first inserts them, later ones update.
+        start = Clock::now();
+        if (batch == 1) {
+            for (const auto& key : fresh) list.Insert(key, value);
+        } else {
+            std::vector<std::pair<ByteView, ByteView>> entries;
+            for (std::size_t at = 0; at < operations; at += batch) {
+                entries.clear();
+                for (std::size_t i = at; i < std::min(at + batch, operations); ++i) entries.emplace_back(fresh[i], value);
+                list.MultiInsert(entries);
+            }
+        }
+        const double putNs = nsPerOp(Clock::now() - start);
+        std::cout << batch << ' ' << getNs << ' ' << clusteredNs << ' ' << putNs << '\n';
+    }
+    return found == 14 * operations ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+/*
+ * ByteVectorLess / ByteVectorEqual cost by key length and shared-prefix length, against the
+ * byte-at-a-time loop they replaced, and FixedKey<N>::Less against ByteVectorLess for fixed-width
+ * keys.
+ * Usage: threadbytetree_bench_compare [pairs=4096] [rounds=2000]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "include/comparator.h"
+
+using namespace tbt;
+
+namespace {
+    bool byteLoopLess(ByteView a, ByteView b) {
+        for (std::size_t i = 0; i < a.size() && i < b.size(); ++i) {
+            if (a[i] < b[i]) return true;
+            if (a[i] > b[i]) return false;
+        }
+        return a.size() < b.size();
+    }
+
+    bool byteLoopEqual(ByteView a, ByteView b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+
+    // Pairs of keys of the given length that agree on the first shared bytes and differ right after.
+    std::vector<std::pair<ByteVector, ByteVector>> make_pairs(std::mt19937_64& rng, std::size_t pairs, std::size_t length, std::size_t shared) {
+        std::vector<std::pair<ByteVector, ByteVector>> out(pairs);
+        for (auto& [a, b] : out) {
+            a.resize(length);
+            for (auto& byte : a) byte = static_cast<uint8_t>(rng());
+            b = a;
+            if (shared < length) b[shared] = static_cast<uint8_t>(a[shared] ^ (1 + rng() % 255));
+        }
+        return out;
+    }
+
+    template <typename Fn>
+    double ns_per_call(const std::vector<std::pair<ByteVector, ByteVector>>& pairs, std::size_t rounds, Fn fn, std::size_t& sink) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const auto& [a, b] : pairs) sink += fn(a, b) ? 1 : 0;
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return static_cast<double>(elapsed.count()) / static_cast<double>(rounds * pairs.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t pairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    const std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+
+    std::mt19937_64 rng(42);
+    std::size_t sink = 0;
+    std::cout << "length shared less_loop_ns less_ns equal_loop_ns equal_ns\n";
+    for (const std::size_t length : {8, 16, 32, 64, 128, 256}) {
+        for (const std::size_t shared : {std::size_t{0}, length / 2, length - 1, length}) {
+            const auto data = make_pairs(rng, pairs, length, shared);
+            std::cout << length << ' ' << shared
+                      << ' ' << ns_per_call(data, rounds, byteLoopLess, sink)
+                      << ' ' << ns_per_call(data, rounds, ByteVectorLess, sink)
+                      << ' ' << ns_per_call(data, rounds, byteLoopEqual, sink)
+                      << ' ' << ns_per_call(data, rounds, ByteVectorEqual, sink) << '\n';
+        }
+    }
+
+    std::cout << "\nlength shared less_ns fixed_less_ns\n";
+    auto fixed = [&]<std::size_t Size>(FixedKey<Size>) {
+        for (const std::size_t shared : {std::size_t{0}, Size / 2, Size - 1, Size}) {
+            const auto data = make_pairs(rng, pairs, Size, shared);
+            std::cout << Size << ' ' << shared
+                      << ' ' << ns_per_call(data, rounds, ByteVectorLess, sink)
+                      << ' ' << ns_per_call(data, rounds, FixedKey<Size>::Less, sink) << '\n';
+        }
+    };
+    fixed(FixedKey<4>{});
+    fixed(FixedKey<8>{});
+    fixed(FixedKey<16>{});
+    fixed(FixedKey<24>{});
+    return sink == 0 ? 1 : 0;
+}
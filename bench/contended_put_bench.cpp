@@ -0,0 +1,76 @@
+/*
+ * Contended puts: 1, 2, 4, ... threads writing random keys into one ThreadByteTree at once, in
+ * each concurrency mode. Reports total throughput, and for Combining how many of the writes were
+ * applied by another thread's pass and how many lock acquisitions the burst took.
+ * Usage: threadbytetree_bench_contended_put [putsPerThread=200000] [maxThreads=hardware] [keySpace=1000000]
+ */
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ThreadByteTree.h"
+
+using namespace tbt;
+
+static ByteVector key_of(std::uint64_t x) {
+    ByteVector key(16);
+    for (int i = 0; i < 8; ++i) key[static_cast<std::size_t>(i)] = static_cast<uint8_t>(x >> (56 - 8 * i));
+    for (int i = 8; i < 16; ++i) key[static_cast<std::size_t>(i)] = static_cast<uint8_t>(x * 0x9E3779B97F4A7C15ull >> (8 * (i - 8)));
+    return key;
+}
+
+static const char* name_of(const Concurrency mode) {
+    switch (mode) {
+        case Concurrency::LockFree: return "lockfree";
+        case Concurrency::Combining: return "combining";
+        default: return "locked";
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t putsPerThread = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const std::size_t maxThreads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t keySpace = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000000;
+    const ByteVector value(100, 0x5A);
+
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        std::cout << "threads=" << threads;
+        for (const Concurrency mode : {Concurrency::Locked, Concurrency::Combining, Concurrency::LockFree}) {
+            // Keys are generated up front so that the timed loop is nothing but puts.
+            std::vector<std::vector<ByteVector>> keys(threads);
+            for (std::size_t t = 0; t < threads; ++t) {
+                std::mt19937_64 rng(t + 1);
+                std::uniform_int_distribution<std::uint64_t> pick(0, keySpace - 1);
+                for (std::size_t i = 0; i < putsPerThread; ++i) keys[t].push_back(key_of(pick(rng)));
+            }
+
+            ThreadByteTree tree(24, 0.25f, mode);
+            std::barrier start(static_cast<std::ptrdiff_t>(threads + 1));
+            std::vector<std::jthread> writers;
+            for (std::size_t t = 0; t < threads; ++t) {
+                writers.emplace_back([&, t]() {
+                    start.arrive_and_wait();
+                    for (const ByteVector& key : keys[t]) tree.put(key, value);
+                });
+            }
+            start.arrive_and_wait();
+            const auto begin = std::chrono::steady_clock::now();
+            writers.clear();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            const LockStats stats = tree.lockStats();
+            std::cout << " " << name_of(mode) << "_mops=" << static_cast<double>(threads * putsPerThread) / seconds / 1e6;
+            if (mode == Concurrency::Combining) {
+                std::cout << " (acquisitions=" << stats.Acquisitions << " combined=" << stats.Combined << ")";
+            }
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
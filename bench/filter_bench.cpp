@@ -0,0 +1,80 @@
+/*
+ * List lookups with and without a counting Bloom filter in front, on a mix of hits and misses
+ * (70% misses by default), plus the insert and remove overhead of keeping the filter up to date.
+ * Usage: threadbytetree_bench_filter [keys=1000000] [lookups=1000000] [missPercent=70] [falsePositiveRate=0.01]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "include/skiplist.h"
+
+using namespace tbt;
+
+static ByteVector random_key(std::mt19937_64& rng, std::size_t size) {
+    ByteVector v(size);
+    for (auto& byte : v) byte = static_cast<uint8_t>(rng());
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const std::size_t missPercent = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 70;
+    const double falsePositiveRate = argc > 4 ? std::strtod(argv[4], nullptr) : 0.01;
+
+    std::mt19937_64 rng(42);
+    std::vector<ByteVector> present;
+    present.reserve(keys);
+    for (std::size_t i = 0; i < keys; ++i) present.push_back(random_key(rng, 16));
+
+    // Misses are 17-byte keys, so none of them is present.
+    std::uniform_int_distribution<std::size_t> pick(0, keys - 1);
+    std::uniform_int_distribution<std::size_t> percent(0, 99);
+    std::vector<ByteVector> probes;
+    probes.reserve(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        probes.push_back(percent(rng) < missPercent ? random_key(rng, 17) : present[pick(rng)]);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [](Clock::duration elapsed, std::size_t ops) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(ops);
+    };
+    const ByteVector value(8, 0x5A);
+
+    for (const bool filtered : {false, true}) {
+        List list(32, 0.25f);
+        if (filtered) list.EnableFilter(keys, falsePositiveRate);
+
+        auto start = Clock::now();
+        for (const auto& key : present) list.Insert(key, value);
+        const double insertNs = nsPerOp(Clock::now() - start, keys);
+
+        ByteVector out;
+        std::size_t found = 0;
+        start = Clock::now();
+        for (const auto& key : probes) found += list.SearchInto(key, out) ? 1 : 0;
+        const double getNs = nsPerOp(Clock::now() - start, lookups);
+
+        const std::size_t removals = keys / 10;
+        start = Clock::now();
+        for (std::size_t i = 0; i < removals; ++i) list.Remove(present[i]);
+        const double removeNs = nsPerOp(Clock::now() - start, removals);
+
+        const FilterStats stats = list.GetFilterStats();
+        std::cout << (filtered ? "filter   " : "no_filter")
+                  << " insert_ns=" << insertNs
+                  << " get_ns=" << getNs
+                  << " remove_ns=" << removeNs
+                  << " negatives=" << stats.Negatives
+                  << " hits=" << stats.Hits
+                  << " false_positives=" << stats.FalsePositives
+                  << " used_bytes=" << list.GetMemoryStats().UsedBytes
+                  << " (found=" << found << ")\n";
+    }
+    return 0;
+}
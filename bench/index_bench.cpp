@@ -0,0 +1,78 @@
+/*
+ * Point operations on a List with and without the hash index: random lookups of present keys,
+ * lookups of absent keys, and updates of existing keys, after inserting every key once.
+ * Usage: threadbytetree_bench_index [keys=1000000] [operations=1000000] [keyBytes=16]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "include/skiplist.h"
+
+using namespace tbt;
+
+static ByteVector random_key(std::mt19937_64& rng, std::size_t size) {
+    ByteVector v(size);
+    for (auto& byte : v) byte = static_cast<uint8_t>(rng());
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t operations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const std::size_t keyBytes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+
+    std::mt19937_64 rng(42);
+    std::vector<ByteVector> present;
+    present.reserve(keys);
+    for (std::size_t i = 0; i < keys; ++i) present.push_back(random_key(rng, keyBytes));
+    std::uniform_int_distribution<std::size_t> pick(0, keys - 1);
+    std::vector<std::size_t> hits(operations);
+    for (auto& index : hits) index = pick(rng);
+    std::vector<ByteVector> absent;
+    absent.reserve(operations);
+    for (std::size_t i = 0; i < operations; ++i) absent.push_back(random_key(rng, keyBytes + 1));
+
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [](Clock::duration elapsed, std::size_t ops) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(ops);
+    };
+    const ByteVector value(8, 0x5A);
+    const ByteVector updated(8, 0xA5);
+
+    for (const bool indexed : {false, true}) {
+        List list(32, 0.25f);
+        if (indexed) list.EnableIndex(keys);
+
+        auto start = Clock::now();
+        for (const auto& key : present) list.Insert(key, value);
+        const double insertNs = nsPerOp(Clock::now() - start, keys);
+
+        ByteVector out;
+        std::size_t found = 0;
+        start = Clock::now();
+        for (const std::size_t index : hits) found += list.SearchInto(present[index], out) ? 1 : 0;
+        const double hitNs = nsPerOp(Clock::now() - start, operations);
+
+        start = Clock::now();
+        for (const auto& key : absent) found += list.SearchInto(key, out) ? 1 : 0;
+        const double missNs = nsPerOp(Clock::now() - start, operations);
+
+        start = Clock::now();
+        for (const std::size_t index : hits) list.Insert(present[index], updated);
+        const double updateNs = nsPerOp(Clock::now() - start, operations);
+
+        std::cout << (indexed ? "index   " : "no_index")
+                  << " keys=" << keys
+                  << " insert_ns=" << insertNs
+                  << " get_hit_ns=" << hitNs
+                  << " get_miss_ns=" << missNs
+                  << " update_ns=" << updateNs
+                  << " used_bytes=" << list.GetMemoryStats().UsedBytes
+                  << " (found=" << found << ")\n";
+    }
+    return 0;
+}
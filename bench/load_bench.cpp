@@ -0,0 +1,74 @@
+/*
+ * Cost of filling a List from sorted input: Insert in a loop versus BulkLoad, and the search
+ * cost on the resulting towers.
+ * Usage: threadbytetree_bench_load [keys=1000000] [keyBytes=16] [threads=4]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "include/skiplist.h"
+
+using namespace tbt;
+
+static ByteVector random_key(std::mt19937_64& rng, std::size_t size) {
+    ByteVector v(size);
+    for (auto& byte : v) byte = static_cast<uint8_t>(rng());
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t keyBytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    const std::size_t threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 4;
+
+    std::mt19937_64 rng(42);
+    std::vector<std::pair<ByteVector, ByteVector>> entries;
+    entries.reserve(keys);
+    for (std::size_t i = 0; i < keys; ++i) entries.emplace_back(random_key(rng, keyBytes), ByteVector(8, 0x5A));
+    std::sort(entries.begin(), entries.end(), [](const auto& left, const auto& right) { return ByteVectorLess(left.first, right.first); });
+
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [](Clock::duration elapsed, std::size_t ops) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(ops);
+    };
+    auto searchNs = [&](const List& list, std::size_t& found) {
+        std::mt19937_64 probe(7);
+        std::uniform_int_distribution<std::size_t> pick(0, keys - 1);
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < keys; ++i) found += list.Search(entries[pick(probe)].first).empty() ? 0 : 1;
+        return nsPerOp(Clock::now() - start, keys);
+    };
+
+    std::size_t found = 0;
+    List inserted(32, 0.5f);
+    auto start = Clock::now();
+    for (const auto& [key, value] : entries) inserted.Insert(key, value);
+    const double insertNs = nsPerOp(Clock::now() - start, keys);
+    const double insertedSearchNs = searchNs(inserted, found);
+
+    List loaded(32, 0.5f);
+    start = Clock::now();
+    loaded.BulkLoad(entries);
+    const double loadNs = nsPerOp(Clock::now() - start, keys);
+    const double loadedSearchNs = searchNs(loaded, found);
+
+    List parallel(32, 0.5f);
+    start = Clock::now();
+    parallel.BulkLoad(entries, threads);
+    const double parallelNs = nsPerOp(Clock::now() - start, keys);
+
+    std::cout << "keys=" << keys << " keyBytes=" << keyBytes
+              << " insert_ns=" << insertNs
+              << " bulk_load_ns=" << loadNs
+              << " bulk_load_" << threads << "t_ns=" << parallelNs
+              << " search_ns_random_towers=" << insertedSearchNs
+              << " search_ns_bulk_towers=" << loadedSearchNs
+              << " (found=" << found << ")\n";
+    return found == 2 * keys ? 0 : 1;
+}
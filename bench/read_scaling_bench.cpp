@@ -0,0 +1,88 @@
+/*
+ * Read scaling: random gets of present keys from 1, 2, 4, ... threads at once, on a ThreadByteTree
+ * (lock-free skip list reads) and on a TieredThreadByteTree whose data sits in runs, while
+ * nothing is written. Reports total and per-thread throughput for every thread count.
+ * Usage: threadbytetree_bench_read_scaling [keys=1000000] [getsPerThread=500000] [maxThreads=hardware] [directory=temp]
+ */
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ThreadByteTree.h"
+#include "TieredThreadByteTree.h"
+
+using namespace tbt;
+
+static ByteVector key_of(std::uint64_t x) {
+    ByteVector key(16);
+    for (int i = 0; i < 8; ++i) key[static_cast<std::size_t>(i)] = static_cast<uint8_t>(x >> (56 - 8 * i));
+    for (int i = 8; i < 16; ++i) key[static_cast<std::size_t>(i)] = static_cast<uint8_t>(x * 0x9E3779B97F4A7C15ull >> (8 * (i - 8)));
+    return key;
+}
+
+// Million gets per second with the given number of threads, each reading its own random keys.
+template <typename Store>
+static double measure(const Store& store, const std::vector<ByteVector>& keys, const std::size_t threads, const std::size_t getsPerThread) {
+    std::barrier start(static_cast<std::ptrdiff_t>(threads + 1));
+    std::atomic<std::size_t> found{0};
+    std::vector<std::jthread> readers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937_64 rng(t + 1);
+            std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+            ByteVector out;
+            std::size_t hits = 0;
+            start.arrive_and_wait();
+            for (std::size_t i = 0; i < getsPerThread; ++i) hits += store.get_into(keys[pick(rng)], out) ? 1 : 0;
+            found.fetch_add(hits);
+        });
+    }
+    start.arrive_and_wait();
+    const auto begin = std::chrono::steady_clock::now();
+    readers.clear();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (found.load() != threads * getsPerThread) std::cerr << "missing keys\n";
+    return static_cast<double>(threads * getsPerThread) / seconds / 1e6;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t getsPerThread = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500000;
+    const std::size_t maxThreads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    const std::filesystem::path base = argc > 4 ? std::filesystem::path(argv[4]) : std::filesystem::temp_directory_path();
+    const std::filesystem::path directory = base / "threadbytetree_bench_read_scaling";
+    std::filesystem::remove_all(directory);
+
+    std::vector<ByteVector> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) keys.push_back(key_of(i));
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    const ByteVector value(100, 0x5A);
+
+    ThreadByteTree memory(24, 0.25f);
+    for (const auto& key : keys) memory.put(key, value);
+    {
+        TieredOptions options;
+        options.MemtableBytes = 16 << 20;
+        TieredThreadByteTree tiered(directory.string(), options);
+        for (const auto& key : keys) tiered.put(key, value);
+        tiered.flush();
+
+        for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            const double memoryRate = measure(memory, keys, threads, getsPerThread);
+            const double tieredRate = measure(tiered, keys, threads, getsPerThread);
+            std::cout << "threads=" << threads
+                      << " memory_mops=" << memoryRate << " (" << memoryRate / static_cast<double>(threads) << "/thread)"
+                      << " tiered_mops=" << tieredRate << " (" << tieredRate / static_cast<double>(threads) << "/thread)\n";
+        }
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
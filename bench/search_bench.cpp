@@ -0,0 +1,64 @@
+/*
+ * Single-threaded List::Insert / List::Search cost at a given list size.
+ * Usage: threadbytetree_bench_search [keys=1000000] [lookups=1000000] [keyBytes=16]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "include/skiplist.h"
+
+using namespace tbt;
+
+static ByteVector random_key(std::mt19937_64& rng, std::size_t size) {
+    ByteVector v(size);
+    for (auto& byte : v) byte = static_cast<uint8_t>(rng());
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const std::size_t keyBytes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+
+    std::mt19937_64 rng(42);
+    std::vector<ByteVector> present;
+    present.reserve(keys);
+    for (std::size_t i = 0; i < keys; ++i) present.push_back(random_key(rng, keyBytes));
+
+    List list(32, 0.5f);
+    const ByteVector value(8, 0x5A);
+
+    using Clock = std::chrono::steady_clock;
+    auto nsPerOp = [](Clock::duration elapsed, std::size_t ops) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(ops);
+    };
+
+    auto start = Clock::now();
+    for (const auto& key : present) list.Insert(key, value);
+    const double insertNs = nsPerOp(Clock::now() - start, keys);
+
+    std::uniform_int_distribution<std::size_t> pick(0, keys - 1);
+    std::size_t found = 0;
+    start = Clock::now();
+    for (std::size_t i = 0; i < lookups; ++i) found += list.Search(present[pick(rng)]).empty() ? 0 : 1;
+    const double hitNs = nsPerOp(Clock::now() - start, lookups);
+
+    std::vector<ByteVector> absent;
+    absent.reserve(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) absent.push_back(random_key(rng, keyBytes + 1));
+    start = Clock::now();
+    for (const auto& key : absent) found += list.Search(key).empty() ? 0 : 1;
+    const double missNs = nsPerOp(Clock::now() - start, lookups);
+
+    std::cout << "keys=" << keys << " keyBytes=" << keyBytes
+              << " insert_ns=" << insertNs
+              << " search_hit_ns=" << hitNs
+              << " search_miss_ns=" << missNs
+              << " used_bytes=" << list.GetMemoryStats().UsedBytes
+              << " (found=" << found << ")\n";
+    return found == lookups ? 0 : 1;
+}
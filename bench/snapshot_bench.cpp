@@ -0,0 +1,74 @@
+/*
+ * Snapshot cost: writing a ThreadByteTree to a snapshot file, opening it with MappedSnapshot and
+ * serving random lookups from the mapping, next to lookups in the tree itself.
+ * Usage: threadbytetree_bench_snapshot [keys=1000000] [keyBytes=16] [valueBytes=100] [directory=temp]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ThreadByteTree.h"
+
+using namespace tbt;
+
+static ByteVector random_key(std::mt19937_64& rng, std::size_t size) {
+    ByteVector v(size);
+    for (auto& byte : v) byte = static_cast<uint8_t>(rng());
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t keyBytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    const std::size_t valueBytes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100;
+    const std::filesystem::path directory = argc > 4 ? std::filesystem::path(argv[4]) : std::filesystem::temp_directory_path();
+    const std::string path = (directory / "threadbytetree_bench.snap").string();
+
+    std::mt19937_64 rng(42);
+    std::vector<ByteVector> present;
+    present.reserve(keys);
+    ThreadByteTree tbtree(32, 0.5f);
+    const ByteVector value(valueBytes, 0x5A);
+    for (std::size_t i = 0; i < keys; ++i) {
+        present.push_back(random_key(rng, keyBytes));
+        tbtree.put(present.back(), value);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto micros = [](Clock::duration elapsed) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    };
+
+    auto start = Clock::now();
+    const std::uint64_t written = tbtree.snapshot(path);
+    const double writeUs = micros(Clock::now() - start);
+
+    start = Clock::now();
+    MappedSnapshot snapshot(path);
+    const double openUs = micros(Clock::now() - start);
+
+    std::uniform_int_distribution<std::size_t> pick(0, keys - 1);
+    std::size_t found = 0;
+    start = Clock::now();
+    for (std::size_t i = 0; i < keys; ++i) found += snapshot.Get(present[pick(rng)]) ? 1 : 0;
+    const double snapshotGetNs = micros(Clock::now() - start) * 1000.0 / static_cast<double>(keys);
+
+    ByteVector out;
+    start = Clock::now();
+    for (std::size_t i = 0; i < keys; ++i) found += tbtree.get_into(present[pick(rng)], out) ? 1 : 0;
+    const double treeGetNs = micros(Clock::now() - start) * 1000.0 / static_cast<double>(keys);
+
+    std::cout << "keys=" << written << " file_bytes=" << std::filesystem::file_size(path)
+              << " blocks=" << snapshot.BlockCount()
+              << " write_ms=" << writeUs / 1000.0
+              << " open_us=" << openUs
+              << " snapshot_get_ns=" << snapshotGetNs
+              << " tree_get_ns=" << treeGetNs
+              << " (found=" << found << ")\n";
+    std::filesystem::remove(path);
+    return found == 2 * keys ? 0 : 1;
+}
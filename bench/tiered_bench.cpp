@@ -0,0 +1,94 @@
+/*
+ * TieredThreadByteTree cost: put throughput while memtables are flushed and runs compacted in the
+ * background, then random lookups of present keys and of absent keys (which the run filters
+ * answer), next to the same lookups in a ThreadByteTree holding everything in memory.
+ * Usage: threadbytetree_bench_tiered [keys=1000000] [valueBytes=100] [memtableMiB=16] [directory=temp]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ThreadByteTree.h"
+#include "TieredThreadByteTree.h"
+
+using namespace tbt;
+
+static ByteVector key_of(std::uint64_t x) {
+    ByteVector key(16);
+    for (int i = 0; i < 8; ++i) key[static_cast<std::size_t>(i)] = static_cast<uint8_t>(x >> (56 - 8 * i));
+    for (int i = 8; i < 16; ++i) key[static_cast<std::size_t>(i)] = static_cast<uint8_t>(x * 0x9E3779B97F4A7C15ull >> (8 * (i - 8)));
+    return key;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t valueBytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    const std::size_t memtableMiB = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+    const std::filesystem::path base = argc > 4 ? std::filesystem::path(argv[4]) : std::filesystem::temp_directory_path();
+    const std::filesystem::path directory = base / "threadbytetree_bench_tiered";
+    std::filesystem::remove_all(directory);
+
+    using Clock = std::chrono::steady_clock;
+    auto nanosPer = [](Clock::duration elapsed, std::size_t count) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(count);
+    };
+
+    // Keys are inserted in a random order; odd numbers are never inserted and serve as misses.
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> order(keys);
+    for (std::size_t i = 0; i < keys; ++i) order[i] = 2 * i;
+    std::shuffle(order.begin(), order.end(), rng);
+    const ByteVector value(valueBytes, 0x5A);
+
+    TieredOptions options;
+    options.MemtableBytes = memtableMiB << 20;
+    {
+        TieredThreadByteTree tiered(directory.string(), options);
+        ThreadByteTree memory(24, 0.25f);
+
+        auto start = Clock::now();
+        for (const std::uint64_t x : order) tiered.put(key_of(x), value);
+        tiered.flush();
+        const double tieredPutNs = nanosPer(Clock::now() - start, keys);
+
+        start = Clock::now();
+        for (const std::uint64_t x : order) memory.put(key_of(x), value);
+        const double memoryPutNs = nanosPer(Clock::now() - start, keys);
+
+        std::uniform_int_distribution<std::uint64_t> pick(0, keys - 1);
+        std::vector<ByteVector> hits;
+        std::vector<ByteVector> misses;
+        for (std::size_t i = 0; i < keys; ++i) {
+            hits.push_back(key_of(2 * pick(rng)));
+            misses.push_back(key_of(2 * pick(rng) + 1));
+        }
+
+        ByteVector out;
+        std::size_t found = 0;
+        auto timeGets = [&](const auto& store, const std::vector<ByteVector>& probes) {
+            const auto begin = Clock::now();
+            for (const ByteVector& key : probes) found += store.get_into(key, out) ? 1 : 0;
+            return nanosPer(Clock::now() - begin, probes.size());
+        };
+        const double tieredHitNs = timeGets(tiered, hits);
+        const double tieredMissNs = timeGets(tiered, misses);
+        const double memoryHitNs = timeGets(memory, hits);
+        const double memoryMissNs = timeGets(memory, misses);
+
+        const TieredStats stats = tiered.stats();
+        std::cout << "keys=" << keys << " runs=" << stats.Runs << " run_bytes=" << stats.RunBytes
+                  << " flushes=" << stats.Flushes << " compactions=" << stats.Compactions << " stalls=" << stats.Stalls << "\n"
+                  << "put_ns tiered=" << tieredPutNs << " memory=" << memoryPutNs << "\n"
+                  << "get_hit_ns tiered=" << tieredHitNs << " memory=" << memoryHitNs << "\n"
+                  << "get_miss_ns tiered=" << tieredMissNs << " memory=" << memoryMissNs << "\n"
+                  << "filter_skips=" << stats.FilterSkips << " filter_false_positives=" << stats.FilterFalsePositives
+                  << " (found=" << found << ")\n";
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
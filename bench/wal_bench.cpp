@@ -0,0 +1,66 @@
+/*
+ * ThreadByteTree::put throughput with a write-ahead log under each sync policy, with concurrent
+ * writers, plus the number of write groups and syncs they produced.
+ * Usage: threadbytetree_bench_wal [directory=temp] [threads=8] [putsPerThread=2000] [valueBytes=100]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ThreadByteTree.h"
+
+using namespace tbt;
+
+int main(int argc, char** argv) {
+    const std::filesystem::path directory = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path();
+    const std::size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+    const std::size_t perThread = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000;
+    const std::size_t valueBytes = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 100;
+
+    const struct {
+        const char* name;
+        WalOptions options;
+    } policies[] = {
+        {"every_op", {SyncPolicy::EveryOperation}},
+        {"interval_10ms", {SyncPolicy::Interval, std::chrono::milliseconds(10)}},
+        {"none", {SyncPolicy::None}},
+    };
+
+    using Clock = std::chrono::steady_clock;
+    const ByteVector value(valueBytes, 0x5A);
+    for (const auto& policy : policies) {
+        const std::string path = (directory / ("threadbytetree_bench_" + std::string(policy.name) + ".log")).string();
+        std::filesystem::remove(path);
+
+        ThreadByteTree tbtree(24, 0.5f);
+        tbtree.open_log(path, policy.options);
+        const auto start = Clock::now();
+        std::vector<std::thread> writers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            writers.emplace_back([&, t]() {
+                for (std::size_t i = 0; i < perThread; ++i) {
+                    const std::string key = std::to_string(t) + ":" + std::to_string(i);
+                    tbtree.put(AsBytes(key), value);
+                }
+            });
+        }
+        for (auto& writer : writers) writer.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        const WalStats stats = tbtree.logStats();
+        std::cout << "policy=" << policy.name << " threads=" << threads
+                  << " puts_per_s=" << static_cast<double>(threads * perThread) / seconds
+                  << " records=" << stats.Records
+                  << " writes=" << stats.Writes
+                  << " syncs=" << stats.Syncs
+                  << " records_per_write=" << (stats.Writes == 0 ? 0.0 : static_cast<double>(stats.Records) / static_cast<double>(stats.Writes))
+                  << "\n";
+        std::filesystem::remove(path);
+    }
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * YCSB-style suite: workloads A-F (read/update/insert/scan/read-modify-write mixes over uniform,
+ * zipfian and latest key choices) run against one ThreadByteTree from 1, 2, 4, ... threads, with
+ * throughput and p50/p99/p999 latency per run. A micro section measures the building blocks:
+ * ByteVectorLess, List::Insert and List::Search. Output is text, or one JSON document with "json".
+ * Usage: threadbytetree_bench [workloads=ABCDEF] [records=1000000] [opsPerThread=100000] [maxThreads=hardware]
+ *                             [keyBytes=16] [valueBytes=100] [format=text|json] [mode=locked|lockfree|combining]
+ *                             [keys=workload|uniform|zipfian|latest]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ThreadByteTree.h"
+
+using namespace tbt;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Distribution {
+        Uniform,
+        Zipfian,
+        Latest
+    };
+
+    // Operation mix of a workload, in percent; the rest of 100 are reads.
+    struct Workload {
+        char Name;
+        int Update;
+        int Insert;
+        int Scan;
+        int ReadModifyWrite;
+        Distribution Keys;
+    };
+
+    // The core YCSB workloads. E scans up to 100 entries from its start key.
+    constexpr Workload Workloads[] = {
+        {'A', 50, 0, 0, 0, Distribution::Zipfian},  // update heavy
+        {'B', 5, 0, 0, 0, Distribution::Zipfian},   // read mostly
+        {'C', 0, 0, 0, 0, Distribution::Zipfian},   // read only
+        {'D', 0, 5, 0, 0, Distribution::Latest},    // read latest
+        {'E', 0, 5, 95, 0, Distribution::Zipfian},  // short ranges
+        {'F', 0, 0, 0, 50, Distribution::Zipfian},  // read-modify-write
+    };
+    constexpr std::size_t MaxScan = 100;
+
+    std::uint64_t scramble(std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ull;
+        return x ^ (x >> 33);
+    }
+
+    // Record id to key: a scrambled 8-byte big-endian prefix, so consecutive inserts land all over
+    // the list as YCSB's hashed keys do, padded with id-derived bytes up to keyBytes.
+    ByteVector key_of(const std::uint64_t id, const std::size_t keyBytes) {
+        ByteVector key(std::max<std::size_t>(keyBytes, 8));
+        const std::uint64_t hashed = scramble(id);
+        for (std::size_t i = 0; i < 8; ++i) key[i] = static_cast<uint8_t>(hashed >> (56 - 8 * i));
+        for (std::size_t i = 8; i < key.size(); ++i) key[i] = static_cast<uint8_t>(id >> (8 * (i % 8)));
+        return key;
+    }
+
+    // Gray et al. "Quickly generating billion-record synthetic databases", as in YCSB's
+    // ZipfianGenerator with theta 0.99: item 0 is the most popular.
+    class Zipfian {
+        private:
+            double items;
+            double theta;
+            double zetan;
+            double alpha;
+            double eta;
+
+            static double zeta(const std::uint64_t n, const double theta) {
+                double sum = 0;
+                for (std::uint64_t i = 1; i <= n; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+                return sum;
+            }
+
+        public:
+            explicit Zipfian(const std::uint64_t n, const double theta = 0.99)
+                : items(static_cast<double>(n)), theta(theta), zetan(zeta(n, theta)), alpha(1.0 / (1.0 - theta)) {
+                eta = (1.0 - std::pow(2.0 / items, 1.0 - theta)) / (1.0 - zeta(2, theta) / zetan);
+            }
+
+            std::uint64_t Next(std::mt19937_64& rng) const {
+                const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                const double uz = u * zetan;
+                if (uz < 1.0) return 0;
+                if (uz < 1.0 + std::pow(0.5, theta)) return 1;
+                return static_cast<std::uint64_t>(items * std::pow(eta * u - eta + 1.0, alpha));
+            }
+    };
+
+    struct Result {
+        char Workload;
+        std::size_t Threads;
+        std::size_t Ops;
+        double OpsPerSecond;
+        std::uint64_t P50;
+        std::uint64_t P99;
+        std::uint64_t P999;
+    };
+
+    std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, const double fraction) {
+        if (sorted.empty()) return 0;
+        return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(sorted.size())))];
+    }
+
+    double nanosPer(const Clock::duration elapsed, const std::size_t count) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(count);
+    }
+
+    std::optional<Distribution> distribution_of(const std::string& name) {
+        if (name == "uniform") return Distribution::Uniform;
+        if (name == "zipfian") return Distribution::Zipfian;
+        if (name == "latest") return Distribution::Latest;
+        return std::nullopt;
+    }
+
+    Concurrency mode_of(const std::string& name) {
+        if (name == "lockfree") return Concurrency::LockFree;
+        if (name == "combining") return Concurrency::Combining;
+        return Concurrency::Locked;
+    }
+
+    // Runs one workload from the given number of threads; every operation is timed on its own.
+    Result run(ThreadByteTree& tree, const Workload& workload, const Zipfian& zipfian, std::atomic<std::uint64_t>& inserted,
+               const std::size_t threads, const std::size_t opsPerThread, const std::size_t keyBytes, const ByteVector& value) {
+        const std::uint64_t records = inserted.load();
+        std::vector<std::vector<std::uint64_t>> latencies(threads);
+        std::barrier start(static_cast<std::ptrdiff_t>(threads + 1));
+        std::vector<std::jthread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                std::mt19937_64 rng(t * 7919 + static_cast<std::uint64_t>(workload.Name));
+                std::uniform_int_distribution<int> percent(0, 99);
+                std::uniform_int_distribution<std::size_t> scanLength(1, MaxScan);
+                auto pick = [&]() -> std::uint64_t {
+                    switch (workload.Keys) {
+                        case Distribution::Uniform: return std::uniform_int_distribution<std::uint64_t>(0, records - 1)(rng);
+                        case Distribution::Latest: {
+                            // Recent inserts are the hottest; the skew is that of the initial record count.
+                            const std::uint64_t newest = inserted.load(std::memory_order_relaxed) - 1;
+                            return newest - std::min(newest, zipfian.Next(rng));
+                        }
+                        default: return scramble(zipfian.Next(rng)) % records;
+                    }
+                };
+
+                std::vector<std::uint64_t>& samples = latencies[t];
+                samples.reserve(opsPerThread);
+                ByteVector out;
+                start.arrive_and_wait();
+                for (std::size_t i = 0; i < opsPerThread; ++i) {
+                    const int roll = percent(rng);
+                    const auto begin = Clock::now();
+                    if (roll < workload.Update) {
+                        tree.put(key_of(pick(), keyBytes), value);
+                    } else if (roll < workload.Update + workload.Insert) {
+                        tree.put(key_of(inserted.fetch_add(1, std::memory_order_relaxed), keyBytes), value);
+                    } else if (roll < workload.Update + workload.Insert + workload.Scan) {
+                        tree.scan(key_of(pick(), keyBytes), {}, scanLength(rng));
+                    } else if (roll < workload.Update + workload.Insert + workload.Scan + workload.ReadModifyWrite) {
+                        const ByteVector key = key_of(pick(), keyBytes);
+                        tree.get_into(key, out);
+                        out.resize(value.size());
+                        out[0] = static_cast<uint8_t>(out[0] + 1);
+                        tree.put(key, out);
+                    } else {
+                        tree.get_into(key_of(pick(), keyBytes), out);
+                    }
+                    samples.push_back(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+                }
+            });
+        }
+        start.arrive_and_wait();
+        const auto begin = Clock::now();
+        workers.clear();
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        std::vector<std::uint64_t> all;
+        all.reserve(threads * opsPerThread);
+        for (const auto& samples : latencies) all.insert(all.end(), samples.begin(), samples.end());
+        std::sort(all.begin(), all.end());
+        return {workload.Name, threads, all.size(), static_cast<double>(all.size()) / seconds,
+                percentile(all, 0.50), percentile(all, 0.99), percentile(all, 0.999)};
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string names = argc > 1 ? argv[1] : "ABCDEF";
+    const std::size_t records = std::max<std::size_t>(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000, 2);
+    const std::size_t opsPerThread = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100000;
+    const std::size_t maxThreads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t keyBytes = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 16;
+    const std::size_t valueBytes = std::max<std::size_t>(argc > 6 ? std::strtoull(argv[6], nullptr, 10) : 100, 1);
+    const bool json = argc > 7 && std::string(argv[7]) == "json";
+    const std::string modeName = argc > 8 ? argv[8] : "locked";
+    // Overrides the key distribution of every workload, e.g. to compare A under uniform keys.
+    const std::optional<Distribution> keysOverride = distribution_of(argc > 9 ? argv[9] : "workload");
+    const ByteVector value(valueBytes, 0x5A);
+
+    // Micro: the comparator on random keys, then single-threaded inserts and hits in a List.
+    std::vector<ByteVector> keys;
+    keys.reserve(records);
+    for (std::uint64_t i = 0; i < records; ++i) keys.push_back(key_of(i, keyBytes));
+    std::size_t less = 0;
+    auto begin = Clock::now();
+    for (std::size_t i = 0; i + 1 < keys.size(); ++i) less += ByteVectorLess(keys[i], keys[i + 1]) ? 1 : 0;
+    const double lessNs = nanosPer(Clock::now() - begin, keys.size() - 1);
+
+    double insertNs = 0;
+    double searchNs = 0;
+    std::size_t found = 0;
+    {
+        List list(24, 0.25f, mode_of(modeName));
+        begin = Clock::now();
+        for (const ByteVector& key : keys) list.Insert(key, value);
+        insertNs = nanosPer(Clock::now() - begin, keys.size());
+
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+        ByteVector out;
+        begin = Clock::now();
+        for (std::size_t i = 0; i < keys.size(); ++i) found += list.SearchInto(keys[pick(rng)], out) ? 1 : 0;
+        searchNs = nanosPer(Clock::now() - begin, keys.size());
+    }
+
+    // Workloads: each one loads a fresh store, then runs from 1, 2, 4, ... threads in turn, ending
+    // with maxThreads itself when it is not a power of two.
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    if (maxThreads > 0) threadCounts.push_back(maxThreads);
+    const Zipfian zipfian(records);
+    std::vector<Result> results;
+    std::vector<std::pair<char, double>> loadNs;
+    for (Workload workload : Workloads) {
+        if (names.find(workload.Name) == std::string::npos) continue;
+        workload.Keys = keysOverride.value_or(workload.Keys);
+        ThreadByteTree tree(24, 0.25f, mode_of(modeName));
+        begin = Clock::now();
+        for (const ByteVector& key : keys) tree.put(key, value);
+        loadNs.emplace_back(workload.Name, nanosPer(Clock::now() - begin, keys.size()));
+        std::atomic<std::uint64_t> inserted{records};
+        for (const std::size_t threads : threadCounts) {
+            results.push_back(run(tree, workload, zipfian, inserted, threads, opsPerThread, keyBytes, value));
+        }
+    }
+
+    if (json) {
+        std::cout << "{\"records\":" << records << ",\"opsPerThread\":" << opsPerThread << ",\"keyBytes\":" << keyBytes
+                  << ",\"valueBytes\":" << valueBytes << ",\"mode\":\"" << modeName << "\""
+                  << ",\"micro\":{\"less_ns\":" << lessNs << ",\"insert_ns\":" << insertNs << ",\"search_ns\":" << searchNs << "}"
+                  << ",\"load_ns\":{";
+        for (std::size_t i = 0; i < loadNs.size(); ++i) {
+            std::cout << (i == 0 ? "" : ",") << "\"" << loadNs[i].first << "\":" << loadNs[i].second;
+        }
+        std::cout << "},\"results\":[";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::cout << (i == 0 ? "" : ",") << "{\"workload\":\"" << r.Workload << "\",\"threads\":" << r.Threads
+                      << ",\"ops\":" << r.Ops << ",\"ops_per_sec\":" << r.OpsPerSecond
+                      << ",\"p50_ns\":" << r.P50 << ",\"p99_ns\":" << r.P99 << ",\"p999_ns\":" << r.P999 << "}";
+        }
+        std::cout << "]}\n";
+    } else {
+        std::cout << "records=" << records << " keyBytes=" << keyBytes << " valueBytes=" << valueBytes << " mode=" << modeName << "\n"
+                  << "micro less_ns=" << lessNs << " insert_ns=" << insertNs << " search_ns=" << searchNs << "\n";
+        for (const auto& [name, ns] : loadNs) std::cout << "workload=" << name << " load_ns=" << ns << "\n";
+        for (const Result& r : results) {
+            std::cout << "workload=" << r.Workload << " threads=" << r.Threads << " ops_per_sec=" << r.OpsPerSecond
+                      << " p50_ns=" << r.P50 << " p99_ns=" << r.P99 << " p999_ns=" << r.P999 << "\n";
+        }
+    }
+    return found == keys.size() && less < keys.size() ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 22.10.2025
+ * @description: Slab arena used by the skip list for nodes and value buffers. Small blocks
+ * are bump-allocated from per-thread chunks and recycled through size-class free lists;
+ * everything is released at once when the owning list is cleared.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace tbt {
+
+    /*
+     * Memory accounting of an Arena, in bytes.
+     *   - ReservedBytes: memory obtained from the system (chunks plus large blocks).
+     *   - UsedBytes: live blocks, rounded up to their size class.
+     *   - FreeListBytes: recycled blocks waiting in free lists for reuse.
+     *   - LargeBytes: live blocks too big for a size class, allocated individually.
+     *   - Chunks: number of slab chunks.
+     */
+    struct ArenaStats {
+        std::size_t ReservedBytes;
+        std::size_t UsedBytes;
+        std::size_t FreeListBytes;
+        std::size_t LargeBytes;
+        std::size_t Chunks;
+    };
+
+    class Arena {
+        public:
+            /*
+             * Size of a slab chunk; blocks larger than MaxSmallSize bypass the slabs.
+             */
+            static constexpr std::size_t ChunkSize = 256 * 1024;
+            static constexpr std::size_t MaxSmallSize = 32 * 1024;
+            static constexpr std::size_t Alignment = 16;
+
+        private:
+            static constexpr std::size_t ShardCount = 16;
+            static constexpr std::size_t ClassCount = 23; // 16..256 by 16, then 512..32768 by powers of two
+
+            struct FreeBlock {
+                FreeBlock* next;
+            };
+
+            struct LargeBlock {
+                LargeBlock* prev;
+                LargeBlock* next;
+                std::size_t size;
+            };
+
+            // One shard per thread (by thread index modulo ShardCount). Counters are only
+            // written under the shard latch and read with relaxed loads by Stats.
+            struct alignas(64) Shard {
+                std::atomic_flag latch;
+                char* cursor = nullptr;
+                char* end = nullptr;
+                FreeBlock* freeLists[ClassCount] = {};
+                std::atomic<std::size_t> usedBytes{0};
+                std::atomic<std::size_t> freeListBytes{0};
+            };
+
+            Shard shards[ShardCount];
+            mutable std::mutex chunkMux;
+            std::vector<char*> chunks;
+            LargeBlock* largeBlocks = nullptr;
+            std::size_t largeBytes = 0;
+
+            Shard& localShard();
+            char* newChunk();
+            static std::size_t classOf(std::size_t size);
+            static std::size_t classSize(std::size_t sizeClass);
+
+        public:
+            Arena() = default;
+
+            /*
+             * Release all memory owned by the arena.
+             */
+            ~Arena();
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            /*
+             * Allocate a block of at least size bytes, aligned to Alignment.
+             * Parameters:
+             *   - size: requested size in bytes (>0).
+             * Returns:
+             *   - Pointer to uninitialized storage.
+             * Throws:
+             *   - std::bad_alloc if the system allocator fails.
+             * Thread-safety:
+             *   - Safe for concurrent calls; threads normally hit distinct shards.
+             */
+            void* Allocate(std::size_t size);
+
+            /*
+             * Return a block to the arena for reuse.
+             * Parameters:
+             *   - block: pointer obtained from Allocate on this arena.
+             *   - size: the size passed to Allocate.
+             * Thread-safety:
+             *   - Safe for concurrent calls. The caller guarantees no other thread still reads the
+             *     block (e.g. by freeing it from an epoch deleter).
+             */
+            void Free(void* block, std::size_t size);
+
+            /*
+             * Free every chunk and large block at once, invalidating all outstanding blocks.
+             * Thread-safety:
+             *   - Must be invoked when no other thread uses the arena.
+             */
+            void Release();
+
+            /*
+             * Current memory accounting.
+             * Thread-safety:
+             *   - Safe to call concurrently with allocations; fields are read individually.
+             */
+            ArenaStats Stats() const;
+    };
+}
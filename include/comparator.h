@@ -2,12 +2,19 @@
  * @author: Viktor Shishmarev
  * @date: 12.10.2025
  * @description: Comparator utilities for byte-vector based keys and values.
- * Provides lexicographic comparison on unsigned bytes and equality check.
+ * Provides lexicographic comparison on unsigned bytes and equality check, and the key order
+ * policies the skip list is parameterized with.
  */
 
 #pragma once
 
+#include <array>
+#include <bit>
+#include <concepts>
 #include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
 #include <vector>
 
 namespace tbt{
@@ -15,7 +22,20 @@ namespace tbt{
     using ByteVector = std::vector<uint8_t>;
 
     /*
-     * Compare two byte vectors lexicographically using unsigned byte semantics.
+     * Non-owning view of a byte sequence. A ByteVector converts to it implicitly, which lets
+     * keys stored inline in skip list nodes be compared without materializing a vector.
+     */
+    using ByteView = std::span<const uint8_t>;
+
+    /*
+     * View the characters of a string as key or value bytes, without copying.
+     */
+    inline ByteView AsBytes(const std::string_view text) noexcept {
+        return {reinterpret_cast<const uint8_t*>(text.data()), text.size()};
+    }
+
+    /*
+     * Compare two byte sequences lexicographically using unsigned byte semantics.
      * Parameters:
      *   - leftHand: first operand
      *   - rightHand: second operand
@@ -25,15 +45,199 @@ namespace tbt{
      *   - Empty arrays: an empty array is less than any non-empty array; two empty arrays are not less than each other.
      *   - Unsigned semantics: bytes ≥ 128 compare greater than any smaller unsigned value.
      */
-    bool ByteVectorLess(const ByteVector& leftHand, const ByteVector& rightHand) noexcept;
+    bool ByteVectorLess(ByteView leftHand, ByteView rightHand) noexcept;
 
     /*
-     * Check equality of two byte vectors.
+     * Check equality of two byte sequences.
      * Parameters:
      *   - leftHand: first operand
      *   - rightHand: second operand
      * Returns:
-     *   - true if vectors have the same size and identical elements; false otherwise.
+     *   - true if both sequences have the same size and identical elements; false otherwise.
+     */
+    bool ByteVectorEqual(ByteView leftHand, ByteView rightHand) noexcept;
+
+    /*
+     * Pack the first eight bytes of a sequence into a big-endian integer, padding with zeros.
+     * Parameters:
+     *   - bytes: sequence to summarize.
+     * Returns:
+     *   - Prefix value such that ByteVectorPrefix(a) < ByteVectorPrefix(b) implies ByteVectorLess(a, b).
+     * Edge cases:
+     *   - Equal prefixes say nothing about the order: "ab" and "ab\0" share a prefix, so callers
+     *     must fall back to a full comparison.
+     */
+    std::uint64_t ByteVectorPrefix(ByteView bytes) noexcept;
+
+    /*
+     * Key order policy of a skip list: a stateless type whose static members are called directly
+     * (and usually inlined) by the list, so a custom order costs no indirect call.
+     *   - Less(a, b): strict weak order on keys.
+     *   - Equal(a, b): true when neither key is Less than the other.
+     */
+    template <typename Order>
+    concept KeyOrder = requires(ByteView key) {
+        { Order::Less(key, key) } -> std::convertible_to<bool>;
+        { Order::Equal(key, key) } -> std::convertible_to<bool>;
+    };
+
+    /*
+     * Key order that also maps a key to a 64-bit summary with Prefix(a) < Prefix(b) implying
+     * Less(a, b). Nodes cache the summary and a descent compares it before touching key bytes.
+     */
+    template <typename Order>
+    concept PrefixedKeyOrder = KeyOrder<Order> && requires(ByteView key) {
+        { Order::Prefix(key) } -> std::same_as<std::uint64_t>;
+    };
+
+    /*
+     * Default order: lexicographic on unsigned bytes.
+     */
+    struct ByteOrder {
+        static bool Less(const ByteView leftHand, const ByteView rightHand) noexcept {
+            return ByteVectorLess(leftHand, rightHand);
+        }
+
+        static bool Equal(const ByteView leftHand, const ByteView rightHand) noexcept {
+            return ByteVectorEqual(leftHand, rightHand);
+        }
+
+        static std::uint64_t Prefix(const ByteView key) noexcept {
+            return ByteVectorPrefix(key);
+        }
+    };
+
+    /*
+     * Descending lexicographic order.
+     */
+    struct ReverseByteOrder {
+        static bool Less(const ByteView leftHand, const ByteView rightHand) noexcept {
+            return ByteVectorLess(rightHand, leftHand);
+        }
+
+        static bool Equal(const ByteView leftHand, const ByteView rightHand) noexcept {
+            return ByteVectorEqual(leftHand, rightHand);
+        }
+
+        static std::uint64_t Prefix(const ByteView key) noexcept {
+            return ~ByteVectorPrefix(key);
+        }
+    };
+
+    /*
+     * Numeric order of keys holding one Integer in host byte order (e.g. memcpy of a uint64_t).
+     * Keys of any other length sort before or after by length, so the order stays total, but
+     * they are not meant to be mixed with well-formed keys.
+     */
+    template <std::integral Integer>
+    struct IntegerOrder {
+        static bool Less(const ByteView leftHand, const ByteView rightHand) noexcept {
+            if (leftHand.size() != sizeof(Integer) || rightHand.size() != sizeof(Integer)) {
+                return leftHand.size() < rightHand.size() || (leftHand.size() == rightHand.size() && ByteVectorLess(leftHand, rightHand));
+            }
+            Integer left;
+            Integer right;
+            std::memcpy(&left, leftHand.data(), sizeof(Integer));
+            std::memcpy(&right, rightHand.data(), sizeof(Integer));
+            return left < right;
+        }
+
+        static bool Equal(const ByteView leftHand, const ByteView rightHand) noexcept {
+            return ByteVectorEqual(leftHand, rightHand);
+        }
+    };
+
+    namespace detail {
+        // Big-endian word of the first size (at most eight) bytes, zero-padded on the right, so
+        // two such words compare like the bytes do. With a constant size the copy is one load.
+        inline std::uint64_t bigEndianWord(const std::uint8_t* bytes, const std::size_t size) noexcept {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes, size);
+            if constexpr (std::endian::native == std::endian::little) {
+                return std::byteswap(word);
+            }
+            return word;
+        }
+
+        // Lexicographic less of two Size-byte arrays, one word at a time; the recursion unrolls
+        // at compile time.
+        template <std::size_t Size>
+        bool fixedLess(const std::uint8_t* leftHand, const std::uint8_t* rightHand) noexcept {
+            constexpr std::size_t width = Size < 8 ? Size : 8;
+            const std::uint64_t left = bigEndianWord(leftHand, width);
+            const std::uint64_t right = bigEndianWord(rightHand, width);
+            if constexpr (Size > 8) {
+                if (left != right) {
+                    return left < right;
+                }
+                return fixedLess<Size - 8>(leftHand + 8, rightHand + 8);
+            } else {
+                return left < right;
+            }
+        }
+    }
+
+    /*
+     * Byte order specialized for keys of exactly Size bytes, such as big-endian encoded integers
+     * or fixed-width ids. Such keys are compared as big-endian words of compile-time length: no
+     * length checks past the first, no byte loop and no call into memcmp. The first word doubles
+     * as the cached node prefix, so keys of up to 8 bytes are ordered by the prefix alone.
+     * Notes:
+     *   - The order is ByteOrder's: keys of other lengths are still accepted and ordered
+     *     lexicographically, only without the fast path. A list can switch between the two without
+     *     reordering anything.
+     *   - Encode/Decode convert an unsigned integer of Size bytes to and from its big-endian key,
+     *     so numeric order and key order agree.
      */
-    bool ByteVectorEqual(const ByteVector& leftHand, const ByteVector& rightHand) noexcept;
-}
\ No newline at end of file
+    template <std::size_t Size>
+    struct FixedKey {
+        static_assert(Size > 0, "a fixed key holds at least one byte");
+
+        static constexpr std::size_t KeySize = Size;
+
+        /*
+         * Key bytes held by value; converts to ByteView, so it is passed to the list as is.
+         */
+        using Bytes = std::array<std::uint8_t, Size>;
+
+        static bool Less(const ByteView leftHand, const ByteView rightHand) noexcept {
+            if (leftHand.size() != Size || rightHand.size() != Size) [[unlikely]] {
+                return ByteVectorLess(leftHand, rightHand);
+            }
+            return detail::fixedLess<Size>(leftHand.data(), rightHand.data());
+        }
+
+        static bool Equal(const ByteView leftHand, const ByteView rightHand) noexcept {
+            if (leftHand.size() != Size || rightHand.size() != Size) [[unlikely]] {
+                return ByteVectorEqual(leftHand, rightHand);
+            }
+            return std::memcmp(leftHand.data(), rightHand.data(), Size) == 0;
+        }
+
+        static std::uint64_t Prefix(const ByteView key) noexcept {
+            if (key.size() != Size) [[unlikely]] {
+                return ByteVectorPrefix(key);
+            }
+            return detail::bigEndianWord(key.data(), Size < 8 ? Size : 8);
+        }
+
+        template <std::unsigned_integral Integer> requires (sizeof(Integer) == Size)
+        static Bytes Encode(Integer value) noexcept {
+            Bytes bytes;
+            for (std::size_t i = Size; i-- > 0;) {
+                bytes[i] = static_cast<std::uint8_t>(value);
+                value = static_cast<Integer>(value >> 8);
+            }
+            return bytes;
+        }
+
+        template <std::unsigned_integral Integer> requires (sizeof(Integer) == Size)
+        static Integer Decode(const ByteView key) noexcept {
+            Integer value = 0;
+            for (std::size_t i = 0; i < Size && i < key.size(); i++) {
+                value = static_cast<Integer>((value << 8) | key[i]);
+            }
+            return value;
+        }
+    };
+}
@@ -0,0 +1,154 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 18.10.2025
+ * @description: Epoch-based memory reclamation. Readers pin the current epoch while they
+ * hold raw pointers into a shared structure; writers retire unlinked objects, which are
+ * freed only once every thread that could still observe them has left its epoch.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace tbt {
+
+    class EpochManager {
+        public:
+            /*
+             * Function used to free a retired object.
+             * Parameters:
+             *   - object: pointer passed to Retire.
+             *   - context: opaque pointer passed to Retire alongside the object.
+             */
+            using Deleter = void (*)(void* object, void* context);
+
+        private:
+            struct Retired {
+                void* object;
+                Deleter deleter;
+                void* context;
+                std::uint64_t epoch;
+            };
+
+            struct alignas(64) Participant {
+                std::atomic<std::uint64_t> state{0}; // (epoch << 1) | active
+                std::atomic<bool> claimed{true};
+                std::size_t depth = 0;
+                std::vector<Retired> limbo;
+                Participant* next = nullptr;
+            };
+
+            struct ThreadCache;
+
+            std::atomic<std::uint64_t> globalEpoch{1};
+            std::atomic<Participant*> participants{nullptr};
+            std::mutex orphanMux;
+            std::vector<Retired> orphans;
+            std::uint64_t id;
+
+            Participant* local();
+            Participant* acquire();
+            void release(Participant* participant);
+            bool tryAdvance();
+            void reclaim(std::vector<Retired>& retired, std::uint64_t safeEpoch);
+
+        public:
+            /*
+             * Number of objects a thread may retire before it attempts a collection on unpin.
+             */
+            static constexpr std::size_t CollectThreshold = 64;
+
+            /*
+             * Construct an empty reclamation domain.
+             * Effects:
+             *   - Registers the domain so that exiting threads can hand over their pending objects.
+             */
+            EpochManager();
+
+            /*
+             * Destroy the domain and free every object still waiting for reclamation.
+             * Thread-safety:
+             *   - Must be invoked when no thread is pinned in this domain.
+             */
+            ~EpochManager();
+
+            EpochManager(const EpochManager&) = delete;
+            EpochManager& operator=(const EpochManager&) = delete;
+
+            /*
+             * Pin the calling thread to the current epoch.
+             * Effects:
+             *   - Objects retired from now on are not freed until the matching Exit.
+             * Notes:
+             *   - Reentrant: nested Enter/Exit pairs only pin once.
+             */
+            void Enter();
+
+            /*
+             * Unpin the calling thread.
+             * Effects:
+             *   - When the outermost pin is released and enough objects are pending, runs Collect.
+             */
+            void Exit();
+
+            /*
+             * Hand an unlinked object over for deferred destruction.
+             * Parameters:
+             *   - object: object that is no longer reachable from the shared structure.
+             *   - deleter: function that frees object.
+             *   - context: extra pointer forwarded to deleter; must outlive the domain.
+             * Thread-safety:
+             *   - The calling thread must be pinned (between Enter and Exit).
+             */
+            void Retire(void* object, Deleter deleter, void* context = nullptr);
+
+            /*
+             * Try to advance the global epoch and free the calling thread's objects that are
+             * no longer observable by any pinned thread.
+             */
+            void Collect();
+
+            /*
+             * Free every pending object regardless of its epoch.
+             * Thread-safety:
+             *   - Must be invoked when no thread is pinned in this domain and none retires concurrently,
+             *     e.g. right before the structure that owns the domain releases its memory.
+             */
+            void ReclaimAll();
+
+            /*
+             * Current value of the global epoch (monotonically increasing).
+             */
+            std::uint64_t Epoch() const noexcept;
+    };
+
+    /*
+     * Small dense index of the calling thread: 0 for the first thread that asks, then 1, 2, ...
+     * Used to spread counters that every reader updates over separate cache lines.
+     */
+    std::size_t ThreadIndex() noexcept;
+
+    /*
+     * RAII pin on an EpochManager: Enter on construction, Exit on destruction.
+     */
+    class EpochGuard {
+        private:
+            EpochManager& manager;
+
+        public:
+            explicit EpochGuard(EpochManager& manager) : manager(manager) {
+                manager.Enter();
+            }
+
+            ~EpochGuard() {
+                manager.Exit();
+            }
+
+            EpochGuard(const EpochGuard&) = delete;
+            EpochGuard& operator=(const EpochGuard&) = delete;
+    };
+}
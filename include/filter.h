@@ -0,0 +1,175 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 02.11.2025
+ * @description: Blocked Bloom filters over 64-bit key hashes. Every key sets and tests bits (or
+ * counters) of a single 64-byte block, so a lookup costs one cache line whatever the number of
+ * probes. BloomFilter is built once and read; CountingBloomFilter is updated concurrently and
+ * supports removal.
+ */
+
+#pragma once
+
+#include "comparator.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tbt {
+
+    class BloomFilter {
+        private:
+            struct alignas(64) Block {
+                std::uint64_t Words[8];
+            };
+
+            std::vector<Block> blocks;
+            std::uint32_t probes = 0;
+
+            std::size_t blockOf(std::uint64_t hash) const {
+                // Multiply-shift maps the high half of the hash onto [0, blocks) without a division.
+                return static_cast<std::size_t>(((hash >> 32) * blocks.size()) >> 32);
+            }
+
+        public:
+            /*
+             * Empty filter: contains nothing.
+             */
+            BloomFilter() = default;
+
+            /*
+             * Size a filter for an expected number of keys.
+             * Parameters:
+             *   - keys: number of keys that will be added.
+             *   - bitsPerKey: memory per key; 10 gives about 1% false positives, each extra bit
+             *     roughly divides the rate by 1.6.
+             */
+            BloomFilter(std::size_t keys, std::size_t bitsPerKey);
+
+            /*
+             * Add a key by its hash (ByteVectorHash).
+             */
+            void Add(std::uint64_t hash);
+
+            /*
+             * false if the key was certainly never added; true if it may have been.
+             */
+            bool MayContain(std::uint64_t hash) const;
+
+            /*
+             * Serialized form: [probes:4][block count:8][blocks][crc32c:4], little-endian.
+             */
+            ByteVector Encode() const;
+
+            /*
+             * Parse the output of Encode.
+             * Throws:
+             *   - std::runtime_error if bytes are truncated or fail their checksum.
+             */
+            static BloomFilter Decode(ByteView bytes);
+
+            /*
+             * Memory held by the bit array.
+             */
+            std::size_t SizeBytes() const {
+                return blocks.size() * sizeof(Block);
+            }
+    };
+
+    /*
+     * Outcome counters of a CountingBloomFilter.
+     *   - Negatives: lookups the filter answered "absent" on its own.
+     *   - Hits: lookups the filter let through that found the key.
+     *   - FalsePositives: lookups the filter let through for an absent key.
+     */
+    struct FilterStats {
+        std::uint64_t Negatives;
+        std::uint64_t Hits;
+        std::uint64_t FalsePositives;
+    };
+
+    /*
+     * Blocked counting Bloom filter: 4-bit counters instead of bits, 128 per 64-byte block, so
+     * keys can be removed again. Add, Remove and MayContain are lock-free and may run concurrently.
+     * Notes:
+     *   - Never answers "absent" for a key added more often than removed; a counter that reaches
+     *     15 stays there, trading a slightly higher false-positive rate for that guarantee.
+     *   - Sized once: past the expected number of keys the false-positive rate rises gradually.
+     *   - Outcome counters are striped over cache lines by thread, so readers recording them do not
+     *     contend on one line.
+     */
+    class CountingBloomFilter {
+        private:
+            struct alignas(64) Block {
+                std::atomic<std::uint64_t> Words[8];
+            };
+
+            struct alignas(64) Outcomes {
+                std::atomic<std::uint64_t> Negatives{0};
+                std::atomic<std::uint64_t> Hits{0};
+                std::atomic<std::uint64_t> FalsePositives{0};
+            };
+
+            static constexpr std::size_t OutcomeStripes = 16;
+
+            std::unique_ptr<Block[]> blocks;
+            std::size_t blockCount;
+            std::uint32_t probes;
+            mutable std::array<Outcomes, OutcomeStripes> outcomes;
+
+            std::size_t blockOf(std::uint64_t hash) const {
+                return static_cast<std::size_t>(((hash >> 32) * blockCount) >> 32);
+            }
+
+            template <typename Update>
+            void update(std::uint64_t hash, Update step);
+
+        public:
+            /*
+             * Size a filter.
+             * Parameters:
+             *   - expectedKeys: number of keys it should hold at once.
+             *   - falsePositiveRate: target share of absent keys let through, in (0, 1).
+             * Throws:
+             *   - std::invalid_argument if expectedKeys is 0 or falsePositiveRate is out of range.
+             */
+            CountingBloomFilter(std::size_t expectedKeys, double falsePositiveRate);
+
+            /*
+             * Count a key in (by its ByteVectorHash); call before the key becomes visible.
+             */
+            void Add(std::uint64_t hash);
+
+            /*
+             * Count a key out; call only after a matching Add, once the key is gone.
+             */
+            void Remove(std::uint64_t hash);
+
+            /*
+             * false if the key is certainly absent; true if it may be present.
+             */
+            bool MayContain(std::uint64_t hash) const;
+
+            /*
+             * Record the outcome of a lookup that consulted the filter.
+             * Parameters:
+             *   - passed: what MayContain answered.
+             *   - found: whether the lookup then found the key (ignored when passed is false).
+             */
+            void RecordLookup(bool passed, bool found) const;
+
+            /*
+             * Sum of the outcome counters.
+             */
+            FilterStats Stats() const;
+
+            /*
+             * Memory held by the counters.
+             */
+            std::size_t SizeBytes() const {
+                return blockCount * sizeof(Block);
+            }
+    };
+}
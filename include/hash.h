@@ -0,0 +1,62 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 20.10.2025
+ * @description: Hashing utilities for byte vectors: a 64-bit hash used to spread keys across
+ * shards and stripes, and the CRC-32C checksum and fixed-width integer encoding of the on-disk
+ * formats. Not suitable for cryptographic purposes.
+ */
+
+#pragma once
+
+#include "comparator.h"
+
+#include <string>
+
+namespace tbt {
+
+    /*
+     * Compute a 64-bit hash of a byte sequence.
+     * Parameters:
+     *   - bytes: data to hash.
+     * Returns:
+     *   - 64-bit hash; equal vectors always hash equally.
+     * Notes:
+     *   - Consumes the input eight bytes at a time; the result is stable across runs and threads.
+     */
+    std::uint64_t ByteVectorHash(ByteView bytes) noexcept;
+
+    /*
+     * CRC-32C (Castagnoli) of a byte sequence, as stored in log records and snapshot blocks.
+     * Parameters:
+     *   - bytes: data to checksum.
+     *   - crc: checksum of the preceding data, to checksum a sequence in pieces.
+     */
+    std::uint32_t Crc32c(ByteView bytes, std::uint32_t crc = 0) noexcept;
+
+    /*
+     * Append the low bytes of value to out, least significant byte first.
+     * Parameters:
+     *   - out: buffer to append to.
+     *   - value: integer to encode.
+     *   - bytes: number of bytes to write, 1..8; higher bytes of value are dropped.
+     */
+    void PutFixed(ByteVector& out, std::uint64_t value, int bytes);
+
+    /*
+     * Decode an integer written by PutFixed.
+     * Parameters:
+     *   - in: first encoded byte; bytes bytes must be readable.
+     *   - bytes: number of bytes to read, 1..8.
+     */
+    std::uint64_t GetFixed(const std::uint8_t* in, int bytes) noexcept;
+
+    /*
+     * Report a malformed on-disk structure.
+     * Parameters:
+     *   - format: name of the structure, used as the message prefix ("snapshot", "filter").
+     *   - what: what was wrong with it.
+     * Throws:
+     *   - std::runtime_error, always.
+     */
+    [[noreturn]] void ThrowCorrupt(const char* format, const std::string& what);
+}
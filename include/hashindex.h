@@ -0,0 +1,72 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 05.11.2025
+ * @description: Concurrent open-addressing hash table from key hashes to skip list nodes. It sits
+ * next to a BasicList so that point lookups and updates of present keys skip the descent; the list
+ * stays authoritative, and a key the index does not hold is simply searched for in the list.
+ */
+
+#pragma once
+
+#include "comparator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace tbt {
+
+    class Node;
+
+    /*
+     * Linear-probing table of 8-byte slots: a node pointer with the top 16 bits of the key hash in
+     * its unused upper bits, so most mismatching slots are skipped without touching the node.
+     * Find, Store and Erase are lock-free and may run concurrently.
+     * Notes:
+     *   - Nodes are found by the bytes of their key, so the list's Order::Equal must mean byte
+     *     equality.
+     *   - Callers keep nodes alive: Find and Store read the keys of nodes in the table, so they run
+     *     under the list's epoch pin, and a node is erased before it is retired.
+     *   - Erased slots become tombstones that later stores reuse. A key whose probe sequence is
+     *     full (past about twice the expected number of keys) is not indexed at all.
+     */
+    class HashIndex {
+        private:
+            std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+            std::size_t mask;
+
+        public:
+            /*
+             * Size a table for an expected number of keys (twice as many slots, rounded up to a
+             * power of two).
+             * Throws:
+             *   - std::invalid_argument if expectedKeys is 0.
+             */
+            explicit HashIndex(std::size_t expectedKeys);
+
+            /*
+             * Node holding key, or nullptr if the index does not know it. The node may be removed
+             * meanwhile (null Value); the caller then falls back to the list.
+             */
+            Node* Find(std::uint64_t hash, ByteView key) const;
+
+            /*
+             * Point the entry of the node's key at node, replacing an older node of the same key.
+             * Returns:
+             *   - false if no slot was free within the probe limit; the key then stays unindexed.
+             */
+            bool Store(std::uint64_t hash, Node* node);
+
+            /*
+             * Drop the entry of node if the table still points at it.
+             */
+            void Erase(std::uint64_t hash, const Node* node);
+
+            /*
+             * Memory held by the slots.
+             */
+            std::size_t SizeBytes() const {
+                return (mask + 1) * sizeof(std::uint64_t);
+            }
+    };
+}
@@ -0,0 +1,63 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 11.11.2025
+ * @description: Callback types of the read-modify-write calls of BasicList (Update, Merge) and the
+ * merge operators that come with the library: a 64-bit counter and byte appending.
+ */
+
+#pragma once
+
+#include "comparator.h"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace tbt {
+
+    /*
+     * New value of a key computed from its current one, for BasicList::Update.
+     * Parameters:
+     *   - current: the stored value, or std::nullopt if the key is absent.
+     *   - out: empty buffer for the new value.
+     * Returns:
+     *   - true to store out as the key's value, false to leave the key as it is.
+     * Notes:
+     *   - Runs while the key cannot change: under the writer lock, or in LockFree mode before a CAS
+     *     on the key's value that fails if it did change, in which case it runs again. It must not
+     *     call back into the list.
+     */
+    using UpdateFunction = std::function<bool(std::optional<ByteView> current, ByteVector& out)>;
+
+    /*
+     * Combine the stored value of a key with an operand, for BasicList::Merge.
+     * Parameters:
+     *   - existing: the stored value, or std::nullopt if the key is absent.
+     *   - operand: the argument of the Merge call.
+     *   - out: empty buffer for the merged value, which is then stored.
+     * Notes:
+     *   - Same rules as UpdateFunction; an exception leaves the key unchanged and reaches the caller.
+     */
+    using MergeOperator = std::function<void(std::optional<ByteView> existing, ByteView operand, ByteVector& out)>;
+
+    /*
+     * Counter merge: values and operands are 64-bit integers, 8 bytes little-endian, and the merged
+     * value is their sum (wrapping on overflow); an absent key counts as 0.
+     * Throws:
+     *   - std::invalid_argument if the stored value or the operand is not 8 bytes long.
+     */
+    void MergeAddInt64(std::optional<ByteView> existing, ByteView operand, ByteVector& out);
+
+    /*
+     * Append merge: the operand's bytes are appended to the stored value (to nothing if absent).
+     */
+    void MergeAppend(std::optional<ByteView> existing, ByteView operand, ByteVector& out);
+
+    /*
+     * 8-byte little-endian encoding used by MergeAddInt64, and its inverse.
+     * Throws (DecodeInt64):
+     *   - std::invalid_argument if bytes is not 8 bytes long.
+     */
+    ByteVector EncodeInt64(std::int64_t value);
+    std::int64_t DecodeInt64(ByteView bytes);
+}
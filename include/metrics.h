@@ -0,0 +1,83 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 08.11.2025
+ * @description: Optional usage counters of a skip list: entries, key and value bytes, tower
+ * heights and search lengths. Compiled in with TBT_METRICS=1 (CMake option
+ * THREADBYTETREE_METRICS); otherwise lists never allocate or touch them.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifndef TBT_METRICS
+#define TBT_METRICS 0
+#endif
+
+namespace tbt {
+
+    inline constexpr bool MetricsEnabled = TBT_METRICS != 0;
+
+    /*
+     * Sums of the counters of a MetricCounters. Heights[h - 1] is the number of live nodes with a
+     * tower of h links.
+     */
+    struct MetricTotals {
+        static constexpr std::size_t MaxHeights = 64;
+
+        std::int64_t Entries;
+        std::int64_t KeyBytes;
+        std::int64_t ValueBytes;
+        std::uint64_t Searches;
+        std::uint64_t NodesVisited;
+        std::array<std::int64_t, MaxHeights> Heights;
+    };
+
+    /*
+     * Counters updated by writers and readers of one list. Each thread adds to one of 16 stripes
+     * (by ThreadIndex) with relaxed atomics; Totals sums the stripes, so a total read while
+     * writes run may mix before and after states of different stripes.
+     */
+    class MetricCounters {
+        private:
+            struct alignas(64) Stripe {
+                std::atomic<std::int64_t> Entries{0};
+                std::atomic<std::int64_t> KeyBytes{0};
+                std::atomic<std::int64_t> ValueBytes{0};
+                std::atomic<std::uint64_t> Searches{0};
+                std::atomic<std::uint64_t> NodesVisited{0};
+                std::array<std::atomic<std::int64_t>, MetricTotals::MaxHeights> Heights{};
+            };
+
+            static constexpr std::size_t Stripes = 16;
+
+            std::array<Stripe, Stripes> stripes;
+
+            Stripe& local();
+
+        public:
+            /*
+             * A node became reachable (height links, key and value sizes in bytes).
+             */
+            void Linked(std::size_t height, std::size_t keyBytes, std::size_t valueBytes);
+
+            /*
+             * A node was removed; valueBytes is the size of the value it held.
+             */
+            void Unlinked(std::size_t height, std::size_t keyBytes, std::size_t valueBytes);
+
+            /*
+             * The value of a node was replaced.
+             */
+            void Replaced(std::size_t oldBytes, std::size_t newBytes);
+
+            /*
+             * A point lookup examined visited nodes.
+             */
+            void Searched(std::size_t visited);
+
+            MetricTotals Totals() const;
+    };
+}
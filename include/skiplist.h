@@ -1,85 +1,746 @@
 /*
  * @author: Viktor Shishmarev
  * @date: 14.10.2025
- * @description: This header declares a minimal skip list (List) for byte-vector keys and values,
- * and its building block Node. The structure is optimized for concurrent reads via
- * a read-write lock and supports put/get (insert/update and search).
+ * @description: This header declares a minimal skip list (BasicList, List for the default byte
+ * order) for byte-vector keys and values, and its building block Node. The structure is optimized for concurrent reads: readers
+ * never lock and are protected by epoch-based reclamation. Supports insert/update, search
+ * and remove.
  */
 
 #pragma once
 
+#include "arena.h"
 #include "comparator.h"
+#include "epoch.h"
+#include "filter.h"
+#include "hash.h"
+#include "hashindex.h"
+#include "merge.h"
+#include "metrics.h"
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <span>
 #include <utility>
 #include <vector>
 #include <shared_mutex>
+#include <mutex>
 
 namespace tbt{
 
+    /*
+     * Synchronization strategy used by a List. Readers never lock in any mode; they pin
+     * an epoch and rely on deferred reclamation of unlinked nodes and replaced values.
+     *   - Locked: writers are serialized by an exclusive lock.
+     *   - LockFree: writers splice and unlink nodes with CAS on forward links (bottom-up
+     *     linking, marked links for deletion).
+     *   - Combining: Locked with flat combining. A writer that finds the lock held publishes its
+     *     Insert or Remove in a slot and waits; the next thread to take the lock applies every
+     *     published write in one sorted pass, so a burst costs a few lock handoffs instead of one
+     *     per write.
+     */
+    enum class Concurrency {
+        Locked,
+        LockFree,
+        Combining
+    };
+
+    /*
+     * Writer contention counters of a List.
+     *   - Acquisitions: exclusive lock acquisitions (Locked and Combining modes).
+     *   - Contended: acquisitions that found the lock held (Locked), writes that found it held
+     *     and were published for combining (Combining), or CAS races lost on a forward link
+     *     (LockFree).
+     *   - WaitNanoseconds: total time writers spent blocked on the lock (Locked mode, and
+     *     Combining writes that could not get a slot).
+     *   - Combined: writes applied by another thread's combining pass (Combining mode only).
+     */
+    struct LockStats {
+        std::uint64_t Acquisitions;
+        std::uint64_t Contended;
+        std::uint64_t WaitNanoseconds;
+        std::uint64_t Combined;
+    };
+
+    /*
+     * Usage report of a List (see BasicList::GetMetrics).
+     *   - Entries, KeyBytes, ValueBytes: live entries and the bytes of their keys and values.
+     *   - OverheadBytes: arena bytes in use beyond those (node headers, towers, alignment, and
+     *     nodes and values still waiting for reclamation).
+     *   - Heights: Heights[h - 1] is the number of live nodes with a tower of h links, h up to
+     *     MaxLevel (or the tallest tower, if taller). With promotion probability p, about n * p^(h-1) * (1-p) nodes are expected.
+     *   - MaxLevel, Probability, CurrentLevel: tower limit of new nodes (as built, or as set by
+     *     adaptive levels) and promotion probability, and the highest level currently linked.
+     *   - SuggestedMaxLevel: levels that keep searches O(log n) at this size, ceil(log_{1/p} n) + 1;
+     *     a MaxLevel far below it means long searches along the top level.
+     *   - Searches, NodesVisited: point lookups (Search, SearchInto, Find) and the nodes their
+     *     descents compared with the key; an index hit visits none.
+     *   - Lock: writer contention (see LockStats).
+     * Notes:
+     *   - All but MaxLevel, Probability, CurrentLevel, OverheadBytes and Lock are 0 unless the
+     *     library is built with TBT_METRICS=1; OverheadBytes then is every byte in use.
+     */
+    struct ListMetrics {
+        std::uint64_t Entries;
+        std::uint64_t KeyBytes;
+        std::uint64_t ValueBytes;
+        std::uint64_t OverheadBytes;
+        std::vector<std::uint64_t> Heights;
+        std::size_t MaxLevel;
+        float Probability;
+        std::size_t CurrentLevel;
+        std::size_t SuggestedMaxLevel;
+        std::uint64_t Searches;
+        std::uint64_t NodesVisited;
+        LockStats Lock;
+
+        double AverageVisited() const {
+            return Searches == 0 ? 0.0 : static_cast<double>(NodesVisited) / static_cast<double>(Searches);
+        }
+    };
+
+    /*
+     * Tower-height state of a List (see BasicList::GetLevelStats).
+     *   - MaxLevel: tower limit of new nodes; with adaptive levels it follows the entry count.
+     *   - CurrentLevel: highest level currently linked (0-based).
+     *   - Entries: live entries, counted only with adaptive levels (0 otherwise).
+     *   - SearchDepth: average number of nodes a descent compares with the key, measured on up to
+     *     64 keys spread evenly over the list.
+     *   - Relocated, Passes: nodes re-towered by rebalancing, and rebalance passes completed.
+     */
+    struct LevelStats {
+        std::size_t MaxLevel;
+        std::size_t CurrentLevel;
+        std::uint64_t Entries;
+        double SearchDepth;
+        std::uint64_t Relocated;
+        std::uint64_t Passes;
+    };
+
+    /*
+     * Bounded-cache report of a List (see BasicList::EnableEviction and GetCacheStats).
+     *   - BudgetBytes: the byte budget; 0 without eviction.
+     *   - ChargedBytes: bytes charged for live entries: each node block (header, tower, key and
+     *     the value written at insertion) plus the values that replaced it.
+     *   - Hits, Misses: point lookups (Search, SearchInto, Find, MultiSearch) that found or
+     *     missed their key.
+     *   - Evictions: entries removed to get back under the budget.
+     *   - SecondChances: referenced entries the clock hand passed over, clearing their bit.
+     */
+    struct CacheStats {
+        std::size_t BudgetBytes;
+        std::size_t ChargedBytes;
+        std::uint64_t Hits;
+        std::uint64_t Misses;
+        std::uint64_t Evictions;
+        std::uint64_t SecondChances;
+
+        double HitRate() const {
+            const std::uint64_t lookups = Hits + Misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(Hits) / static_cast<double>(lookups);
+        }
+    };
+
+    class ValueBuffer;
+
+    /*
+     * Version stamp placed right before a versioned ValueBuffer (lists with snapshots enabled):
+     * the sequence number of the write that stored it and the version it replaced, kept while
+     * an open snapshot may still read it.
+     */
+    struct VersionHeader {
+        std::uint64_t Sequence;
+        std::atomic<ValueBuffer*> Older;
+    };
+
+    /*
+     * Immutable value bytes stored behind a node's atomic value pointer. Allocated from the
+     * list's Arena, either inside the node's own block (the value given at insertion) or on
+     * its own (values written by later updates). In lists with snapshots enabled every value is
+     * a standalone versioned buffer, and a removal may store a versioned tombstone.
+     */
+    class ValueBuffer {
+        public:
+            std::uint32_t Size;
+            bool Inline;
+            bool Versioned = false;
+            bool Tombstone = false;
+            // Set on the copy a rebalanced node keeps while readers may still stand on it; the
+            // index fast path must not update such a node (see BasicList::RebalanceStep).
+            bool Frozen = false;
+
+            /*
+             * Allocate a standalone buffer holding a copy of value.
+             * Parameters:
+             *   - arena: arena to allocate from.
+             *   - value: bytes to copy.
+             * Returns:
+             *   - The new buffer.
+             * Throws:
+             *   - std::length_error if value is larger than 4 GiB.
+             */
+            static ValueBuffer* Create(Arena& arena, ByteView value);
+
+            /*
+             * Allocate a versioned buffer: a VersionHeader followed by a copy of value.
+             * Parameters:
+             *   - sequence: sequence number of the write storing it.
+             *   - older: the version it replaces (nullptr for the first one).
+             *   - tombstone: true if the write is a removal (value is then empty).
+             * Throws:
+             *   - std::length_error if value is larger than 4 GiB.
+             */
+            static ValueBuffer* CreateVersion(Arena& arena, ByteView value, std::uint64_t sequence, ValueBuffer* older, bool tombstone);
+
+            VersionHeader& Version() {
+                return reinterpret_cast<VersionHeader*>(this)[-1];
+            }
+
+            const VersionHeader& Version() const {
+                return reinterpret_cast<const VersionHeader*>(this)[-1];
+            }
+
+            /*
+             * Sequence number of the write that stored this value; 0 for unversioned values.
+             */
+            std::uint64_t Sequence() const {
+                return Versioned ? Version().Sequence : 0;
+            }
+
+            /*
+             * Start of the arena block of a standalone buffer.
+             */
+            void* Block() {
+                return Versioned ? static_cast<void*>(&Version()) : static_cast<void*>(this);
+            }
+
+            const uint8_t* Data() const {
+                return reinterpret_cast<const uint8_t*>(this + 1);
+            }
+
+            ByteView View() const {
+                return {Data(), Size};
+            }
+
+            /*
+             * Size of the arena block backing a standalone buffer.
+             */
+            std::size_t AllocationSize() const {
+                return (Versioned ? sizeof(VersionHeader) : 0) + sizeof(ValueBuffer) + Size;
+            }
+    };
+
+    /*
+     * Key/value pair copied out of a list by range reads.
+     */
+    struct Entry {
+        ByteVector Key;
+        ByteVector Value;
+    };
+
+    /*
+     * Direction of a range cursor.
+     */
+    enum class ScanOrder {
+        Ascending,
+        Descending
+    };
+
+    /*
+     * Read access to a stored value without copying it. The view keeps the calling thread pinned
+     * to the list's epoch, so the bytes stay valid even if the key is updated or removed meanwhile;
+     * the pin is dropped when the view is destroyed.
+     * Notes:
+     *   - Must be destroyed on the thread that obtained it (the pin is per thread).
+     *   - While any view is alive, the list cannot free memory retired after it was taken; keep
+     *     views short-lived (e.g. for the duration of a socket write).
+     */
+    class ValueView {
+        private:
+            EpochManager* epoch = nullptr;
+            ByteView bytes;
+
+        public:
+            /*
+             * Empty view: the key was not found.
+             */
+            ValueView() = default;
+
+            /*
+             * Adopt a pin taken with epoch.Enter() that protects bytes.
+             */
+            ValueView(EpochManager& epoch, ByteView bytes) : epoch(&epoch), bytes(bytes) {}
+
+            ValueView(ValueView&& other) noexcept : epoch(std::exchange(other.epoch, nullptr)), bytes(std::exchange(other.bytes, {})) {}
+
+            ValueView& operator=(ValueView&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    epoch = std::exchange(other.epoch, nullptr);
+                    bytes = std::exchange(other.bytes, {});
+                }
+                return *this;
+            }
+
+            ValueView(const ValueView&) = delete;
+            ValueView& operator=(const ValueView&) = delete;
+
+            ~ValueView() {
+                reset();
+            }
+
+            /*
+             * Drop the pin early; the view becomes empty.
+             */
+            void reset() {
+                if (epoch != nullptr) {
+                    epoch->Exit();
+                    epoch = nullptr;
+                }
+                bytes = {};
+            }
+
+            /*
+             * true if the key was found (its value may still be empty).
+             */
+            explicit operator bool() const {
+                return epoch != nullptr;
+            }
+
+            ByteView View() const {
+                return bytes;
+            }
+
+            const uint8_t* Data() const {
+                return bytes.data();
+            }
+
+            std::size_t Size() const {
+                return bytes.size();
+            }
+    };
+
+    /*
+     * Skip list node laid out in a single arena block:
+     *   [header][Forward tower: Height links][key bytes][inline ValueBuffer + value bytes]
+     * The 24-byte header keeps the first eight key bytes (KeyPrefix, big-endian) and the key
+     * length next to the tower, so most comparisons during a descent are decided without touching
+     * the key bytes. The value capacity is not stored: the inline ValueBuffer records it.
+     */
     class Node {
+        private:
+            Node(std::uint64_t keyPrefix, std::uint32_t keySize, std::uint8_t height)
+                : KeyPrefix(keyPrefix), Value(nullptr), KeySize(keySize), Height(height), Referenced(1), References(2) {}
+
+            std::size_t valueOffset() const;
+
         public:
-            ByteVector Key;
-            ByteVector Value;
-            std::vector<Node*> Forward;
+            /*
+             * Largest tower a node can have; 64 levels cover any realistic list size.
+             */
+            static constexpr std::size_t MaxHeight = 64;
+
+            std::uint64_t KeyPrefix;
+            std::atomic<ValueBuffer*> Value;
+            std::uint32_t KeySize;
+            std::uint8_t Height;
+            // CLOCK reference bit of lists with eviction (see BasicList::EnableEviction): set by
+            // lookups, cleared by the clock hand. New nodes start referenced.
+            mutable std::atomic<std::uint8_t> Referenced;
+            std::atomic<std::uint16_t> References;
 
             /*
-             * Construct a node that stores a key/value pair and forward pointers for skip list levels.
+             * Allocate and initialize a node that stores a key/value pair and forward pointers.
              * Parameters:
-             *   - key: byte-vector key for this node.
-             *   - value: byte-vector value associated with the key.
+             *   - arena: arena to allocate the node block from.
+             *   - key: key bytes, copied into the block.
+             *   - keyPrefix: order summary of key cached in the header (0 for orders without one).
+             *   - value: value bytes, copied into the block's inline ValueBuffer.
              *   - heightLevels: number of forward pointers (levels) for this node (>=1 for level 0).
-             * Effects:
-             *   - Initializes Forward with heightLevels null pointers.
+             * Returns:
+             *   - The new node with null forward pointers and Value pointing to the inline buffer.
+             * Throws:
+             *   - std::length_error if key or value is larger than 4 GiB.
+             * Notes:
+             *   - References starts at 2: one for the inserting writer, one for the eventual remover.
+             *   - A null Value marks the node as logically deleted.
+             */
+            static Node* Create(Arena& arena, ByteView key, std::uint64_t keyPrefix, ByteView value, std::size_t heightLevels);
+
+            /*
+             * Size of the arena block needed for a node with the given shape.
+             */
+            static std::size_t AllocationSize(std::size_t keySize, std::size_t valueSize, std::size_t heightLevels);
+
+            /*
+             * Size of this node's arena block.
              */
-            Node(const ByteVector& key, const ByteVector& value, std::size_t heightLevels)
-                : Key(key), Value(value), Forward(heightLevels, nullptr) {}
+            std::size_t AllocationSize() const {
+                return AllocationSize(KeySize, InlineValue()->Size, Height);
+            }
+
+            /*
+             * Forward link at the given level (0..Height-1).
+             */
+            std::atomic<Node*>& Forward(std::size_t level) {
+                return reinterpret_cast<std::atomic<Node*>*>(this + 1)[level];
+            }
+
+            const std::atomic<Node*>& Forward(std::size_t level) const {
+                return reinterpret_cast<const std::atomic<Node*>*>(this + 1)[level];
+            }
+
+            ByteView Key() const {
+                return {reinterpret_cast<const uint8_t*>(reinterpret_cast<const std::atomic<Node*>*>(this + 1) + Height), KeySize};
+            }
+
+            /*
+             * The value buffer embedded in this node's block.
+             */
+            ValueBuffer* InlineValue() {
+                return reinterpret_cast<ValueBuffer*>(reinterpret_cast<char*>(this) + valueOffset());
+            }
+
+            const ValueBuffer* InlineValue() const {
+                return reinterpret_cast<const ValueBuffer*>(reinterpret_cast<const char*>(this) + valueOffset());
+            }
     };
 
-    class List {
+    /*
+     * Skip list ordered by the KeyOrder policy Order; List is the byte-ordered instantiation.
+     */
+    template <KeyOrder Order = ByteOrder>
+    class BasicList {
         private:
+            // Per-level predecessors of a key; lives on the writer's stack, so a write allocates
+            // nothing besides the node or value block.
+            using Path = std::array<Node*, Node::MaxHeight>;
+
+            // A write published for combining (Combining mode). The owner fills it while Claimed;
+            // the combiner reads it while Pending and writes Result/Error before Done.
+            struct alignas(64) CombiningSlot {
+                std::atomic<std::uint8_t> State{0};
+                bool Remove = false;
+                bool Result = false;
+                ByteView Key;
+                ByteView Value;
+                std::exception_ptr Error;
+            };
+            static constexpr std::size_t CombiningSlots = 64;
+
             Node* head;
-            std::size_t maxLevel;
-            std::size_t currentLevel;
+            // Tower limit of new nodes; the head has Node::MaxHeight links, so it may grow.
+            std::atomic<std::size_t> maxLevel;
+            std::atomic<std::size_t> currentLevel;
             float probability;
+            Concurrency concurrency;
             mutable std::shared_mutex mux;
+            Arena arena;
+            mutable EpochManager epoch;
+            std::atomic<std::uint64_t> exclusiveAcquisitions{0};
+            mutable std::atomic<std::uint64_t> contendedWrites{0};
+            std::atomic<std::uint64_t> waitNanoseconds{0};
+            // Optional membership filter, maintained by every write once enabled.
+            std::unique_ptr<CountingBloomFilter> filter;
+            // Optional point-lookup index; a node is stored once linked and erased before retirement.
+            std::unique_ptr<HashIndex> index;
+            // Combining mode: one slot per thread (by ThreadIndex), and the number of Pending ones.
+            std::unique_ptr<CombiningSlot[]> slots;
+            std::atomic<std::size_t> pendingWrites{0};
+            std::atomic<std::uint64_t> combinedWrites{0};
+            // Usage counters, allocated only when built with TBT_METRICS=1.
+            std::unique_ptr<MetricCounters> metrics;
+            // Snapshots (EnableSnapshots): values are versioned and stamped with the sequence of
+            // their write; a version stays reachable while an open snapshot may read it.
+            static constexpr std::uint64_t NoSnapshot = std::numeric_limits<std::uint64_t>::max();
+            bool versioned = false;
+            std::atomic<std::uint64_t> sequence{0};
+            std::atomic<std::uint64_t> oldestSnapshot{NoSnapshot};
+            // Writes that left history behind (older versions or tombstones) since the last sweep.
+            std::atomic<std::uint64_t> retainedVersions{0};
+            std::mutex snapshotMux;
+            std::multiset<std::uint64_t> openSnapshots;
+            // Adaptive levels (EnableAdaptiveLevels): live entries striped by thread, and the
+            // number of writes, so that each stripe retunes maxLevel every RetuneInterval writes.
+            struct alignas(64) EntryStripe {
+                std::atomic<std::int64_t> Entries{0};
+                std::atomic<std::uint64_t> Writes{0};
+            };
+            static constexpr std::size_t EntryStripes = 16;
+            static constexpr std::uint64_t RetuneInterval = 256;
+            std::unique_ptr<EntryStripe[]> entryCounts;
+            // Rebalancing: where the pass in progress stopped (written under the lock), and totals.
+            ByteVector rebalanceResume;
+            std::size_t rebalanceRank = 0;
+            std::atomic<std::uint64_t> relocatedNodes{0};
+            std::atomic<std::uint64_t> rebalancePasses{0};
+            // Set once with SetMergeOperator, before the list is shared.
+            MergeOperator mergeOperator;
+            // Eviction (EnableEviction): bytes charged for live entries against the budget, checked
+            // after every write, so one counter; lookup outcomes striped by thread; and the CLOCK
+            // hand, the key it last stopped at, moved by one writer at a time.
+            struct alignas(64) LookupStripe {
+                std::atomic<std::uint64_t> Hits{0};
+                std::atomic<std::uint64_t> Misses{0};
+            };
+            static constexpr std::size_t LookupStripes = 16;
+            std::unique_ptr<LookupStripe[]> lookupCounts;
+            std::size_t evictionBudget = 0;
+            std::atomic<std::int64_t> chargedBytes{0};
+            std::mutex clockMux;
+            ByteVector clockHand;
+            bool clockStarted = false;
+            std::atomic<std::uint64_t> evictedEntries{0};
+            std::atomic<std::uint64_t> secondChances{0};
+
+            // Read-modify-write step: the new value (a view of scratch, the current value or any
+            // bytes outliving the call) or std::nullopt to leave the key alone.
+            using Rewrite = std::function<std::optional<ByteView>(std::optional<ByteView> current, ByteVector& scratch)>;
+            enum class Rewritten {
+                Unchanged,
+                Updated,
+                Created
+            };
 
-            void clear() const;
+            void clear();
+            void noteLinked(const Node* node, std::size_t valueBytes);
+            void noteUnlinked(const Node* node, const ValueBuffer* value);
+            void noteReplaced(const ValueBuffer* old, std::size_t newBytes);
+            void noteLookup(const Node* node) const;
+            void evictOverBudget();
+            bool advanceClock(ByteVector& victim, std::size_t& wraps);
+            std::unique_lock<std::shared_mutex> lockExclusive();
+            std::unique_lock<std::shared_mutex> tryLockExclusive();
+            void countLostRace() const;
+            std::size_t randomLevel() const;
+            void raiseLevel(std::size_t level);
+            Node* findNode(ByteView key) const;
+            Node* findCounting(ByteView key, std::size_t& visited) const;
+            void countEntries(std::int64_t delta);
+            std::int64_t liveEntries() const;
+            void retuneLevels();
+            Node* relocateLocked(Node* node, std::size_t height, std::span<Node*> preds);
+            template <typename Before>
+            const Node* descend(Before before) const;
+            const Node* seekNode(ByteView key, bool inclusive) const;
+            const Node* lastBefore(ByteView key, bool bounded) const;
+            static const Node* nextNode(const Node* node);
+            Node* fingerSeek(ByteView key, std::uint64_t keyPrefix, std::span<Node*> path) const;
+            static void appendEntry(std::vector<Entry>& out, const Node* node);
+            bool findLockFree(ByteView key, std::span<Node*> preds, std::span<Node*> succs);
+            void markNode(Node* node);
+            void releaseNode(Node* node);
+            void retireValue(ValueBuffer* value);
+            // true if a node was created, false if an existing key was updated.
+            bool insertLocked(ByteView key, ByteView value);
+            bool insertLockFree(ByteView key, ByteView value);
+            void multiInsertLocked(std::span<const std::pair<ByteView, ByteView>> entries, std::span<const std::size_t> order);
+            void linkTowerLockFree(Node* node, std::size_t newLevel, ByteView key, std::span<Node*> preds, std::span<Node*> succs);
+            bool rewrite(ByteView key, const Rewrite& compute);
+            Rewritten rewriteLocked(ByteView key, const Rewrite& compute);
+            Rewritten rewriteLockFree(ByteView key, const Rewrite& compute);
+            bool removeLocked(ByteView key);
+            bool removeLockFree(ByteView key);
+            void unlinkLocked(Node* victim, std::span<Node* const> preds);
+            void shrinkLevel();
+            Node* createNode(ByteView key, std::uint64_t keyPrefix, ByteView value, std::size_t height);
+            void publishVersion();
+            Node* searchLocked(ByteView key, std::span<Node*> preds);
+            bool replaceLocked(Node* node, ByteView value);
+            bool removeNodeLocked(Node* victim, std::span<Node* const> preds);
+            void pruneVersions(ValueBuffer* newest);
+            void retireVersions(ValueBuffer* value);
+            void collectVersions();
+            std::uint64_t openSnapshot();
+            void closeSnapshot(std::uint64_t snapshot);
+            static const ValueBuffer* versionAt(const Node* node, std::uint64_t snapshot);
+            bool combine(bool remove, ByteView key, ByteView value);
+            void applyCombined(CombiningSlot* own);
+            void indexNode(Node* node);
+            void unindexNode(const Node* node);
+            bool updateIndexed(std::uint64_t hash, ByteView key, ByteView value);
         public:
+            /*
+             * Iterator over a key range that copies entries out in batches of BatchSize. Each batch is
+             * read under a short epoch pin; the next one re-seeks past the last key returned, so a
+             * cursor can stay open indefinitely without holding back writers or reclamation.
+             * Notes:
+             *   - Weakly consistent: every entry returned was present at some point during the walk;
+             *     keys inserted or removed concurrently may or may not be seen.
+             *   - Descending cursors pay one O(log n) descent per entry, ascending ones one per batch.
+             *   - The list must outlive the cursor.
+             */
+            class Cursor {
+                private:
+                    const BasicList* list;
+                    ByteVector lower;
+                    ByteVector upper;
+                    ByteVector resume;
+                    ScanOrder order;
+                    std::vector<Entry> batch;
+                    std::size_t position = 0;
+                    bool started = false;
+                    bool exhausted = false;
+
+                    void refill();
+
+                public:
+                    static constexpr std::size_t BatchSize = 64;
+
+                    /*
+                     * Position a cursor on the first entry of [begin, end) in the given order.
+                     * Parameters:
+                     *   - begin: inclusive lower bound; empty means from the smallest key.
+                     *   - end: exclusive upper bound; empty means up to the largest key.
+                     */
+                    Cursor(const BasicList& list, ByteView begin, ByteView end, ScanOrder order);
+
+                    /*
+                     * true while the cursor stands on an entry.
+                     */
+                    bool Valid() const {
+                        return position < batch.size();
+                    }
+
+                    const ByteVector& Key() const {
+                        return batch[position].Key;
+                    }
+
+                    const ByteVector& Value() const {
+                        return batch[position].Value;
+                    }
+
+                    /*
+                     * Move to the next entry in the cursor's order; Valid() turns false past the range.
+                     */
+                    void Next();
+            };
+
+            /*
+             * Consistent read-only view of a list as of its creation (see OpenSnapshot). Reads see
+             * every write that completed before the snapshot was opened and none that started
+             * after; each read pins the epoch only for its own duration.
+             * Notes:
+             *   - Movable, not copyable. Closing the last (or oldest) snapshot lets later writes and
+             *     the closing thread drop the versions it kept alive.
+             *   - Lookups go straight to the list: the filter and the index describe the latest
+             *     state, not the snapshot's.
+             *   - The list must outlive the snapshot.
+             */
+            class Snapshot {
+                private:
+                    BasicList* list;
+                    std::uint64_t sequence;
+
+                public:
+                    explicit Snapshot(BasicList& list) : list(&list), sequence(list.openSnapshot()) {}
+
+                    Snapshot(Snapshot&& other) noexcept : list(std::exchange(other.list, nullptr)), sequence(other.sequence) {}
+
+                    Snapshot& operator=(Snapshot&& other) noexcept {
+                        if (this != &other) {
+                            if (list != nullptr) {
+                                list->closeSnapshot(sequence);
+                            }
+                            list = std::exchange(other.list, nullptr);
+                            sequence = other.sequence;
+                        }
+                        return *this;
+                    }
+
+                    Snapshot(const Snapshot&) = delete;
+                    Snapshot& operator=(const Snapshot&) = delete;
+
+                    ~Snapshot() {
+                        if (list != nullptr) {
+                            list->closeSnapshot(sequence);
+                        }
+                    }
+
+                    /*
+                     * Sequence number of the last write the snapshot sees.
+                     */
+                    std::uint64_t Sequence() const {
+                        return sequence;
+                    }
+
+                    /*
+                     * Value of key as of the snapshot, copied into out.
+                     * Returns:
+                     *   - true if the key was present; out is left empty otherwise.
+                     */
+                    bool SearchInto(ByteView key, ByteVector& out) const;
+
+                    /*
+                     * Value of key as of the snapshot; empty if it was absent.
+                     */
+                    ByteVector Search(ByteView key) const {
+                        ByteVector out;
+                        SearchInto(key, out);
+                        return out;
+                    }
+
+                    /*
+                     * Entries with begin <= key < end as of the snapshot, at most limit of them; empty
+                     * bounds are unbounded, as for BasicList::Scan. Repeated calls page through the
+                     * same state, however the list changes in between.
+                     */
+                    std::vector<Entry> Scan(ByteView begin, ByteView end, std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+            };
+
             /*
              * Construct a skip list with a specified number of levels and promotion probability.
              * Parameters:
              *   - maxLevel: total number of levels available (>=1), indexed 0..maxLevel-1.
              *   - probability: node-promotion probability used for random height generation; must be in (0,1).
+             *   - concurrency: synchronization strategy (Locked by default, LockFree or Combining).
              * Returns:
              *   - N/A
              * Throws:
              *   - std::invalid_argument if probability is not strictly between 0 and 1.
+             *   - std::invalid_argument if maxLevel exceeds Node::MaxHeight.
              * Effects:
-             *   - Allocates a sentinel head node with maxLevel forward pointers and initializes internal state.
+             *   - Allocates a sentinel head node with Node::MaxHeight forward pointers (maxLevel can grow
+             *     with EnableAdaptiveLevels) and initializes internal state.
              */
-            List(std::size_t maxLevel, float probability);
+            BasicList(std::size_t maxLevel, float probability, Concurrency concurrency = Concurrency::Locked);
 
             /*
-             * Destroy the list and free all nodes.
+             * Destroy the list and free all nodes, including nodes and values still awaiting reclamation,
+             * by releasing the arena in bulk.
              * Thread-safety:
              *   - Acquires an exclusive lock internally; should be invoked when no other operations are running.
              */
-            ~List();
+            ~BasicList();
+
+            BasicList(const BasicList&) = delete;
+            BasicList& operator=(const BasicList&) = delete;
 
             /*
              * Insert or update a key with the given value.
              * Parameters:
-             *   - key: byte-vector key (ordered lexicographically using unsigned byte semantics).
+             *   - key: byte-vector key (ordered by Order; lexicographically on unsigned bytes by default).
              *   - value: byte-vector value to associate with the key.
              * Returns:
              *   - N/A
              * Effects:
-             *   - If the key exists, its value is replaced; otherwise a new node is inserted with a random height.
+             *   - If the key exists, its value pointer is swapped atomically and the old buffer is retired;
+             *     otherwise a new node is inserted with a random height.
              * Thread-safety:
-             *   - Acquires a unique (exclusive) lock; concurrent writers are serialized.
+             *   - Locked: acquires a unique (exclusive) lock; concurrent writers are serialized.
+             *   - LockFree: links the node level by level with CAS, bottom-up; concurrent writers
+             *     retry only when they race on the same forward link.
              * Complexity:
              *   - Expected O(log n) time.
              */
-            void Insert(const ByteVector& key, const ByteVector& value);
+            void Insert(ByteView key, ByteView value);
 
             /*
              * Look up a key and return its associated value.
@@ -88,13 +749,416 @@ namespace tbt{
              * Returns:
              *   - The associated value if found; otherwise an empty ByteVector.
              * Thread-safety:
-             *   - Acquires a shared lock allowing multiple concurrent readers.
+             *   - Takes no lock in either mode; the calling thread is pinned to the current epoch
+             *     while it walks the list and copies the value.
+             * Complexity:
+             *   - Expected O(log n) time.
+             */
+            ByteVector Search(ByteView key) const;
+
+            /*
+             * Look up a key and copy its value into a caller-provided buffer.
+             * Parameters:
+             *   - key: byte-vector key to search for.
+             *   - out: receives the value; its capacity is reused, so a buffer kept across calls
+             *     stops allocating once it has grown to the largest value read.
+             * Returns:
+             *   - true if the key was found; false otherwise (out is then cleared).
+             * Thread-safety:
+             *   - Same as Search.
+             */
+            bool SearchInto(ByteView key, ByteVector& out) const;
+
+            /*
+             * Look up a key and return a pinned view of its value instead of a copy.
+             * Parameters:
+             *   - key: byte-vector key to search for.
+             * Returns:
+             *   - A ValueView over the stored bytes, or an empty view if the key is absent.
+             * Thread-safety:
+             *   - Takes no lock. The bytes stay valid until the view is destroyed, even if the key is
+             *     updated or removed concurrently; the view then shows the value read at lookup time.
+             * Complexity:
+             *   - Expected O(log n) time; no allocation and no copy of the value.
+             */
+            ValueView Find(ByteView key) const;
+
+            /*
+             * Look up a batch of keys with one epoch pin, in key order, each search resuming from
+             * the previous one's path (finger search) instead of the head.
+             * Parameters:
+             *   - keys: keys to look up, in any order; duplicates are allowed.
+             * Returns:
+             *   - One slot per key, in the order of keys: the value, or std::nullopt if absent.
+             * Thread-safety:
+             *   - Takes no lock; each key is looked up atomically, the batch as a whole is not a snapshot.
+             * Complexity:
+             *   - O(b log b) to sort the batch, then expected O(log d) per key for a distance d (in
+             *     entries) from the previous key, instead of O(log n).
+             */
+            std::vector<std::optional<ByteVector>> MultiSearch(std::span<const ByteView> keys) const;
+
+            /*
+             * Insert or update a batch of entries, in key order, with finger search between them.
+             * Parameters:
+             *   - entries: key/value pairs in any order; for a key given several times the last one wins.
+             * Thread-safety:
+             *   - Locked: the exclusive lock is taken once for the whole batch.
+             *   - LockFree: entries are inserted one by one in key order (CAS per entry, no lock), which
+             *     keeps consecutive searches in cache but does not reuse the path.
+             * Complexity:
+             *   - Locked: O(b log b) to sort, then expected O(log d) per entry (see MultiSearch).
+             */
+            void MultiInsert(std::span<const std::pair<ByteView, ByteView>> entries);
+
+            /*
+             * Fill an empty list from entries already sorted by key, linking every node in one pass
+             * (e.g. a reload at startup) instead of one descent and one lock acquisition per entry.
+             * Parameters:
+             *   - entries: random-access range of key/value pairs (anything convertible to
+             *     std::pair<ByteView, ByteView>, such as std::pair<ByteVector, ByteVector>), sorted by
+             *     Order; for a run of equal keys the last one wins.
+             *   - threads: number of threads building nodes (1 builds on the calling thread alone).
+             *     Each thread copies and links a contiguous slice; slices are stitched at the end.
+             * Throws:
+             *   - std::invalid_argument if entries are not sorted; the list is left untouched.
+             *   - std::logic_error if the list is not empty.
+             *   - std::length_error if a key or value is larger than 4 GiB (the list stays empty).
+             * Effects:
+             *   - Tower heights are deterministic rather than random: with a fan-out of k = 1/probability
+             *     (rounded, at least 2), every k-th node reaches level 1, every k^2-th level 2, and so on.
+             * Thread-safety:
+             *   - Locked: takes the exclusive lock. LockFree: must not run concurrently with other writers.
+             *     Readers may run meanwhile and see a growing prefix of the entries.
+             * Complexity:
+             *   - O(n) time besides the copy of keys and values; no comparisons beyond the sortedness check.
+             */
+            template <std::ranges::random_access_range Entries>
+                requires std::convertible_to<std::ranges::range_reference_t<Entries>, std::pair<ByteView, ByteView>>
+            void BulkLoad(const Entries& entries, std::size_t threads = 1);
+
+            /*
+             * Copy out the entries of a key range in ascending order.
+             * Parameters:
+             *   - begin: inclusive lower bound; empty means from the smallest key.
+             *   - end: exclusive upper bound; empty means up to the largest key.
+             *   - limit: maximum number of entries returned.
+             * Returns:
+             *   - Entries with begin <= key < end, at most limit of them.
+             * Thread-safety:
+             *   - Takes no lock; the whole walk runs under one epoch pin, so prefer a Cursor for
+             *     ranges too large to copy at once.
+             * Complexity:
+             *   - Expected O(log n + k) for k entries visited.
+             */
+            std::vector<Entry> Scan(ByteView begin, ByteView end, std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+
+            /*
+             * Copy out the entries whose key starts with prefix, in ascending order.
+             * Parameters:
+             *   - prefix: leading key bytes; empty matches every key.
+             *   - limit: maximum number of entries returned.
+             * Notes:
+             *   - Only for byte order, where keys sharing a prefix are contiguous from the prefix on.
+             */
+            std::vector<Entry> ScanPrefix(ByteView prefix, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+                requires std::same_as<Order, ByteOrder>;
+
+            /*
+             * First entry whose key is not less than key.
+             * Returns:
+             *   - The entry, or std::nullopt if every key is less than key.
+             */
+            std::optional<Entry> LowerBound(ByteView key) const;
+
+            /*
+             * Open a batched cursor over [begin, end) (see Cursor).
+             */
+            Cursor OpenCursor(ByteView begin = {}, ByteView end = {}, ScanOrder order = ScanOrder::Ascending) const {
+                return Cursor(*this, begin, end, order);
+            }
+
+            /*
+             * Remove a key and its value.
+             * Parameters:
+             *   - key: byte-vector key to remove.
+             * Returns:
+             *   - true if the key was present and this call removed it; false otherwise.
+             * Effects:
+             *   - Marks the node's forward links, unlinks it from every level and retires it; memory is
+             *     freed once no pinned reader can still observe it.
+             * Thread-safety:
+             *   - Locked: acquires a unique (exclusive) lock.
+             *   - LockFree: the value swap to null is the linearization point; unlinking is finished
+             *     cooperatively by concurrent traversals.
              * Complexity:
              *   - Expected O(log n) time.
              */
-            ByteVector Search(const ByteVector& key) const;
+            bool Remove(ByteView key);
+
+            /*
+             * Read-modify-write of one key in a single descent: fn sees the current value and
+             * decides the new one, and no other write of the key comes in between.
+             * Parameters:
+             *   - key: key to update.
+             *   - fn: computes the new value from the current one (see UpdateFunction).
+             * Returns:
+             *   - true if fn produced a value and it was stored; false if fn left the key alone.
+             * Throws:
+             *   - Whatever fn throws; the key is then unchanged.
+             * Thread-safety:
+             *   - Locked and Combining: fn runs under the writer lock (Combining mode takes it as
+             *     Locked mode does, like MultiInsert).
+             *   - The new value replaces the one fn saw with a CAS; fn runs again whenever another
+             *     writer got there first (LockFree mode, or an Insert through the index), so it must
+             *     not have side effects.
+             * Complexity:
+             *   - Expected O(log n) time plus fn.
+             */
+            bool Update(ByteView key, const UpdateFunction& fn);
+
+            /*
+             * Store desired only if the key's value is currently equal to expected, byte for byte
+             * (or, with expected == std::nullopt, only if the key is absent).
+             * Returns:
+             *   - true if desired was stored.
+             * Thread-safety:
+             *   - As Update.
+             */
+            bool CompareAndInsert(ByteView key, std::optional<ByteView> expected, ByteView desired);
+
+            /*
+             * Insert key only if it is absent; an existing value is left as it is.
+             * Returns:
+             *   - true if the key was inserted.
+             */
+            bool InsertIfAbsent(ByteView key, ByteView value) {
+                return CompareAndInsert(key, std::nullopt, value);
+            }
+
+            /*
+             * Register the operator Merge applies, e.g. MergeAddInt64 or MergeAppend.
+             * Throws:
+             *   - std::invalid_argument if op is empty.
+             *   - std::logic_error if the list already has a merge operator.
+             * Thread-safety:
+             *   - Call before the list is shared between threads.
+             */
+            void SetMergeOperator(MergeOperator op);
+
+            /*
+             * Replace the key's value with the merge operator applied to it and operand, as one
+             * atomic step (see Update).
+             * Throws:
+             *   - std::logic_error if no merge operator is set.
+             *   - Whatever the operator throws; the key is then unchanged.
+             */
+            void Merge(ByteView key, ByteView operand);
+
+            /*
+             * Put a counting Bloom filter in front of lookups, so that most searches for absent keys
+             * return after probing one cache line instead of descending the list.
+             * Parameters:
+             *   - expectedKeys: number of keys the list is expected to hold; beyond it the
+             *     false-positive rate rises gradually.
+             *   - falsePositiveRate: share of absent keys the filter lets through to a full search,
+             *     in (0, 1); 0.01 costs about 52 bits per key.
+             * Throws:
+             *   - std::invalid_argument for a zero expectedKeys or a rate outside (0, 1).
+             *   - std::logic_error if the list is not empty or already has a filter.
+             * Thread-safety:
+             *   - Call before the list is shared between threads.
+             * Notes:
+             *   - Every write keeps the filter up to date: a key is counted in before it becomes
+             *     visible and counted out after it is removed, so the filter never hides a present key.
+             *   - Keys are hashed by their bytes, so Order::Equal must mean byte equality (true of
+             *     every policy in comparator.h).
+             *   - Search, SearchInto, Find and MultiSearch consult it; range reads do not.
+             */
+            void EnableFilter(std::size_t expectedKeys, double falsePositiveRate);
+
+            /*
+             * Outcomes of the lookups that consulted the filter (all zero without one).
+             */
+            FilterStats GetFilterStats() const;
+
+            /*
+             * Keep a hash index from keys to nodes next to the list, so that lookups of present keys
+             * and updates of existing keys take a hash probe instead of a descent.
+             * Parameters:
+             *   - expectedKeys: number of keys the list is expected to hold; the index takes
+             *     16 bytes per expected key and leaves keys beyond about twice that unindexed.
+             * Throws:
+             *   - std::invalid_argument if expectedKeys is 0.
+             *   - std::logic_error if the list is not empty or already has an index.
+             * Thread-safety:
+             *   - Call before the list is shared between threads.
+             * Notes:
+             *   - The list stays authoritative: a key the index does not hold is searched for as
+             *     usual, so misses still descend (EnableFilter answers most of those).
+             *   - Search, SearchInto, Find and Insert consult it; batched and range calls do not.
+             *   - Keys are hashed by their bytes, so Order::Equal must mean byte equality.
+             */
+            void EnableIndex(std::size_t expectedKeys);
+
+            /*
+             * Keep version chains so that OpenSnapshot can hand out consistent point-in-time views.
+             * Throws:
+             *   - std::logic_error if the list is not empty, is in LockFree mode, already has
+             *     snapshots enabled or has eviction enabled.
+             * Thread-safety:
+             *   - Call before the list is shared between threads.
+             * Notes:
+             *   - Every write is stamped with the next sequence number under the writer lock and
+             *     stores its value in a standalone versioned buffer (16 bytes of header).
+             *   - While a snapshot is open, an update keeps the replaced value reachable from the new
+             *     one and a removal stores a tombstone instead of unlinking the node. A later write
+             *     to the key drops the versions no open snapshot can still read; closing the oldest
+             *     snapshot sweeps the list for the rest in batches of 256 nodes per lock hold.
+             *   - Updates of indexed keys then go through the lock as well (see EnableIndex).
+             */
+            void EnableSnapshots();
+
+            /*
+             * Open a snapshot of the current state (see Snapshot).
+             * Throws:
+             *   - std::logic_error if snapshots are not enabled.
+             * Thread-safety:
+             *   - Takes the writer lock once, to read a sequence number no write is in the middle of;
+             *     readers and writers are not held up afterwards.
+             * Complexity:
+             *   - O(log s) for s open snapshots.
+             */
+            Snapshot OpenSnapshot() {
+                return Snapshot(*this);
+            }
+
+            /*
+             * Snapshot of the writer contention counters.
+             * Returns:
+             *   - Counters accumulated since construction (see LockStats).
+             * Thread-safety:
+             *   - Safe to call concurrently with any operation; counters are read individually.
+             */
+            LockStats GetLockStats() const;
+
+            /*
+             * Usage report: entry count, key/value/overhead bytes, tower-height histogram, search
+             * lengths and writer contention.
+             * Returns:
+             *   - ListMetrics; without TBT_METRICS only the structural fields and Lock are filled.
+             * Thread-safety:
+             *   - Safe to call concurrently with any operation; the counters are summed over
+             *     per-thread stripes, so a report taken during writes is approximate.
+             * Complexity:
+             *   - O(MaxLevel) plus a sum over 16 stripes; the list is not walked.
+             */
+            ListMetrics GetMetrics() const;
+
+            /*
+             * Let the tower limit follow the number of live entries: every few hundred writes per
+             * thread, maxLevel is set to ceil(log_{1/p} n) + 1 (at least 1, at most Node::MaxHeight),
+             * so new nodes get the levels a list of the current size needs, neither a fixed guess
+             * that is too shallow once the list has grown nor one that is wasteful for a small list.
+             * Throws:
+             *   - std::logic_error if the list already has adaptive levels.
+             * Thread-safety:
+             *   - Call before the list is shared between threads. A list that already holds
+             *     entries is walked once under the writer lock to count them.
+             * Notes:
+             *   - Only nodes written later get the new limit; RebalanceStep re-towers the others.
+             *   - Live entries are counted in 16 per-thread stripes, one relaxed add per write.
+             */
+            void EnableAdaptiveLevels();
+
+            /*
+             * One step of an online rebalance: walk the next `nodes` nodes of level 0 and re-tower
+             * those whose height differs from the evenly spaced one their rank calls for under the
+             * current maxLevel (the towers BulkLoad builds). A node is re-towered by linking a copy
+             * of it with the new height in its place; the old node stays readable for readers
+             * standing on it and is retired.
+             * Parameters:
+             *   - nodes: nodes to walk in this step; bounds how long the writer lock is held.
+             * Returns:
+             *   - true if the step finished a pass over the list; the next step starts a new one.
+             * Throws:
+             *   - std::logic_error for a LockFree list.
+             * Thread-safety:
+             *   - Holds the writer lock for the step only; reads and writes go on between steps, and
+             *     readers are never blocked. Keys written during a pass are placed by rank as found.
+             * Notes:
+             *   - With adaptive levels, the first step of a pass retunes maxLevel to the entry count.
+             * Complexity:
+             *   - O(nodes + log n), plus one node copy per re-towered node.
+             */
+            bool RebalanceStep(std::size_t nodes = 256);
+
+            /*
+             * Run RebalanceStep until a pass over the whole list is complete.
+             */
+            void Rebalance(std::size_t stepNodes = 256) {
+                while (!RebalanceStep(stepNodes)) {
+                }
+            }
+
+            /*
+             * Tower-height state and measured search depth (see LevelStats).
+             * Thread-safety:
+             *   - Safe to call concurrently with any operation; takes an epoch pin, no lock.
+             * Complexity:
+             *   - About 64 descents plus a walk of the level that holds the sample.
+             */
+            LevelStats GetLevelStats() const;
+
+            /*
+             * Bound the list's memory so that it can serve as a cache: every write charges the bytes
+             * it adds (node block with key, tower and value, or a replacing value) and, once the
+             * total exceeds budgetBytes, cold entries are removed until it is back under it.
+             * Entries are picked by CLOCK (second chance): a lookup that finds a key sets its node's
+             * reference bit, and the hand walking the keys in order clears set bits and evicts the
+             * first node whose bit is already clear.
+             * Parameters:
+             *   - budgetBytes: bytes the live entries may take up.
+             * Throws:
+             *   - std::invalid_argument if budgetBytes is 0.
+             *   - std::logic_error if eviction is already enabled or the list has snapshots.
+             * Thread-safety:
+             *   - Call before the list is shared between threads. A list that already holds
+             *     entries is walked once under the writer lock to charge them; eviction starts with
+             *     the next write.
+             * Notes:
+             *   - Lookups only set the bit (a relaxed store, skipped when already set) and count
+             *     hits and misses in per-thread stripes: reads take no lock and stay lock-free.
+             *   - The writer that pushed the total over the budget runs the hand after its own write,
+             *     outside the list lock, removing victims as Remove does; writers arriving while the
+             *     hand is taken go on without evicting. New entries start referenced, so a write is
+             *     never its own victim on the first turn.
+             *   - Search, SearchInto, Find and MultiSearch set reference bits; scans and cursors do
+             *     not, so a scan does not make every entry look hot.
+             *   - Freed bytes go back to the arena after the usual epoch delay; the budget bounds
+             *     live data, not ReservedBytes.
+             */
+            void EnableEviction(std::size_t budgetBytes);
+
+            /*
+             * Budget, charged bytes, hit/miss and eviction counters (see CacheStats).
+             * Thread-safety:
+             *   - Safe to call concurrently with any operation; counters are read individually.
+             */
+            CacheStats GetCacheStats() const;
+
+            /*
+             * Memory accounting of the list's arena (nodes, keys, values and tower pointers).
+             * Returns:
+             *   - ArenaStats of the arena backing this list.
+             * Thread-safety:
+             *   - Safe to call concurrently with any operation.
+             */
+            ArenaStats GetMemoryStats() const;
     };
 
+    using List = BasicList<>;
+
     /*
      * Validate that a probability value lies strictly between 0 and 1.
      * Parameters:
@@ -116,4 +1180,10 @@ namespace tbt{
      *   - Uses a thread-local PRNG; safe for concurrent calls from multiple threads.
      */
     bool toss(float probability);
-}
\ No newline at end of file
+}
+
+#include "skiplist_impl.h"
+
+namespace tbt {
+    extern template class BasicList<ByteOrder>;
+}
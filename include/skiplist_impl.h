@@ -0,0 +1,2047 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 24.10.2025
+ * @description: Definitions of the BasicList member templates. Included at the end of
+ * skiplist.h; the default BasicList<ByteOrder> is instantiated once in src/skiplist.cpp.
+ */
+
+#pragma once
+
+#include "skiplist.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace tbt {
+    namespace detail {
+        // The lowest bit of a forward link marks the owning node as deleted at that level.
+        inline bool isMarked(const Node* link) {
+            return (reinterpret_cast<std::uintptr_t>(link) & 1) != 0;
+        }
+
+        inline Node* marked(Node* link) {
+            return reinterpret_cast<Node*>(reinterpret_cast<std::uintptr_t>(link) | 1);
+        }
+
+        inline Node* unmarked(Node* link) {
+            return reinterpret_cast<Node*>(reinterpret_cast<std::uintptr_t>(link) & ~std::uintptr_t{1});
+        }
+
+        // Epoch deleters; the context is the owning list's Arena.
+        void deleteNode(void* object, void* context);
+        void deleteValue(void* object, void* context);
+
+        // Indices of a batch sorted by key (stable, so equal keys keep their submission order).
+        template <KeyOrder Order, typename KeyOf>
+        std::vector<std::size_t> sortedOrder(const std::size_t count, KeyOf keyOf) {
+            std::vector<std::size_t> order(count);
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::stable_sort(order.begin(), order.end(), [&](const std::size_t left, const std::size_t right) {
+                return Order::Less(keyOf(left), keyOf(right));
+            });
+            return order;
+        }
+
+        // Deterministic tower height of the rank-th node (1-based) of a bulk-loaded list: one level
+        // per factor of fanout in rank, so levels thin out exactly as they do on average at random.
+        inline std::size_t towerHeight(std::size_t rank, const std::size_t fanout, const std::size_t maxLevel) {
+            std::size_t height = 1;
+            while (height < maxLevel && rank % fanout == 0) {
+                rank /= fanout;
+                height++;
+            }
+            return height;
+        }
+
+        template <KeyOrder Order>
+        std::uint64_t keyPrefix(const ByteView key) {
+            if constexpr (PrefixedKeyOrder<Order>) {
+                return Order::Prefix(key);
+            } else {
+                return 0;
+            }
+        }
+
+        // Order a node against a search key using the cached prefix first; the key bytes are only
+        // read when the prefixes tie. prefix must be keyPrefix<Order>(key).
+        template <KeyOrder Order>
+        bool nodeBefore(const Node* node, const ByteView key, const std::uint64_t prefix) {
+            if constexpr (PrefixedKeyOrder<Order>) {
+                if (node->KeyPrefix != prefix) {
+                    return node->KeyPrefix < prefix;
+                }
+            }
+            return Order::Less(node->Key(), key);
+        }
+
+        template <KeyOrder Order>
+        bool nodeMatches(const Node* node, const ByteView key, const std::uint64_t prefix) {
+            if constexpr (PrefixedKeyOrder<Order>) {
+                // Different prefixes imply Less one way or the other, hence not equal.
+                if (node->KeyPrefix != prefix) {
+                    return false;
+                }
+            }
+            return Order::Equal(node->Key(), key);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::clear() {
+        // Nodes and values live in the arena: drop whatever still waits for reclamation, then
+        // free every chunk at once instead of walking the list.
+        epoch.ReclaimAll();
+        arena.Release();
+    }
+
+    template <KeyOrder Order>
+    std::size_t BasicList<Order>::randomLevel() const {
+        const std::size_t limit = maxLevel.load(std::memory_order_relaxed);
+        std::size_t newLevel = 0;
+        while ((newLevel + 1) < limit && toss(probability)) {
+            newLevel++;
+        }
+        return newLevel;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::raiseLevel(const std::size_t level) {
+        std::size_t observed = currentLevel.load(std::memory_order_relaxed);
+        while (observed < level && !currentLevel.compare_exchange_weak(observed, level, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::retireValue(ValueBuffer* value) {
+        // The value written at insertion lives inside the node block and goes away with it.
+        if (value != nullptr && !value->Inline) {
+            epoch.Retire(value, &detail::deleteValue, &arena);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::noteLinked(const Node* node, const std::size_t valueBytes) {
+        // The value size comes from the caller: once linked, the node's value may already be replaced.
+        static_assert(Node::MaxHeight <= MetricTotals::MaxHeights);
+        if constexpr (MetricsEnabled) {
+            metrics->Linked(node->Height, node->Key().size(), valueBytes);
+        }
+        if (entryCounts != nullptr) {
+            countEntries(1);
+        }
+        if (lookupCounts != nullptr) {
+            chargedBytes.fetch_add(static_cast<std::int64_t>(node->AllocationSize()), std::memory_order_relaxed);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::noteUnlinked(const Node* node, const ValueBuffer* value) {
+        if constexpr (MetricsEnabled) {
+            metrics->Unlinked(node->Height, node->Key().size(), value->Size);
+        }
+        if (entryCounts != nullptr) {
+            countEntries(-1);
+        }
+        if (lookupCounts != nullptr) {
+            // The value written at insertion is part of the node block.
+            const std::size_t standalone = value->Inline ? 0 : value->AllocationSize();
+            chargedBytes.fetch_sub(static_cast<std::int64_t>(node->AllocationSize() + standalone), std::memory_order_relaxed);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::noteReplaced(const ValueBuffer* old, const std::size_t newBytes) {
+        if constexpr (MetricsEnabled) {
+            metrics->Replaced(old->Size, newBytes);
+        }
+        if (lookupCounts != nullptr) {
+            // A replacing value is always standalone; an inline one stays charged with its node.
+            const std::size_t released = old->Inline ? 0 : old->AllocationSize();
+            chargedBytes.fetch_add(static_cast<std::int64_t>(sizeof(ValueBuffer) + newBytes) - static_cast<std::int64_t>(released), std::memory_order_relaxed);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::noteLookup(const Node* node) const {
+        LookupStripe& stripe = lookupCounts[ThreadIndex() % LookupStripes];
+        if (node == nullptr) {
+            stripe.Misses.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        stripe.Hits.fetch_add(1, std::memory_order_relaxed);
+        // Hot keys are looked up over and over: skip the store, and the cache line it would
+        // take from other readers, while the bit is still set.
+        if (node->Referenced.load(std::memory_order_relaxed) == 0) {
+            node->Referenced.store(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <KeyOrder Order>
+    BasicList<Order>::BasicList(const std::size_t maxLevel, const float probability, const Concurrency concurrency) {
+        if (!checkProbability(probability)) {
+            throw std::invalid_argument("probability must be between 0 and 1");
+        }
+        if (maxLevel > Node::MaxHeight) {
+            throw std::invalid_argument("maxLevel exceeds the node height limit");
+        }
+
+        // The head gets every level a node can have, so that maxLevel can grow later.
+        head = Node::Create(arena, ByteView(), 0, ByteView(), Node::MaxHeight);
+        head->Value.store(nullptr, std::memory_order_relaxed);
+        this->maxLevel.store(maxLevel, std::memory_order_relaxed);
+        this->currentLevel = 0;
+        this->probability = probability;
+        this->concurrency = concurrency;
+        if (concurrency == Concurrency::Combining) {
+            slots = std::make_unique<CombiningSlot[]>(CombiningSlots);
+        }
+        if constexpr (MetricsEnabled) {
+            metrics = std::make_unique<MetricCounters>();
+        }
+    }
+
+    template <KeyOrder Order>
+    BasicList<Order>::~BasicList() {
+        std::unique_lock<std::shared_mutex> lock(mux);
+        clear();
+    }
+
+    template <KeyOrder Order>
+    Node* BasicList<Order>::findNode(const ByteView key) const {
+        std::size_t visited = 0;
+        Node* found = findCounting(key, visited);
+        if constexpr (MetricsEnabled) {
+            metrics->Searched(visited);
+        }
+        return found;
+    }
+
+    template <KeyOrder Order>
+    Node* BasicList<Order>::findCounting(const ByteView key, std::size_t& visited) const {
+        // Read-only traversal: nodes whose link at the current level is marked are stepped over,
+        // never unlinked, so readers do not write shared memory.
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        Node* pred = head;
+        Node* current = nullptr;
+        for (std::size_t i = currentLevel.load(std::memory_order_acquire) + 1; i-- > 0;) {
+            current = detail::unmarked(pred->Forward(i).load(std::memory_order_acquire));
+            while (current != nullptr) {
+                Node* next = current->Forward(i).load(std::memory_order_acquire);
+                if (detail::isMarked(next)) {
+                    current = detail::unmarked(next);
+                    continue;
+                }
+                visited++;
+                if (!detail::nodeBefore<Order>(current, key, keyPrefix)) {
+                    break;
+                }
+                pred = current;
+                current = next;
+            }
+        }
+        if (current != nullptr && detail::nodeMatches<Order>(current, key, keyPrefix)) {
+            return current;
+        }
+        return nullptr;
+    }
+
+    template <KeyOrder Order>
+    template <typename Before>
+    const Node* BasicList<Order>::descend(Before before) const {
+        // Same read-only traversal as findNode: returns the last node for which before(node)
+        // holds, or head when there is none.
+        const Node* pred = head;
+        for (std::size_t i = currentLevel.load(std::memory_order_acquire) + 1; i-- > 0;) {
+            Node* current = detail::unmarked(pred->Forward(i).load(std::memory_order_acquire));
+            while (current != nullptr) {
+                Node* next = current->Forward(i).load(std::memory_order_acquire);
+                if (detail::isMarked(next)) {
+                    current = detail::unmarked(next);
+                    continue;
+                }
+                if (!before(current)) {
+                    break;
+                }
+                pred = current;
+                current = next;
+            }
+        }
+        return pred;
+    }
+
+    template <KeyOrder Order>
+    const Node* BasicList<Order>::seekNode(const ByteView key, const bool inclusive) const {
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        const Node* pred = inclusive
+            ? descend([&](const Node* node) { return detail::nodeBefore<Order>(node, key, keyPrefix); })
+            : descend([&](const Node* node) { return !Order::Less(key, node->Key()); });
+        return nextNode(pred);
+    }
+
+    template <KeyOrder Order>
+    const Node* BasicList<Order>::lastBefore(const ByteView key, const bool bounded) const {
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        const Node* pred = bounded
+            ? descend([&](const Node* node) { return detail::nodeBefore<Order>(node, key, keyPrefix); })
+            : descend([](const Node*) { return true; });
+        return pred == head ? nullptr : pred;
+    }
+
+    template <KeyOrder Order>
+    const Node* BasicList<Order>::nextNode(const Node* node) {
+        // A marked link still leads forward; the nodes it reaches stay readable under the pin.
+        return detail::unmarked(node->Forward(0).load(std::memory_order_acquire));
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::appendEntry(std::vector<Entry>& out, const Node* node) {
+        // Nodes with a null value are removed (or being removed) and are skipped, as are tombstones.
+        if (const ValueBuffer* value = node->Value.load(std::memory_order_acquire); value != nullptr && !value->Tombstone) {
+            const ByteView key = node->Key();
+            out.push_back({ByteVector(key.begin(), key.end()), ByteVector(value->View().begin(), value->View().end())});
+        }
+    }
+
+    template <KeyOrder Order>
+    Node* BasicList<Order>::fingerSeek(const ByteView key, const std::uint64_t keyPrefix, const std::span<Node*> path) const {
+        // path[i] is a node before key at level i (or head), typically the predecessors of the
+        // previous, smaller key. Climb while the finger's successor is still before key, then
+        // descend from there; the path is updated to the predecessors of key.
+        const std::size_t top = path.size() - 1;
+        std::size_t level = 0;
+        while (true) {
+            Node* next = path[level]->Forward(level).load(std::memory_order_acquire);
+            if (detail::isMarked(next)) {
+                // The finger is being removed: links after it may miss newer nodes, start over.
+                std::fill(path.begin(), path.end(), head);
+                level = top;
+                break;
+            }
+            if (level == top || next == nullptr || !detail::nodeBefore<Order>(next, key, keyPrefix)) {
+                break;
+            }
+            level++;
+        }
+
+        Node* pred = path[level];
+        Node* current = nullptr;
+        for (std::size_t i = level + 1; i-- > 0;) {
+            current = detail::unmarked(pred->Forward(i).load(std::memory_order_acquire));
+            while (current != nullptr) {
+                Node* next = current->Forward(i).load(std::memory_order_acquire);
+                if (detail::isMarked(next)) {
+                    current = detail::unmarked(next);
+                    continue;
+                }
+                if (!detail::nodeBefore<Order>(current, key, keyPrefix)) {
+                    break;
+                }
+                pred = current;
+                current = next;
+            }
+            path[i] = pred;
+        }
+        return current;
+    }
+
+    template <KeyOrder Order>
+    std::vector<std::optional<ByteVector>> BasicList<Order>::MultiSearch(const std::span<const ByteView> keys) const {
+        std::vector<std::optional<ByteVector>> out(keys.size());
+        const std::vector<std::size_t> order = detail::sortedOrder<Order>(keys.size(), [&](const std::size_t i) { return keys[i]; });
+
+        EpochGuard guard(epoch);
+        Path path;
+        const std::span<Node*> levels(path.data(), currentLevel.load(std::memory_order_acquire) + 1);
+        std::fill(levels.begin(), levels.end(), head);
+        for (const std::size_t index : order) {
+            const ByteView key = keys[index];
+            const bool passed = filter == nullptr || filter->MayContain(ByteVectorHash(key));
+            const Node* found = nullptr;
+            if (passed) {
+                // A key the filter rules out leaves the finger where it is.
+                const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+                const Node* node = fingerSeek(key, keyPrefix, levels);
+                if (node != nullptr && detail::nodeMatches<Order>(node, key, keyPrefix)) {
+                    if (const ValueBuffer* value = node->Value.load(std::memory_order_acquire); value != nullptr && !value->Tombstone) {
+                        out[index].emplace(value->View().begin(), value->View().end());
+                        found = node;
+                    }
+                }
+            }
+            if (filter != nullptr) {
+                filter->RecordLookup(passed, out[index].has_value());
+            }
+            if (lookupCounts != nullptr) {
+                noteLookup(found);
+            }
+        }
+        return out;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::MultiInsert(const std::span<const std::pair<ByteView, ByteView>> entries) {
+        std::vector<std::size_t> order = detail::sortedOrder<Order>(entries.size(), [&](const std::size_t i) { return entries[i].first; });
+        // Keep the last occurrence of each key, as sequential inserts would.
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < order.size(); i++) {
+            if (i + 1 < order.size() && Order::Equal(entries[order[i]].first, entries[order[i + 1]].first)) {
+                continue;
+            }
+            order[kept++] = order[i];
+        }
+        order.resize(kept);
+
+        if (concurrency == Concurrency::LockFree) {
+            for (const std::size_t index : order) {
+                const auto& [key, value] = entries[index];
+                if (filter == nullptr) {
+                    insertLockFree(key, value);
+                    continue;
+                }
+                // Counted in key by key as by Insert, so a throw leaves no count for the keys it never reached.
+                const std::uint64_t hash = ByteVectorHash(key);
+                filter->Add(hash);
+                bool created = false;
+                try {
+                    created = insertLockFree(key, value);
+                } catch (...) {
+                    filter->Remove(hash);
+                    throw;
+                }
+                if (!created) {
+                    filter->Remove(hash);
+                }
+            }
+        } else {
+            multiInsertLocked(entries, order);
+        }
+        if (lookupCounts != nullptr) {
+            evictOverBudget(); // once for the batch, after the lock is released
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::multiInsertLocked(const std::span<const std::pair<ByteView, ByteView>> entries, const std::span<const std::size_t> order) {
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+
+        Path path;
+        std::size_t pathTop = currentLevel.load(std::memory_order_relaxed);
+        std::fill(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(pathTop) + 1, head);
+        for (const std::size_t index : order) {
+            const auto& [key, value] = entries[index];
+            const std::size_t newLevel = randomLevel();
+            raiseLevel(newLevel);
+            while (pathTop < currentLevel.load(std::memory_order_relaxed)) {
+                path[++pathTop] = head;
+            }
+
+            const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+            Node* next = fingerSeek(key, keyPrefix, std::span<Node*>(path.data(), pathTop + 1));
+            // Counted in before the node (or a revived value) can be seen, and back out unless a
+            // key was created; keys after one that throws are never counted.
+            const std::uint64_t hash = filter != nullptr ? ByteVectorHash(key) : 0;
+            if (filter != nullptr) {
+                filter->Add(hash);
+            }
+            bool created = false;
+            try {
+                if (next == nullptr || !detail::nodeMatches<Order>(next, key, keyPrefix)) {
+                    Node* newNode = createNode(key, keyPrefix, value, newLevel + 1);
+                    for (std::size_t i = 0; i <= newLevel; i++) {
+                        newNode->Forward(i).store(path[i]->Forward(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        path[i]->Forward(i).store(newNode, std::memory_order_release);
+                        path[i] = newNode; // the next key is larger: the new node is its closest finger
+                    }
+                    created = true; // linked: the count stays even if the bookkeeping below throws
+                    publishVersion();
+                    indexNode(newNode);
+                    noteLinked(newNode, value.size());
+                } else {
+                    created = replaceLocked(next, value);
+                }
+            } catch (...) {
+                if (filter != nullptr && !created) {
+                    filter->Remove(hash);
+                }
+                throw;
+            }
+            if (filter != nullptr && !created) {
+                filter->Remove(hash);
+            }
+        }
+    }
+
+    template <KeyOrder Order>
+    template <std::ranges::random_access_range Entries>
+        requires std::convertible_to<std::ranges::range_reference_t<Entries>, std::pair<ByteView, ByteView>>
+    void BasicList<Order>::BulkLoad(const Entries& entries, const std::size_t threads) {
+        const auto first = std::ranges::begin(entries);
+        const std::size_t count = static_cast<std::size_t>(std::ranges::distance(entries));
+        auto entryAt = [&](const std::size_t i) -> std::pair<ByteView, ByteView> {
+            return first[static_cast<std::ranges::range_difference_t<Entries>>(i)];
+        };
+        for (std::size_t i = 1; i < count; i++) {
+            if (Order::Less(entryAt(i).first, entryAt(i - 1).first)) {
+                throw std::invalid_argument("BulkLoad input is not sorted by key");
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        if (head->Forward(0).load(std::memory_order_acquire) != nullptr) {
+            throw std::logic_error("BulkLoad requires an empty list");
+        }
+
+        // Every slice links its nodes among themselves and remembers both ends of each level;
+        // the slices are then chained behind head in order. Heights depend only on the input
+        // position, so slices need no coordination.
+        struct Slice {
+            Path first{};
+            Path last{};
+            std::exception_ptr error;
+        };
+        const std::size_t fanout = std::max<std::size_t>(2, static_cast<std::size_t>(std::lround(1.0 / probability)));
+        const std::size_t levels = maxLevel.load(std::memory_order_relaxed);
+        constexpr std::size_t MinSlice = 4096;
+        const std::size_t workers = std::clamp<std::size_t>(count / MinSlice, 1, std::max<std::size_t>(threads, 1));
+        std::vector<Slice> slices(workers);
+
+        auto build = [&](Slice& slice, const std::size_t begin, const std::size_t end) {
+            try {
+                for (std::size_t i = begin; i < end; i++) {
+                    const auto [key, value] = entryAt(i);
+                    if (i + 1 < count && Order::Equal(key, entryAt(i + 1).first)) {
+                        continue;
+                    }
+                    const std::size_t height = detail::towerHeight(i + 1, fanout, levels);
+                    Node* node = createNode(key, detail::keyPrefix<Order>(key), value, height);
+                    for (std::size_t level = 0; level < height; level++) {
+                        if (slice.last[level] == nullptr) {
+                            slice.first[level] = node;
+                        } else {
+                            slice.last[level]->Forward(level).store(node, std::memory_order_relaxed);
+                        }
+                        slice.last[level] = node;
+                    }
+                }
+            } catch (...) {
+                slice.error = std::current_exception();
+            }
+        };
+        {
+            std::vector<std::jthread> pool;
+            pool.reserve(workers - 1);
+            for (std::size_t t = 1; t < workers; t++) {
+                pool.emplace_back(build, std::ref(slices[t]), count * t / workers, count * (t + 1) / workers);
+            }
+            build(slices[0], 0, count / workers);
+        }
+        for (const Slice& slice : slices) {
+            if (slice.error) {
+                // Nodes built so far are unreachable and go back with the arena.
+                std::rethrow_exception(slice.error);
+            }
+        }
+
+        // Counted only once every slice is built, so a failed load leaves no counts for unreachable
+        // nodes, and still before the slices are linked, so no reader finds a node the filter rules out.
+        if (filter != nullptr) {
+            for (const Slice& slice : slices) {
+                for (Node* node = slice.first[0]; node != nullptr; node = node == slice.last[0] ? nullptr : node->Forward(0).load(std::memory_order_relaxed)) {
+                    filter->Add(ByteVectorHash(node->Key()));
+                }
+            }
+        }
+
+        Path tail;
+        tail.fill(head);
+        std::size_t topLevel = 0;
+        for (const Slice& slice : slices) {
+            for (std::size_t level = 0; level < levels && slice.first[level] != nullptr; level++) {
+                tail[level]->Forward(level).store(slice.first[level], std::memory_order_release);
+                tail[level] = slice.last[level];
+                topLevel = std::max(topLevel, level);
+            }
+        }
+        raiseLevel(topLevel);
+        publishVersion(); // the whole load is one write
+        // Indexed and counted only once linked: a failed load must not leave entries for unreachable nodes.
+        if (index != nullptr || metrics != nullptr || lookupCounts != nullptr) {
+            for (Node* node = head->Forward(0).load(std::memory_order_relaxed); node != nullptr; node = node->Forward(0).load(std::memory_order_relaxed)) {
+                indexNode(node);
+                noteLinked(node, node->Value.load(std::memory_order_relaxed)->Size);
+            }
+        }
+        lock.unlock();
+        if (lookupCounts != nullptr) {
+            evictOverBudget();
+        }
+    }
+
+    template <KeyOrder Order>
+    std::vector<Entry> BasicList<Order>::Scan(const ByteView begin, const ByteView end, const std::size_t limit) const {
+        std::vector<Entry> out;
+        EpochGuard guard(epoch);
+        // Empty bounds mean "unbounded" rather than the empty key, which is not the smallest key
+        // under every order.
+        for (const Node* node = begin.empty() ? nextNode(head) : seekNode(begin, true); node != nullptr && out.size() < limit; node = nextNode(node)) {
+            if (!end.empty() && !Order::Less(node->Key(), end)) {
+                break;
+            }
+            appendEntry(out, node);
+        }
+        return out;
+    }
+
+    template <KeyOrder Order>
+    std::vector<Entry> BasicList<Order>::ScanPrefix(const ByteView prefix, const std::size_t limit) const
+        requires std::same_as<Order, ByteOrder> {
+        // Keys starting with prefix are exactly [prefix, successor): drop trailing 0xFF bytes and
+        // increment the last remaining one. An all-0xFF prefix has no successor.
+        ByteVector successor(prefix.begin(), prefix.end());
+        while (!successor.empty() && successor.back() == 0xFF) {
+            successor.pop_back();
+        }
+        if (!successor.empty()) {
+            successor.back()++;
+        }
+        return Scan(prefix, successor, limit);
+    }
+
+    template <KeyOrder Order>
+    std::optional<Entry> BasicList<Order>::LowerBound(const ByteView key) const {
+        std::vector<Entry> found = Scan(key, {}, 1);
+        if (found.empty()) {
+            return std::nullopt;
+        }
+        return std::move(found.front());
+    }
+
+    template <KeyOrder Order>
+    BasicList<Order>::Cursor::Cursor(const BasicList& list, const ByteView begin, const ByteView end, const ScanOrder order)
+        : list(&list), lower(begin.begin(), begin.end()), upper(end.begin(), end.end()), order(order) {
+        batch.reserve(BatchSize);
+        refill();
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::Cursor::Next() {
+        if (++position >= batch.size() && !exhausted) {
+            refill();
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::Cursor::refill() {
+        batch.clear();
+        position = 0;
+        EpochGuard guard(list->epoch);
+
+        const Node* node = nullptr;
+        if (order == ScanOrder::Ascending) {
+            if (started) {
+                node = list->seekNode(resume, false);
+            } else {
+                node = lower.empty() ? nextNode(list->head) : list->seekNode(lower, true);
+            }
+            for (; node != nullptr && batch.size() < BatchSize; node = nextNode(node)) {
+                if (!upper.empty() && !Order::Less(node->Key(), upper)) {
+                    node = nullptr;
+                    break;
+                }
+                appendEntry(batch, node);
+            }
+        } else {
+            node = started ? list->lastBefore(resume, true) : list->lastBefore(upper, !upper.empty());
+            for (; node != nullptr && batch.size() < BatchSize; node = list->lastBefore(node->Key(), true)) {
+                if (!lower.empty() && Order::Less(node->Key(), lower)) {
+                    node = nullptr;
+                    break;
+                }
+                appendEntry(batch, node);
+            }
+        }
+
+        started = true;
+        exhausted = node == nullptr;
+        if (!batch.empty()) {
+            resume = batch.back().Key;
+        }
+    }
+
+    template <KeyOrder Order>
+    ValueView BasicList<Order>::Find(const ByteView key) const {
+        const std::uint64_t hash = filter != nullptr || index != nullptr ? ByteVectorHash(key) : 0;
+        if (filter != nullptr && !filter->MayContain(hash)) {
+            filter->RecordLookup(false, false);
+            if (lookupCounts != nullptr) {
+                noteLookup(nullptr);
+            }
+            return {};
+        }
+        // The pin taken here is handed over to the view, which releases it on destruction.
+        epoch.Enter();
+        const Node* node = index != nullptr ? index->Find(hash, key) : nullptr;
+        const ValueBuffer* value = node != nullptr ? node->Value.load(std::memory_order_acquire) : nullptr;
+        if (value == nullptr || value->Tombstone) {
+            // Not indexed, or the indexed node was just removed: the list decides.
+            node = findNode(key);
+            value = node != nullptr ? node->Value.load(std::memory_order_acquire) : nullptr;
+            if (value != nullptr && value->Tombstone) {
+                value = nullptr;
+            }
+        } else if constexpr (MetricsEnabled) {
+            metrics->Searched(0);
+        }
+        if (filter != nullptr) {
+            filter->RecordLookup(true, value != nullptr);
+        }
+        if (lookupCounts != nullptr) {
+            noteLookup(value != nullptr ? node : nullptr);
+        }
+        if (value == nullptr) {
+            epoch.Exit();
+            return {};
+        }
+        return ValueView(epoch, value->View());
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::SearchInto(const ByteView key, ByteVector &out) const {
+        const ValueView value = Find(key);
+        out.assign(value.View().begin(), value.View().end());
+        return static_cast<bool>(value);
+    }
+
+    template <KeyOrder Order>
+    ByteVector BasicList<Order>::Search(const ByteView key) const {
+        ByteVector out;
+        SearchInto(key, out);
+        return out;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::Insert(const ByteView key, const ByteView value) {
+        const std::uint64_t hash = filter != nullptr || index != nullptr ? ByteVectorHash(key) : 0;
+        if (index != nullptr && !versioned && updateIndexed(hash, key, value)) {
+            if (lookupCounts != nullptr) {
+                evictOverBudget(); // the new value may be the larger one
+            }
+            return;
+        }
+        auto insert = [&]() {
+            switch (concurrency) {
+                case Concurrency::LockFree: return insertLockFree(key, value);
+                case Concurrency::Combining: return combine(false, key, value);
+                default: return insertLocked(key, value);
+            }
+        };
+        if (filter == nullptr) {
+            insert();
+        } else {
+            // Counted in before the node can be seen; an update was counted when the key was created.
+            filter->Add(hash);
+            bool created = false;
+            try {
+                created = insert();
+            } catch (...) {
+                filter->Remove(hash);
+                throw;
+            }
+            if (!created) {
+                filter->Remove(hash);
+            }
+        }
+        if (lookupCounts != nullptr) {
+            evictOverBudget();
+        }
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::Remove(const ByteView key) {
+        const bool removed = concurrency == Concurrency::LockFree ? removeLockFree(key)
+                           : concurrency == Concurrency::Combining ? combine(true, key, ByteView())
+                           : removeLocked(key);
+        if (removed && filter != nullptr) {
+            filter->Remove(ByteVectorHash(key));
+        }
+        return removed;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::rewrite(const ByteView key, const Rewrite& compute) {
+        auto apply = [&]() {
+            return concurrency == Concurrency::LockFree ? rewriteLockFree(key, compute) : rewriteLocked(key, compute);
+        };
+        Rewritten outcome = Rewritten::Unchanged;
+        if (filter == nullptr) {
+            outcome = apply();
+        } else {
+            // Counted in up front as by Insert, and back out unless a key was created.
+            const std::uint64_t hash = ByteVectorHash(key);
+            filter->Add(hash);
+            try {
+                outcome = apply();
+            } catch (...) {
+                filter->Remove(hash);
+                throw;
+            }
+            if (outcome != Rewritten::Created) {
+                filter->Remove(hash);
+            }
+        }
+        if (outcome != Rewritten::Unchanged && lookupCounts != nullptr) {
+            evictOverBudget();
+        }
+        return outcome != Rewritten::Unchanged;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::Update(const ByteView key, const UpdateFunction& fn) {
+        return rewrite(key, [&](const std::optional<ByteView> current, ByteVector& scratch) -> std::optional<ByteView> {
+            if (!fn(current, scratch)) {
+                return std::nullopt;
+            }
+            return ByteView(scratch);
+        });
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::CompareAndInsert(const ByteView key, const std::optional<ByteView> expected, const ByteView desired) {
+        return rewrite(key, [&](const std::optional<ByteView> current, ByteVector&) -> std::optional<ByteView> {
+            const bool matches = expected.has_value() ? current.has_value() && std::ranges::equal(*current, *expected) : !current.has_value();
+            if (!matches) {
+                return std::nullopt;
+            }
+            return desired;
+        });
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::SetMergeOperator(MergeOperator op) {
+        if (!op) {
+            throw std::invalid_argument("merge operator must not be empty");
+        }
+        if (mergeOperator) {
+            throw std::logic_error("the list already has a merge operator");
+        }
+        mergeOperator = std::move(op);
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::Merge(const ByteView key, const ByteView operand) {
+        if (!mergeOperator) {
+            throw std::logic_error("no merge operator is set on this list");
+        }
+        rewrite(key, [&](const std::optional<ByteView> current, ByteVector& scratch) -> std::optional<ByteView> {
+            mergeOperator(current, operand, scratch);
+            return ByteView(scratch);
+        });
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::EnableFilter(const std::size_t expectedKeys, const double falsePositiveRate) {
+        auto created = std::make_unique<CountingBloomFilter>(expectedKeys, falsePositiveRate);
+        if (filter != nullptr) {
+            throw std::logic_error("the list already has a filter");
+        }
+        if (head->Forward(0).load(std::memory_order_acquire) != nullptr) {
+            throw std::logic_error("a filter can only be enabled on an empty list");
+        }
+        filter = std::move(created);
+    }
+
+    template <KeyOrder Order>
+    FilterStats BasicList<Order>::GetFilterStats() const {
+        return filter != nullptr ? filter->Stats() : FilterStats{};
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::EnableIndex(const std::size_t expectedKeys) {
+        auto created = std::make_unique<HashIndex>(expectedKeys);
+        if (index != nullptr) {
+            throw std::logic_error("the list already has an index");
+        }
+        if (head->Forward(0).load(std::memory_order_acquire) != nullptr) {
+            throw std::logic_error("an index can only be enabled on an empty list");
+        }
+        index = std::move(created);
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::indexNode(Node* node) {
+        if (index != nullptr) {
+            index->Store(ByteVectorHash(node->Key()), node);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::unindexNode(const Node* node) {
+        // Before the node is retired: a reader pinned later must not find it through the index.
+        if (index != nullptr) {
+            index->Erase(ByteVectorHash(node->Key()), node);
+        }
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::updateIndexed(const std::uint64_t hash, const ByteView key, const ByteView value) {
+        // Same value swap as the update branch of the insert paths, minus the search: the node is
+        // live as long as its value is not null.
+        EpochGuard guard(epoch);
+        Node* node = index->Find(hash, key);
+        if (node == nullptr) {
+            return false;
+        }
+        // A frozen value belongs to a node that rebalancing replaced: the lock path finds the copy.
+        ValueBuffer* current = node->Value.load(std::memory_order_acquire);
+        if (current == nullptr || current->Frozen) {
+            return false;
+        }
+        ValueBuffer* buffer = ValueBuffer::Create(arena, value);
+        while (current != nullptr && !current->Frozen && !node->Value.compare_exchange_weak(current, buffer, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        }
+        if (current == nullptr || current->Frozen) {
+            arena.Free(buffer, buffer->AllocationSize()); // never published; removed or moved meanwhile
+            return false;
+        }
+        noteReplaced(current, value.size());
+        retireValue(current);
+        return true;
+    }
+
+    template <KeyOrder Order>
+    std::unique_lock<std::shared_mutex> BasicList<Order>::lockExclusive() {
+        // Counters are only written while the lock is held, so plain load/store is enough.
+        std::unique_lock<std::shared_mutex> lock(mux, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            const auto start = std::chrono::steady_clock::now();
+            lock.lock();
+            const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            contendedWrites.store(contendedWrites.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            waitNanoseconds.store(waitNanoseconds.load(std::memory_order_relaxed) + static_cast<std::uint64_t>(waited.count()), std::memory_order_relaxed);
+        }
+        exclusiveAcquisitions.store(exclusiveAcquisitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return lock;
+    }
+
+    template <KeyOrder Order>
+    std::unique_lock<std::shared_mutex> BasicList<Order>::tryLockExclusive() {
+        std::unique_lock<std::shared_mutex> lock(mux, std::try_to_lock);
+        if (lock.owns_lock()) {
+            exclusiveAcquisitions.store(exclusiveAcquisitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        return lock;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::countLostRace() const {
+        contendedWrites.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <KeyOrder Order>
+    ArenaStats BasicList<Order>::GetMemoryStats() const {
+        return arena.Stats();
+    }
+
+    template <KeyOrder Order>
+    LockStats BasicList<Order>::GetLockStats() const {
+        return {
+            exclusiveAcquisitions.load(std::memory_order_relaxed),
+            contendedWrites.load(std::memory_order_relaxed),
+            waitNanoseconds.load(std::memory_order_relaxed),
+            combinedWrites.load(std::memory_order_relaxed)
+        };
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::EnableAdaptiveLevels() {
+        if (entryCounts != nullptr) {
+            throw std::logic_error("the list already has adaptive levels");
+        }
+        // A list that outgrew its limit is counted once; writes keep the count from then on.
+        auto counts = std::make_unique<EntryStripe[]>(EntryStripes);
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+        std::int64_t entries = 0;
+        for (const Node* node = nextNode(head); node != nullptr; node = nextNode(node)) {
+            const ValueBuffer* value = node->Value.load(std::memory_order_acquire);
+            entries += value != nullptr && !value->Tombstone ? 1 : 0;
+        }
+        counts[0].Entries.store(entries, std::memory_order_relaxed);
+        entryCounts = std::move(counts);
+        retuneLevels();
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::countEntries(const std::int64_t delta) {
+        EntryStripe& stripe = entryCounts[ThreadIndex() % EntryStripes];
+        stripe.Entries.fetch_add(delta, std::memory_order_relaxed);
+        if (stripe.Writes.fetch_add(1, std::memory_order_relaxed) % RetuneInterval == 0) {
+            retuneLevels();
+        }
+    }
+
+    template <KeyOrder Order>
+    std::int64_t BasicList<Order>::liveEntries() const {
+        // Stripes are read one by one, so a sum taken during removals may dip below 0.
+        std::int64_t entries = 0;
+        for (std::size_t i = 0; i < EntryStripes; i++) {
+            entries += entryCounts[i].Entries.load(std::memory_order_relaxed);
+        }
+        return std::max<std::int64_t>(entries, 0);
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::retuneLevels() {
+        // Same rule as ListMetrics::SuggestedMaxLevel: ceil(log_{1/p} n) + 1 levels.
+        const auto entries = static_cast<double>(liveEntries());
+        const double levels = entries > 1.0 ? std::ceil(std::log(entries) / std::log(1.0 / static_cast<double>(probability))) : 0.0;
+        maxLevel.store(std::clamp<std::size_t>(static_cast<std::size_t>(levels) + 1, 1, Node::MaxHeight), std::memory_order_relaxed);
+    }
+
+    template <KeyOrder Order>
+    Node* BasicList<Order>::relocateLocked(Node* node, const std::size_t height, const std::span<Node*> preds) {
+        // Link a copy with the new tower in place of node. The old node keeps its links, so a
+        // reader standing on it still moves forward correctly, and it is only retired.
+        ValueBuffer* value = node->Value.load(std::memory_order_acquire);
+        Node* copy = nullptr;
+        ValueBuffer* frozen = nullptr;
+        if (versioned) {
+            // Versions are standalone buffers: the copy takes over the chain, the old node shares it.
+            copy = Node::Create(arena, node->Key(), node->KeyPrefix, ByteView(), height);
+            copy->Value.store(value, std::memory_order_relaxed);
+        } else {
+            if (index != nullptr) {
+                // Insert may swap an indexed node's value without the lock. Freezing it with an
+                // equal copy that the fast path refuses makes value final before it is copied.
+                while (true) {
+                    frozen = ValueBuffer::Create(arena, value->View());
+                    frozen->Frozen = true;
+                    if (node->Value.compare_exchange_strong(value, frozen, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        break;
+                    }
+                    arena.Free(frozen, frozen->AllocationSize()); // never published
+                }
+            }
+            copy = Node::Create(arena, node->Key(), node->KeyPrefix, value->View(), height);
+        }
+
+        const std::size_t shared = std::min<std::size_t>(node->Height, height);
+        for (std::size_t i = 0; i < height; i++) {
+            Node* next = i < shared ? node->Forward(i).load(std::memory_order_relaxed) : preds[i]->Forward(i).load(std::memory_order_relaxed);
+            copy->Forward(i).store(next, std::memory_order_relaxed);
+        }
+        raiseLevel(height - 1);
+        for (std::size_t i = 0; i < height; i++) {
+            preds[i]->Forward(i).store(copy, std::memory_order_release);
+        }
+        for (std::size_t i = height; i < node->Height; i++) {
+            preds[i]->Forward(i).store(node->Forward(i).load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        copy->Referenced.store(node->Referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        indexNode(copy); // replaces the entry of node
+        noteUnlinked(node, value);
+        noteLinked(copy, value->Size);
+
+        if (!versioned) {
+            retireValue(frozen != nullptr ? value : nullptr);
+            retireValue(node->Value.load(std::memory_order_relaxed)); // value or frozen, freed with node
+        }
+        epoch.Retire(node, &detail::deleteNode, &arena);
+        relocatedNodes.fetch_add(1, std::memory_order_relaxed);
+        return copy;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::RebalanceStep(const std::size_t nodes) {
+        if (concurrency == Concurrency::LockFree) {
+            throw std::logic_error("rebalancing needs a Locked or Combining list");
+        }
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+
+        if (rebalanceRank == 0 && entryCounts != nullptr) {
+            retuneLevels(); // a pass starts from the limit of the current size
+        }
+        const std::size_t levels = maxLevel.load(std::memory_order_relaxed);
+        const std::size_t fanout = std::max<std::size_t>(2, static_cast<std::size_t>(std::lround(1.0 / probability)));
+        Path preds;
+        preds.fill(head);
+        Node* node = head->Forward(0).load(std::memory_order_relaxed);
+        if (rebalanceRank > 0) {
+            // Resume after the last key of the previous step, wherever it went since.
+            node = searchLocked(rebalanceResume, preds);
+            if (node != nullptr) {
+                for (std::size_t i = 0; i < node->Height; i++) {
+                    preds[i] = node;
+                }
+            }
+            node = preds[0]->Forward(0).load(std::memory_order_relaxed);
+        }
+
+        for (std::size_t visited = 0; node != nullptr && visited < std::max<std::size_t>(nodes, 1); visited++) {
+            Node* next = node->Forward(0).load(std::memory_order_relaxed);
+            const std::size_t height = detail::towerHeight(++rebalanceRank, fanout, levels);
+            // Tombstones are left alone: the snapshot sweep unlinks them.
+            const ValueBuffer* value = node->Value.load(std::memory_order_acquire); // Insert may swap it through the index
+            if (node->Height != height && !value->Tombstone) {
+                node = relocateLocked(node, height, preds);
+            }
+            for (std::size_t i = 0; i < node->Height; i++) {
+                preds[i] = node;
+            }
+            const ByteView key = node->Key();
+            rebalanceResume.assign(key.begin(), key.end());
+            node = next;
+        }
+        if (node != nullptr) {
+            return false;
+        }
+        rebalanceRank = 0;
+        rebalanceResume.clear();
+        shrinkLevel();
+        rebalancePasses.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::EnableEviction(const std::size_t budgetBytes) {
+        if (budgetBytes == 0) {
+            throw std::invalid_argument("eviction budget must be positive");
+        }
+        if (lookupCounts != nullptr) {
+            throw std::logic_error("the list already has eviction enabled");
+        }
+        if (versioned) {
+            throw std::logic_error("eviction cannot be combined with snapshots");
+        }
+        // Entries written so far are charged once; writes keep the total from then on.
+        auto counts = std::make_unique<LookupStripe[]>(LookupStripes);
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+        std::size_t charged = 0;
+        for (const Node* node = nextNode(head); node != nullptr; node = nextNode(node)) {
+            if (const ValueBuffer* value = node->Value.load(std::memory_order_acquire); value != nullptr) {
+                charged += node->AllocationSize() + (value->Inline ? 0 : value->AllocationSize());
+            }
+        }
+        chargedBytes.store(static_cast<std::int64_t>(charged), std::memory_order_relaxed);
+        evictionBudget = budgetBytes;
+        lookupCounts = std::move(counts);
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::evictOverBudget() {
+        auto overBudget = [&]() {
+            return chargedBytes.load(std::memory_order_relaxed) > static_cast<std::int64_t>(evictionBudget);
+        };
+        if (!overBudget()) {
+            return;
+        }
+        // One writer moves the hand at a time. The others go on: the hand keeps going while the
+        // total, theirs included, is over the budget.
+        std::unique_lock<std::mutex> hand(clockMux, std::try_to_lock);
+        if (!hand.owns_lock()) {
+            return;
+        }
+        ByteVector victim;
+        std::size_t wraps = 0;
+        while (overBudget() && advanceClock(victim, wraps)) {
+            // Fails only if a concurrent Remove got there first, which freed the bytes as well.
+            if (Remove(victim)) {
+                evictedEntries.fetch_add(1, std::memory_order_relaxed);
+                wraps = 0;
+            }
+        }
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::advanceClock(ByteVector& victim, std::size_t& wraps) {
+        // The first full turn clears every bit it passes, so the second finds a victim unless
+        // lookups set all of them again meanwhile; the hand gives up rather than turn a third time.
+        EpochGuard guard(epoch);
+        const Node* node = clockStarted ? seekNode(clockHand, false) : nextNode(head);
+        while (true) {
+            if (node == nullptr) {
+                node = nextNode(head);
+                if (++wraps > 2 || node == nullptr) {
+                    return false;
+                }
+            }
+            if (const ValueBuffer* value = node->Value.load(std::memory_order_acquire); value != nullptr) {
+                if (node->Referenced.load(std::memory_order_relaxed) == 0) {
+                    const ByteView key = node->Key();
+                    victim.assign(key.begin(), key.end());
+                    clockHand = victim;
+                    clockStarted = true;
+                    return true;
+                }
+                node->Referenced.store(0, std::memory_order_relaxed);
+                secondChances.fetch_add(1, std::memory_order_relaxed);
+            }
+            node = nextNode(node);
+        }
+    }
+
+    template <KeyOrder Order>
+    CacheStats BasicList<Order>::GetCacheStats() const {
+        CacheStats stats{};
+        if (lookupCounts == nullptr) {
+            return stats;
+        }
+        stats.BudgetBytes = evictionBudget;
+        stats.ChargedBytes = static_cast<std::size_t>(std::max<std::int64_t>(chargedBytes.load(std::memory_order_relaxed), 0));
+        for (std::size_t i = 0; i < LookupStripes; i++) {
+            stats.Hits += lookupCounts[i].Hits.load(std::memory_order_relaxed);
+            stats.Misses += lookupCounts[i].Misses.load(std::memory_order_relaxed);
+        }
+        stats.Evictions = evictedEntries.load(std::memory_order_relaxed);
+        stats.SecondChances = secondChances.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    template <KeyOrder Order>
+    LevelStats BasicList<Order>::GetLevelStats() const {
+        LevelStats out{};
+        out.MaxLevel = maxLevel.load(std::memory_order_relaxed);
+        out.CurrentLevel = currentLevel.load(std::memory_order_acquire);
+        out.Entries = entryCounts != nullptr ? static_cast<std::uint64_t>(liveEntries()) : 0;
+        out.Relocated = relocatedNodes.load(std::memory_order_relaxed);
+        out.Passes = rebalancePasses.load(std::memory_order_relaxed);
+
+        // Sample the keys of the highest level holding at least SampleSize / 2 nodes (level 0
+        // if none does): its nodes are spread over the whole list, and it is short to walk.
+        constexpr std::size_t SampleSize = 64;
+        EpochGuard guard(epoch);
+        std::vector<const Node*> sample;
+        for (std::size_t level = out.CurrentLevel + 1; level-- > 0 && sample.size() < SampleSize / 2;) {
+            sample.clear();
+            std::size_t count = 0;
+            for (const Node* node = detail::unmarked(head->Forward(level).load(std::memory_order_acquire)); node != nullptr;
+                 node = detail::unmarked(node->Forward(level).load(std::memory_order_acquire))) {
+                count++;
+            }
+            const std::size_t stride = std::max<std::size_t>(1, count / SampleSize);
+            std::size_t position = 0;
+            for (const Node* node = detail::unmarked(head->Forward(level).load(std::memory_order_acquire)); node != nullptr && sample.size() < SampleSize;
+                 node = detail::unmarked(node->Forward(level).load(std::memory_order_acquire))) {
+                if (position++ % stride == 0) {
+                    sample.push_back(node);
+                }
+            }
+        }
+        std::size_t visited = 0;
+        for (const Node* node : sample) {
+            findCounting(node->Key(), visited);
+        }
+        out.SearchDepth = sample.empty() ? 0.0 : static_cast<double>(visited) / static_cast<double>(sample.size());
+        return out;
+    }
+
+    template <KeyOrder Order>
+    ListMetrics BasicList<Order>::GetMetrics() const {
+        ListMetrics out{};
+        out.MaxLevel = maxLevel.load(std::memory_order_relaxed);
+        out.Probability = probability;
+        out.CurrentLevel = currentLevel.load(std::memory_order_acquire);
+        out.Heights.assign(out.MaxLevel, 0);
+        out.Lock = GetLockStats();
+        if (metrics != nullptr) {
+            // Stripes are read one by one: clamp the sums a concurrent removal may have taken below 0.
+            const MetricTotals totals = metrics->Totals();
+            auto clamped = [](const std::int64_t value) { return static_cast<std::uint64_t>(std::max<std::int64_t>(value, 0)); };
+            out.Entries = clamped(totals.Entries);
+            out.KeyBytes = clamped(totals.KeyBytes);
+            out.ValueBytes = clamped(totals.ValueBytes);
+            out.Searches = totals.Searches;
+            out.NodesVisited = totals.NodesVisited;
+            // Nodes built under an earlier, larger maxLevel keep their towers until rebalanced.
+            for (std::size_t h = 0; h < Node::MaxHeight; h++) {
+                if (totals.Heights[h] > 0 && h >= out.Heights.size()) {
+                    out.Heights.resize(h + 1, 0);
+                }
+                if (h < out.Heights.size()) {
+                    out.Heights[h] = clamped(totals.Heights[h]);
+                }
+            }
+        }
+        const std::uint64_t used = arena.Stats().UsedBytes;
+        out.OverheadBytes = used - std::min(used, out.KeyBytes + out.ValueBytes);
+        const double levels = out.Entries > 1 ? std::ceil(std::log(static_cast<double>(out.Entries)) / std::log(1.0 / static_cast<double>(probability))) : 0.0;
+        out.SuggestedMaxLevel = static_cast<std::size_t>(levels) + 1;
+        return out;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::insertLocked(const ByteView key, const ByteView value) {
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+
+        const std::size_t newLevel = randomLevel();
+        raiseLevel(newLevel);
+        const std::size_t topLevel = currentLevel.load(std::memory_order_relaxed);
+
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        Node* current = head;
+        Path update;
+
+        for (std::size_t i = topLevel + 1; i-- > 0;) {
+            Node* next = current->Forward(i).load(std::memory_order_relaxed);
+            while (next != nullptr && detail::nodeBefore<Order>(next, key, keyPrefix)) {
+                current = next;
+                next = current->Forward(i).load(std::memory_order_relaxed);
+            }
+            update[i] = current;
+        }
+
+        Node* next = current->Forward(0).load(std::memory_order_relaxed);
+
+        if (next == nullptr || !detail::nodeMatches<Order>(next, key, keyPrefix)) {
+            Node *newNode = createNode(key, keyPrefix, value, newLevel + 1);
+
+            for (std::size_t i = 0; i <= newLevel; i++) {
+                newNode->Forward(i).store(update[i]->Forward(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+                update[i]->Forward(i).store(newNode, std::memory_order_release);
+            }
+            publishVersion();
+            indexNode(newNode);
+            noteLinked(newNode, value.size());
+            return true;
+        }
+        return replaceLocked(next, value); // Update existing value (or revive a tombstone)
+    }
+
+    template <KeyOrder Order>
+    typename BasicList<Order>::Rewritten BasicList<Order>::rewriteLocked(const ByteView key, const Rewrite& compute) {
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+
+        Path update;
+        Node* found = searchLocked(key, update);
+        ByteVector scratch;
+        if (found != nullptr && !versioned) {
+            // Insert may still swap this value through the index without the lock, so the new
+            // value replaces exactly the one it was computed from, as in rewriteLockFree.
+            ValueBuffer* current = found->Value.load(std::memory_order_acquire);
+            while (true) {
+                scratch.clear();
+                const std::optional<ByteView> result = compute(current->View(), scratch);
+                if (!result.has_value()) {
+                    return Rewritten::Unchanged;
+                }
+                ValueBuffer* buffer = ValueBuffer::Create(arena, *result);
+                if (found->Value.compare_exchange_strong(current, buffer, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    noteReplaced(current, result->size());
+                    retireValue(current);
+                    return Rewritten::Updated;
+                }
+                arena.Free(buffer, buffer->AllocationSize()); // never published
+            }
+        }
+        const ValueBuffer* value = found != nullptr ? found->Value.load(std::memory_order_relaxed) : nullptr;
+        const std::optional<ByteView> result = value != nullptr && !value->Tombstone ? compute(value->View(), scratch) : compute(std::nullopt, scratch);
+        if (!result.has_value()) {
+            return Rewritten::Unchanged;
+        }
+        if (found != nullptr) {
+            return replaceLocked(found, *result) ? Rewritten::Created : Rewritten::Updated; // versioned: writers all hold the lock
+        }
+
+        // The level is raised only now, so a rewrite that stores nothing leaves the list as it was.
+        const std::size_t topLevel = currentLevel.load(std::memory_order_relaxed);
+        const std::size_t newLevel = randomLevel();
+        for (std::size_t i = topLevel + 1; i <= newLevel; i++) {
+            update[i] = head;
+        }
+        raiseLevel(newLevel);
+        Node* newNode = createNode(key, detail::keyPrefix<Order>(key), *result, newLevel + 1);
+        for (std::size_t i = 0; i <= newLevel; i++) {
+            newNode->Forward(i).store(update[i]->Forward(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+            update[i]->Forward(i).store(newNode, std::memory_order_release);
+        }
+        publishVersion();
+        indexNode(newNode);
+        noteLinked(newNode, result->size());
+        return Rewritten::Created;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::removeLocked(const ByteView key) {
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        EpochGuard guard(epoch);
+
+        Path update;
+        Node* victim = searchLocked(key, update);
+        if (victim == nullptr || !removeNodeLocked(victim, update)) {
+            return false;
+        }
+        shrinkLevel();
+        return true;
+    }
+
+    template <KeyOrder Order>
+    Node* BasicList<Order>::searchLocked(const ByteView key, const std::span<Node*> preds) {
+        // Writer-side descent under the lock: fills the predecessors on every level and returns
+        // the node holding key, or nullptr.
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        Node* current = head;
+        for (std::size_t i = currentLevel.load(std::memory_order_relaxed) + 1; i-- > 0;) {
+            Node* next = current->Forward(i).load(std::memory_order_relaxed);
+            while (next != nullptr && detail::nodeBefore<Order>(next, key, keyPrefix)) {
+                current = next;
+                next = current->Forward(i).load(std::memory_order_relaxed);
+            }
+            preds[i] = current;
+        }
+        Node* found = current->Forward(0).load(std::memory_order_relaxed);
+        return found != nullptr && detail::nodeMatches<Order>(found, key, keyPrefix) ? found : nullptr;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::removeNodeLocked(Node* victim, const std::span<Node* const> preds) {
+        if (versioned) {
+            ValueBuffer* current = victim->Value.load(std::memory_order_relaxed);
+            if (current->Tombstone) {
+                return false;
+            }
+            ValueBuffer* tombstone = ValueBuffer::CreateVersion(arena, ByteView(), sequence.load(std::memory_order_relaxed) + 1, current, true);
+            victim->Value.store(tombstone, std::memory_order_release);
+            publishVersion();
+            noteUnlinked(victim, current);
+            if (oldestSnapshot.load(std::memory_order_acquire) != NoSnapshot) {
+                // An open snapshot may still read the key: the node stays until a sweep finds the
+                // tombstone visible to every snapshot.
+                pruneVersions(tombstone);
+                retainedVersions.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        unlinkLocked(victim, preds);
+        return true;
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::replaceLocked(Node* node, const ByteView value) {
+        if (!versioned) {
+            // An exchange, not a store: Insert may swap an indexed node's value without the lock.
+            ValueBuffer* old = node->Value.exchange(ValueBuffer::Create(arena, value), std::memory_order_acq_rel);
+            noteReplaced(old, value.size());
+            retireValue(old);
+            return false;
+        }
+        ValueBuffer* old = node->Value.load(std::memory_order_relaxed);
+        ValueBuffer* fresh = ValueBuffer::CreateVersion(arena, value, sequence.load(std::memory_order_relaxed) + 1, old, false);
+        node->Value.store(fresh, std::memory_order_release);
+        publishVersion();
+        if (old->Tombstone) {
+            noteLinked(node, value.size());
+        } else {
+            noteReplaced(old, value.size());
+        }
+        pruneVersions(fresh);
+        if (fresh->Version().Older.load(std::memory_order_relaxed) != nullptr) {
+            retainedVersions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return old->Tombstone;
+    }
+
+    template <KeyOrder Order>
+    Node* BasicList<Order>::createNode(const ByteView key, const std::uint64_t keyPrefix, const ByteView value, const std::size_t height) {
+        if (!versioned) {
+            return Node::Create(arena, key, keyPrefix, value, height);
+        }
+        // The inline buffer stays empty: the first version is standalone like every later one.
+        Node* node = Node::Create(arena, key, keyPrefix, ByteView(), height);
+        try {
+            node->Value.store(ValueBuffer::CreateVersion(arena, value, sequence.load(std::memory_order_relaxed) + 1, nullptr, false), std::memory_order_relaxed);
+        } catch (...) {
+            arena.Free(node, node->AllocationSize());
+            throw;
+        }
+        return node;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::publishVersion() {
+        // Writers are serialized: the version stored under the current sequence + 1 is complete,
+        // so snapshots opened from now on include it.
+        if (versioned) {
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::pruneVersions(ValueBuffer* newest) {
+        // Every open snapshot reads the newest version at or below its sequence, so versions past
+        // the first one at or below the oldest snapshot are unreachable for all of them.
+        if (!newest->Versioned) {
+            return;
+        }
+        const std::uint64_t oldest = oldestSnapshot.load(std::memory_order_acquire);
+        ValueBuffer* keep = newest;
+        while (keep != nullptr && keep->Sequence() > oldest) {
+            keep = keep->Version().Older.load(std::memory_order_relaxed);
+        }
+        if (keep != nullptr) {
+            retireVersions(keep->Version().Older.exchange(nullptr, std::memory_order_acq_rel));
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::retireVersions(ValueBuffer* value) {
+        while (value != nullptr) {
+            ValueBuffer* older = value->Versioned ? value->Version().Older.load(std::memory_order_relaxed) : nullptr;
+            retireValue(value);
+            value = older;
+        }
+    }
+
+    template <KeyOrder Order>
+    const ValueBuffer* BasicList<Order>::versionAt(const Node* node, const std::uint64_t snapshot) {
+        const ValueBuffer* value = node->Value.load(std::memory_order_acquire);
+        while (value != nullptr && value->Sequence() > snapshot) {
+            value = value->Version().Older.load(std::memory_order_acquire);
+        }
+        return value != nullptr && !value->Tombstone ? value : nullptr;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::EnableSnapshots() {
+        if (versioned) {
+            throw std::logic_error("the list already has snapshots enabled");
+        }
+        if (concurrency == Concurrency::LockFree) {
+            throw std::logic_error("snapshots need a Locked or Combining list");
+        }
+        if (lookupCounts != nullptr) {
+            throw std::logic_error("snapshots cannot be combined with eviction");
+        }
+        if (head->Forward(0).load(std::memory_order_acquire) != nullptr) {
+            throw std::logic_error("snapshots can only be enabled on an empty list");
+        }
+        versioned = true;
+    }
+
+    template <KeyOrder Order>
+    std::uint64_t BasicList<Order>::openSnapshot() {
+        if (!versioned) {
+            throw std::logic_error("snapshots are not enabled on this list");
+        }
+        // Under the writer lock no write is between storing its version and publishing its
+        // sequence, so every version at or below the sequence read here is in place.
+        std::unique_lock<std::shared_mutex> lock = lockExclusive();
+        const std::uint64_t snapshot = sequence.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> guard(snapshotMux);
+        openSnapshots.insert(snapshot);
+        oldestSnapshot.store(*openSnapshots.begin(), std::memory_order_release);
+        return snapshot;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::closeSnapshot(const std::uint64_t snapshot) {
+        // Writers may read the old bound a little longer; that only keeps more versions.
+        bool advanced = false;
+        {
+            std::lock_guard<std::mutex> guard(snapshotMux);
+            openSnapshots.erase(openSnapshots.find(snapshot));
+            const std::uint64_t oldest = openSnapshots.empty() ? NoSnapshot : *openSnapshots.begin();
+            advanced = oldest != oldestSnapshot.load(std::memory_order_relaxed);
+            oldestSnapshot.store(oldest, std::memory_order_release);
+        }
+        if (advanced && retainedVersions.exchange(0, std::memory_order_acq_rel) > 0) {
+            try {
+                collectVersions();
+            } catch (...) {
+                retainedVersions.fetch_add(1, std::memory_order_relaxed); // left for the next close
+            }
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::collectVersions() {
+        // Walk level 0 in batches, each under one short lock hold, dropping versions no snapshot
+        // can read any more and unlinking tombstones every snapshot sees.
+        constexpr std::size_t SweepBatch = 256;
+        ByteVector resume;
+        bool started = false;
+        while (true) {
+            std::unique_lock<std::shared_mutex> lock = lockExclusive();
+            EpochGuard guard(epoch);
+            const std::uint64_t oldest = oldestSnapshot.load(std::memory_order_acquire);
+            Node* node = started ? const_cast<Node*>(seekNode(resume, false)) : head->Forward(0).load(std::memory_order_relaxed);
+            std::vector<ByteVector> expired;
+            for (std::size_t visited = 0; node != nullptr && visited < SweepBatch; visited++) {
+                ValueBuffer* newest = node->Value.load(std::memory_order_relaxed);
+                pruneVersions(newest);
+                const ByteView key = node->Key();
+                if (newest->Tombstone && newest->Sequence() <= oldest) {
+                    expired.emplace_back(key.begin(), key.end());
+                }
+                resume.assign(key.begin(), key.end());
+                node = node->Forward(0).load(std::memory_order_relaxed);
+            }
+            for (const ByteVector& key : expired) {
+                Path preds;
+                if (Node* victim = searchLocked(key, preds); victim != nullptr) {
+                    unlinkLocked(victim, preds);
+                }
+            }
+            if (!expired.empty()) {
+                shrinkLevel();
+            }
+            if (node == nullptr) {
+                return;
+            }
+            started = true;
+        }
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::Snapshot::SearchInto(const ByteView key, ByteVector& out) const {
+        EpochGuard guard(list->epoch);
+        const Node* node = list->findNode(key);
+        const ValueBuffer* value = node != nullptr ? versionAt(node, sequence) : nullptr;
+        if (value == nullptr) {
+            out.clear();
+            return false;
+        }
+        out.assign(value->View().begin(), value->View().end());
+        return true;
+    }
+
+    template <KeyOrder Order>
+    std::vector<Entry> BasicList<Order>::Snapshot::Scan(const ByteView begin, const ByteView end, const std::size_t limit) const {
+        std::vector<Entry> out;
+        EpochGuard guard(list->epoch);
+        for (const Node* node = begin.empty() ? nextNode(list->head) : list->seekNode(begin, true); node != nullptr && out.size() < limit; node = nextNode(node)) {
+            if (!end.empty() && !Order::Less(node->Key(), end)) {
+                break;
+            }
+            if (const ValueBuffer* value = versionAt(node, sequence); value != nullptr) {
+                const ByteView key = node->Key();
+                out.push_back({ByteVector(key.begin(), key.end()), ByteVector(value->View().begin(), value->View().end())});
+            }
+        }
+        return out;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::unlinkLocked(Node* victim, const std::span<Node* const> preds) {
+        // Readers treat a null value or a marked level-0 link as "absent"; mark every level
+        // before unlinking so a reader standing on the victim steps over it.
+        ValueBuffer* value = victim->Value.exchange(nullptr, std::memory_order_acq_rel);
+        if (!value->Tombstone) {
+            noteUnlinked(victim, value); // a tombstone was counted out when it was stored
+        }
+        retireVersions(value);
+        const std::size_t height = victim->Height;
+        for (std::size_t i = height; i-- > 0;) {
+            Node* next = victim->Forward(i).load(std::memory_order_relaxed);
+            victim->Forward(i).store(detail::marked(next), std::memory_order_release);
+        }
+        for (std::size_t i = 0; i < height; i++) {
+            preds[i]->Forward(i).store(detail::unmarked(victim->Forward(i).load(std::memory_order_relaxed)), std::memory_order_release);
+        }
+        unindexNode(victim);
+        epoch.Retire(victim, &detail::deleteNode, &arena);
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::shrinkLevel() {
+        std::size_t topLevel = currentLevel.load(std::memory_order_relaxed);
+        while (topLevel > 0 && head->Forward(topLevel).load(std::memory_order_relaxed) == nullptr) {
+            topLevel--;
+        }
+        currentLevel.store(topLevel, std::memory_order_release);
+    }
+
+    namespace detail {
+        // States of a CombiningSlot.
+        enum : std::uint8_t {
+            SlotFree,
+            SlotClaimed,
+            SlotPending,
+            SlotDone
+        };
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::combine(const bool remove, const ByteView key, const ByteView value) {
+        CombiningSlot local;
+        local.Remove = remove;
+        local.Key = key;
+        local.Value = value;
+        local.State.store(detail::SlotClaimed, std::memory_order_relaxed);
+
+        // Uncontended: apply the write, and whatever others published meanwhile, right away.
+        if (std::unique_lock<std::shared_mutex> lock = tryLockExclusive(); lock.owns_lock()) {
+            applyCombined(&local);
+        } else {
+            CombiningSlot& slot = slots[ThreadIndex() % CombiningSlots];
+            std::uint8_t expected = detail::SlotFree;
+            if (!slot.State.compare_exchange_strong(expected, detail::SlotClaimed, std::memory_order_acquire, std::memory_order_relaxed)) {
+                // More threads than slots: this one queues on the lock like a Locked writer.
+                lock = lockExclusive();
+                applyCombined(&local);
+            } else {
+                slot.Remove = remove;
+                slot.Key = key;
+                slot.Value = value;
+                slot.Error = nullptr;
+                slot.State.store(detail::SlotPending, std::memory_order_release);
+                pendingWrites.fetch_add(1, std::memory_order_release);
+                countLostRace();
+
+                // Whoever takes the lock next applies the write; that may be this thread.
+                while (slot.State.load(std::memory_order_acquire) != detail::SlotDone) {
+                    if (std::unique_lock<std::shared_mutex> combiner = tryLockExclusive(); combiner.owns_lock()) {
+                        if (slot.State.load(std::memory_order_acquire) != detail::SlotDone) {
+                            applyCombined(&slot);
+                        }
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                local.Result = slot.Result;
+                local.Error = std::move(slot.Error);
+                slot.Error = nullptr;
+                slot.State.store(detail::SlotFree, std::memory_order_release);
+            }
+        }
+        if (local.Error != nullptr) {
+            std::rethrow_exception(local.Error);
+        }
+        return local.Result;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::applyCombined(CombiningSlot* own) {
+        // Called with the lock held. Collects own plus every published write, sorts them by key and
+        // applies them in one finger pass, as MultiInsert does; equal keys keep publication order.
+        std::array<CombiningSlot*, CombiningSlots + 1> batch;
+        std::size_t count = 0;
+        batch[count++] = own;
+        if (pendingWrites.load(std::memory_order_acquire) > 0) {
+            for (std::size_t i = 0; i < CombiningSlots; i++) {
+                CombiningSlot* slot = &slots[i];
+                if (slot != own && slot->State.load(std::memory_order_acquire) == detail::SlotPending) {
+                    batch[count++] = slot;
+                }
+            }
+        }
+        std::stable_sort(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(count), [](const CombiningSlot* a, const CombiningSlot* b) {
+            return Order::Less(a->Key, b->Key);
+        });
+
+        EpochGuard guard(epoch);
+        Path path;
+        std::size_t pathTop = currentLevel.load(std::memory_order_relaxed);
+        std::fill(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(pathTop) + 1, head);
+        bool removed = false;
+        for (std::size_t b = 0; b < count; b++) {
+            CombiningSlot* op = batch[b];
+            try {
+                std::size_t newLevel = 0;
+                if (!op->Remove) {
+                    newLevel = randomLevel();
+                    raiseLevel(newLevel);
+                    while (pathTop < currentLevel.load(std::memory_order_relaxed)) {
+                        path[++pathTop] = head;
+                    }
+                }
+                const std::uint64_t keyPrefix = detail::keyPrefix<Order>(op->Key);
+                Node* next = fingerSeek(op->Key, keyPrefix, std::span<Node*>(path.data(), pathTop + 1));
+                const bool present = next != nullptr && detail::nodeMatches<Order>(next, op->Key, keyPrefix);
+                if (op->Remove) {
+                    op->Result = present && removeNodeLocked(next, path);
+                    removed = removed || op->Result;
+                } else if (!present) {
+                    Node* newNode = createNode(op->Key, keyPrefix, op->Value, newLevel + 1);
+                    for (std::size_t i = 0; i <= newLevel; i++) {
+                        newNode->Forward(i).store(path[i]->Forward(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        path[i]->Forward(i).store(newNode, std::memory_order_release);
+                        // The path stays on the predecessors: a later write of the same key must find the node.
+                    }
+                    publishVersion();
+                    indexNode(newNode);
+                    noteLinked(newNode, op->Value.size());
+                    op->Result = true;
+                } else {
+                    op->Result = replaceLocked(next, op->Value);
+                }
+            } catch (...) {
+                op->Error = std::current_exception();
+            }
+            if (op->State.load(std::memory_order_relaxed) == detail::SlotPending) {
+                if (op != own) {
+                    combinedWrites.fetch_add(1, std::memory_order_relaxed);
+                }
+                pendingWrites.fetch_sub(1, std::memory_order_relaxed);
+                op->State.store(detail::SlotDone, std::memory_order_release);
+            }
+        }
+        if (removed) {
+            shrinkLevel();
+        }
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::findLockFree(const ByteView key, const std::span<Node*> preds, const std::span<Node*> succs) {
+        // Herlihy/Shavit find: collects predecessors and successors on every level and unlinks
+        // marked nodes met on the way; restarts from the head when a predecessor changed.
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        while (true) {
+            Node* pred = head;
+            bool restart = false;
+            for (std::size_t i = preds.size(); i-- > 0 && !restart;) {
+                Node* current = detail::unmarked(pred->Forward(i).load(std::memory_order_acquire));
+                while (current != nullptr) {
+                    Node* next = current->Forward(i).load(std::memory_order_acquire);
+                    while (detail::isMarked(next)) {
+                        Node* expected = current;
+                        if (!pred->Forward(i).compare_exchange_strong(expected, detail::unmarked(next), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                            countLostRace();
+                            restart = true;
+                            break;
+                        }
+                        current = detail::unmarked(next);
+                        if (current == nullptr) {
+                            break;
+                        }
+                        next = current->Forward(i).load(std::memory_order_acquire);
+                    }
+                    if (restart || current == nullptr || !detail::nodeBefore<Order>(current, key, keyPrefix)) {
+                        break;
+                    }
+                    pred = current;
+                    current = next;
+                }
+                preds[i] = pred;
+                succs[i] = current;
+            }
+            if (!restart) {
+                return succs[0] != nullptr && detail::nodeMatches<Order>(succs[0], key, keyPrefix);
+            }
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::markNode(Node* node) {
+        for (std::size_t i = node->Height; i-- > 1;) {
+            Node* next = node->Forward(i).load(std::memory_order_acquire);
+            while (!detail::isMarked(next) && !node->Forward(i).compare_exchange_weak(next, detail::marked(next), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            }
+        }
+
+        // Whoever marks level 0 takes over the remover's reference.
+        Node* next = node->Forward(0).load(std::memory_order_acquire);
+        while (!detail::isMarked(next)) {
+            if (node->Forward(0).compare_exchange_weak(next, detail::marked(next), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                releaseNode(node);
+                return;
+            }
+        }
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::releaseNode(Node* node) {
+        // The inserter may still be linking upper levels after the node was marked, so the node
+        // is retired only by the last of inserter and remover, after a find that unlinks it everywhere.
+        if (node->References.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        const std::size_t topLevel = currentLevel.load(std::memory_order_acquire);
+        Path predsPath;
+        Path succsPath;
+        const std::span<Node*> preds(predsPath.data(), topLevel + 1);
+        const std::span<Node*> succs(succsPath.data(), topLevel + 1);
+        findLockFree(node->Key(), preds, succs);
+        unindexNode(node);
+        epoch.Retire(node, &detail::deleteNode, &arena);
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::insertLockFree(const ByteView key, const ByteView value) {
+        EpochGuard guard(epoch);
+
+        const std::size_t newLevel = randomLevel();
+        raiseLevel(newLevel);
+        const std::size_t topLevel = currentLevel.load(std::memory_order_acquire);
+
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        Path predsPath;
+        Path succsPath;
+        const std::span<Node*> preds(predsPath.data(), topLevel + 1);
+        const std::span<Node*> succs(succsPath.data(), topLevel + 1);
+        ValueBuffer* buffer = nullptr;
+        Node* newNode = nullptr;
+
+        // Level 0 decides membership: the key is either found (value swapped in place) or
+        // the new node wins the CAS on its predecessor's bottom link.
+        while (true) {
+            if (findLockFree(key, preds, succs)) {
+                Node* found = succs[0];
+                if (buffer == nullptr) {
+                    buffer = ValueBuffer::Create(arena, value);
+                }
+                ValueBuffer* current = found->Value.load(std::memory_order_acquire);
+                while (current != nullptr && !found->Value.compare_exchange_weak(current, buffer, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                }
+                if (current != nullptr) {
+                    if (newNode != nullptr) {
+                        arena.Free(newNode, newNode->AllocationSize()); // never published
+                    }
+                    noteReplaced(current, value.size());
+                    retireValue(current);
+                    return false;
+                }
+                // Removed concurrently: help finish the removal so the next find skips it.
+                markNode(found);
+                continue;
+            }
+
+            if (newNode == nullptr) {
+                newNode = Node::Create(arena, key, keyPrefix, value, newLevel + 1);
+            }
+            for (std::size_t i = 0; i <= newLevel; i++) {
+                newNode->Forward(i).store(succs[i], std::memory_order_relaxed);
+            }
+
+            Node* expected = succs[0];
+            if (preds[0]->Forward(0).compare_exchange_strong(expected, newNode, std::memory_order_release, std::memory_order_relaxed)) {
+                break;
+            }
+            countLostRace();
+        }
+        if (buffer != nullptr) {
+            arena.Free(buffer, buffer->AllocationSize()); // never published
+        }
+        // Stored while the inserter's reference keeps the node from retirement, so the erase in
+        // releaseNode always comes after it.
+        indexNode(newNode);
+        noteLinked(newNode, value.size());
+        linkTowerLockFree(newNode, newLevel, key, preds, succs);
+        return true;
+    }
+
+    template <KeyOrder Order>
+    void BasicList<Order>::linkTowerLockFree(Node* node, const std::size_t newLevel, const ByteView key, const std::span<Node*> preds, const std::span<Node*> succs) {
+        // Upper levels are only shortcuts; link them bottom-up, re-searching whenever a
+        // neighbour changed underneath us, and stop as soon as the node is being removed.
+        bool removing = false;
+        for (std::size_t i = 1; i <= newLevel && !removing; i++) {
+            while (true) {
+                Node* link = node->Forward(i).load(std::memory_order_acquire);
+                if (detail::isMarked(link)) {
+                    removing = true;
+                    break;
+                }
+                if (link != succs[i] && !node->Forward(i).compare_exchange_strong(link, succs[i], std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    continue;
+                }
+                Node* expected = succs[i];
+                if (preds[i]->Forward(i).compare_exchange_strong(expected, node, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    break;
+                }
+                countLostRace();
+                findLockFree(key, preds, succs);
+            }
+        }
+        releaseNode(node);
+    }
+
+    template <KeyOrder Order>
+    typename BasicList<Order>::Rewritten BasicList<Order>::rewriteLockFree(const ByteView key, const Rewrite& compute) {
+        EpochGuard guard(epoch);
+
+        const std::size_t newLevel = randomLevel();
+        raiseLevel(newLevel);
+        const std::size_t topLevel = currentLevel.load(std::memory_order_acquire);
+
+        const std::uint64_t keyPrefix = detail::keyPrefix<Order>(key);
+        Path predsPath;
+        Path succsPath;
+        const std::span<Node*> preds(predsPath.data(), topLevel + 1);
+        const std::span<Node*> succs(succsPath.data(), topLevel + 1);
+        ByteVector scratch;
+
+        // As insertLockFree, except that the new value is computed from the one it replaces: a
+        // CAS that fails because the value changed recomputes it.
+        while (true) {
+            if (findLockFree(key, preds, succs)) {
+                Node* found = succs[0];
+                ValueBuffer* current = found->Value.load(std::memory_order_acquire);
+                while (current != nullptr) {
+                    scratch.clear();
+                    const std::optional<ByteView> result = compute(current->View(), scratch);
+                    if (!result.has_value()) {
+                        return Rewritten::Unchanged;
+                    }
+                    ValueBuffer* buffer = ValueBuffer::Create(arena, *result);
+                    if (found->Value.compare_exchange_strong(current, buffer, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        noteReplaced(current, result->size());
+                        retireValue(current);
+                        return Rewritten::Updated;
+                    }
+                    arena.Free(buffer, buffer->AllocationSize()); // never published
+                    countLostRace();
+                }
+                // Removed concurrently: help finish the removal so the next find skips it.
+                markNode(found);
+                continue;
+            }
+
+            scratch.clear();
+            const std::optional<ByteView> result = compute(std::nullopt, scratch);
+            if (!result.has_value()) {
+                return Rewritten::Unchanged;
+            }
+            Node* newNode = Node::Create(arena, key, keyPrefix, *result, newLevel + 1);
+            for (std::size_t i = 0; i <= newLevel; i++) {
+                newNode->Forward(i).store(succs[i], std::memory_order_relaxed);
+            }
+            Node* expected = succs[0];
+            if (preds[0]->Forward(0).compare_exchange_strong(expected, newNode, std::memory_order_release, std::memory_order_relaxed)) {
+                indexNode(newNode);
+                noteLinked(newNode, result->size());
+                linkTowerLockFree(newNode, newLevel, key, preds, succs);
+                return Rewritten::Created;
+            }
+            // The key may have appeared: the value is computed again from whatever is there now.
+            arena.Free(newNode, newNode->AllocationSize()); // never published
+            countLostRace();
+        }
+    }
+
+    template <KeyOrder Order>
+    bool BasicList<Order>::removeLockFree(const ByteView key) {
+        EpochGuard guard(epoch);
+
+        const std::size_t topLevel = currentLevel.load(std::memory_order_acquire);
+        Path predsPath;
+        Path succsPath;
+        const std::span<Node*> preds(predsPath.data(), topLevel + 1);
+        const std::span<Node*> succs(succsPath.data(), topLevel + 1);
+        if (!findLockFree(key, preds, succs)) {
+            return false;
+        }
+
+        // Swapping the value to null is the linearization point; marking and unlinking follow.
+        Node* victim = succs[0];
+        ValueBuffer* current = victim->Value.load(std::memory_order_acquire);
+        while (current != nullptr && !victim->Value.compare_exchange_weak(current, nullptr, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        }
+        markNode(victim);
+        if (current == nullptr) {
+            return false;
+        }
+        noteUnlinked(victim, current);
+        retireValue(current);
+        return true;
+    }
+}
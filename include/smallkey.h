@@ -0,0 +1,114 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 13.11.2025
+ * @description: SmallKey, an owning key buffer with small-string optimization: keys of up to 23
+ * bytes live inside the 24-byte object, longer ones on the heap. Lets callers build and keep
+ * short variable-length keys without a ByteVector allocation per key.
+ */
+
+#pragma once
+
+#include "comparator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace tbt {
+
+    /*
+     * Owning byte key that stores up to InlineCapacity bytes inline.
+     * Notes:
+     *   - Converts to ByteView, so it is passed to BasicList/BasicThreadByteTree like any key; the
+     *     list copies the bytes into the node block and keeps no reference to the SmallKey.
+     *   - Inside the list every key is already stored inline in its node, whatever its length;
+     *     SmallKey only spares the caller's side the allocation.
+     *   - Copying a spilled key allocates; moving one does not.
+     */
+    class SmallKey {
+        public:
+            static constexpr std::size_t InlineCapacity = 23;
+
+            SmallKey() noexcept = default;
+
+            /*
+             * Copy of bytes; allocates only if bytes is longer than InlineCapacity.
+             * Throws:
+             *   - std::length_error if bytes is larger than 4 GiB, the list's key limit.
+             */
+            explicit SmallKey(ByteView bytes);
+
+            SmallKey(const SmallKey& other);
+            SmallKey(SmallKey&& other) noexcept;
+            SmallKey& operator=(const SmallKey& other);
+            SmallKey& operator=(SmallKey&& other) noexcept;
+            ~SmallKey();
+
+            /*
+             * Replace the contents with a copy of bytes; bytes may point into this key. A long key
+             * reuses the heap buffer when it is large enough, a short one always goes inline.
+             */
+            void Assign(ByteView bytes);
+
+            const std::uint8_t* Data() const noexcept {
+                return spilled() ? heap().Data : storage;
+            }
+
+            std::size_t Size() const noexcept {
+                return spilled() ? heap().Size : storage[InlineCapacity];
+            }
+
+            /*
+             * True while the bytes are stored inside the object.
+             */
+            bool IsInline() const noexcept {
+                return !spilled();
+            }
+
+            operator ByteView() const noexcept {
+                return {Data(), Size()};
+            }
+
+            friend bool operator==(const SmallKey& leftHand, const SmallKey& rightHand) noexcept {
+                return ByteVectorEqual(leftHand, rightHand);
+            }
+
+            friend bool operator<(const SmallKey& leftHand, const SmallKey& rightHand) noexcept {
+                return ByteVectorLess(leftHand, rightHand);
+            }
+
+        private:
+            // Heap representation, kept in the first 16 bytes of storage while spilled.
+            struct Heap {
+                std::uint8_t* Data;
+                std::uint32_t Size;
+                std::uint32_t Capacity;
+            };
+
+            // The last byte holds the inline size, or Spilled; it is never part of the key bytes.
+            static constexpr std::uint8_t Spilled = 0xFF;
+
+            static_assert(sizeof(Heap) <= InlineCapacity);
+
+            alignas(Heap) std::uint8_t storage[InlineCapacity + 1]{};
+
+            bool spilled() const noexcept {
+                return storage[InlineCapacity] == Spilled;
+            }
+
+            Heap heap() const noexcept {
+                Heap value;
+                std::memcpy(&value, storage, sizeof(value));
+                return value;
+            }
+
+            void setHeap(const Heap& value) noexcept {
+                std::memcpy(storage, &value, sizeof(value));
+                storage[InlineCapacity] = Spilled;
+            }
+
+            void release() noexcept;
+    };
+
+    static_assert(sizeof(SmallKey) == 24, "small key grew past three words");
+}
@@ -0,0 +1,219 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 29.10.2025
+ * @description: Immutable, sorted snapshot files. SnapshotWriter packs entries into checksummed
+ * blocks with prefix-compressed keys and a sparse index (first key of every block);
+ * MappedSnapshot maps such a file and serves lookups and range scans straight from the mapped
+ * pages, without building any in-memory structure.
+ */
+
+#pragma once
+
+#include "comparator.h"
+#include "skiplist.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tbt {
+
+    /*
+     * File layout (integers little-endian, varints LEB128):
+     *   [block 0] ... [block n-1] [index records] [index offsets] [footer]
+     *   - Block: entries of [shared key bytes][unshared key bytes][value size] (varints), then
+     *     the unshared key suffix and the value; the first entry of a block shares nothing. Each
+     *     block ends with a crc32c of its entries.
+     *   - Index record: [block offset:8][block size:4][first key size:4][first key].
+     *   - Index offsets: one 8-byte file offset per index record, for binary search in place.
+     *   - Footer (48 bytes): [index offset:8][offsets offset:8][block count:8][entry count:8]
+     *     [index crc32c:4][version:4][magic:8].
+     * Keys are in byte order (ByteVectorLess), strictly increasing.
+     */
+    class SnapshotWriter {
+        private:
+            int fd;
+            std::string path;
+            std::string tempPath;
+            ByteVector block;
+            ByteVector index;
+            std::vector<std::uint64_t> indexOffsets;
+            ByteVector lastKey;
+            std::uint64_t fileOffset = 0;
+            std::uint64_t entries = 0;
+            bool blockStarted = false;
+            bool finished = false;
+
+            void flushBlock();
+            void writeBytes(const ByteVector& bytes);
+
+        public:
+            /*
+             * Target size of a block's entries; a block closes at the first entry that reaches it.
+             */
+            static constexpr std::size_t BlockSize = 4096;
+
+            /*
+             * Start writing a snapshot that will replace path once Finish succeeds.
+             * Throws:
+             *   - std::system_error if the temporary file (path + ".tmp") cannot be created.
+             */
+            explicit SnapshotWriter(const std::string& path);
+
+            /*
+             * Close the file; an unfinished snapshot is discarded and path is left untouched.
+             */
+            ~SnapshotWriter();
+
+            SnapshotWriter(const SnapshotWriter&) = delete;
+            SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+            /*
+             * Append an entry.
+             * Throws:
+             *   - std::invalid_argument if key is not greater than the previous key.
+             *   - std::length_error if key or value is larger than 4 GiB.
+             *   - std::system_error if writing a completed block fails.
+             */
+            void Add(ByteView key, ByteView value);
+
+            /*
+             * Write the index and footer, sync, and atomically rename the file into place.
+             * Throws:
+             *   - std::system_error on I/O failure (path is then left untouched).
+             */
+            void Finish();
+
+            /*
+             * Number of entries added so far.
+             */
+            std::uint64_t Entries() const {
+                return entries;
+            }
+    };
+
+    /*
+     * Read-only view of a snapshot file through mmap. Opening reads the footer and checks the index
+     * checksum; data blocks are paged in by the OS on first access and each block's checksum is
+     * verified once, the first time a lookup or scan touches it.
+     * Notes:
+     *   - Every ByteView returned points into the mapping and stays valid while the snapshot lives.
+     *   - Safe for concurrent readers.
+     */
+    class MappedSnapshot {
+        private:
+            const std::uint8_t* data = nullptr;
+            std::size_t size = 0;
+            std::uint64_t offsetsOffset = 0;
+            std::uint64_t blockCount = 0;
+            std::uint64_t entryCount = 0;
+            std::unique_ptr<std::atomic<std::uint64_t>[]> verified; // one bit per checked block
+
+            struct BlockRef {
+                ByteView Entries;
+                ByteView FirstKey;
+            };
+
+            // Bounds-checked index record of a block; verify checks the block's checksum on first use.
+            BlockRef blockAt(std::uint64_t index, bool verify) const;
+            std::uint64_t blockFor(ByteView key) const;
+
+        public:
+            /*
+             * Position within a snapshot; keys are rebuilt from their shared prefix into a buffer owned
+             * by the iterator, values are views of the mapping.
+             */
+            class Iterator {
+                private:
+                    const MappedSnapshot* snapshot;
+                    std::uint64_t blockIndex;
+                    ByteView rest;     // undecoded entries of the current block
+                    ByteVector key;
+                    ByteView value;
+                    bool valid = false;
+
+                    void loadBlock(std::uint64_t index);
+
+                public:
+                    explicit Iterator(const MappedSnapshot& snapshot);
+
+                    /*
+                     * Move to the first entry; Valid() is false for an empty snapshot.
+                     */
+                    void SeekToFirst();
+
+                    /*
+                     * Move to the first entry whose key is not less than target.
+                     */
+                    void Seek(ByteView target);
+
+                    bool Valid() const {
+                        return valid;
+                    }
+
+                    ByteView Key() const {
+                        return key;
+                    }
+
+                    ByteView Value() const {
+                        return value;
+                    }
+
+                    /*
+                     * Move to the next entry in key order.
+                     */
+                    void Next();
+            };
+
+            /*
+             * Map a snapshot file.
+             * Throws:
+             *   - std::system_error if the file cannot be opened or mapped.
+             *   - std::runtime_error if the footer or the index is damaged.
+             * Complexity:
+             *   - O(1) in the number of entries: reads the footer and checksums the sparse index only.
+             */
+            explicit MappedSnapshot(const std::string& path);
+
+            ~MappedSnapshot();
+
+            MappedSnapshot(const MappedSnapshot&) = delete;
+            MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+            /*
+             * Value stored under key, as a view of the mapped file.
+             * Returns:
+             *   - The value, or std::nullopt if key is absent.
+             * Throws:
+             *   - std::runtime_error if the block holding key fails its checksum.
+             * Complexity:
+             *   - O(log b) binary search over b blocks, then a scan of one block.
+             */
+            std::optional<ByteView> Get(ByteView key) const;
+
+            /*
+             * Copy out the entries of [begin, end) in ascending order (empty bounds are open), like
+             * List::Scan.
+             */
+            std::vector<Entry> Scan(ByteView begin, ByteView end, std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+
+            Iterator NewIterator() const {
+                return Iterator(*this);
+            }
+
+            /*
+             * Number of entries in the snapshot.
+             */
+            std::uint64_t Size() const {
+                return entryCount;
+            }
+
+            std::uint64_t BlockCount() const {
+                return blockCount;
+            }
+    };
+}
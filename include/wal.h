@@ -0,0 +1,177 @@
+/*
+ * @author: Viktor Shishmarev
+ * @date: 27.10.2025
+ * @description: Append-only write-ahead log for durable writes. Records are length-prefixed and
+ * checksummed; concurrent writers are grouped so that one write (and one fdatasync) covers
+ * every record appended while the previous group was being flushed.
+ */
+
+#pragma once
+
+#include "comparator.h"
+#include "hash.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace tbt {
+
+    /*
+     * When appended records are forced to stable storage.
+     *   - EveryOperation: Commit returns once the record is written and fdatasync'd; concurrent
+     *     commits share one write and one sync (group commit).
+     *   - Interval: Commit returns once the record is written to the OS, which survives a crash of
+     *     the process; a background thread syncs at most every WalOptions::Interval, bounding what a
+     *     power loss can take.
+     *   - None: like Interval without the background sync; the file is synced only when the log is
+     *     closed.
+     */
+    enum class SyncPolicy {
+        EveryOperation,
+        Interval,
+        None
+    };
+
+    struct WalOptions {
+        SyncPolicy Sync = SyncPolicy::EveryOperation;
+        /*
+         * Period of the background sync under SyncPolicy::Interval; must be positive then.
+         */
+        std::chrono::milliseconds Interval{10};
+    };
+
+    enum class WalRecordType : std::uint8_t {
+        Put = 1,
+        Erase = 2
+    };
+
+    /*
+     * One logged operation; Value is empty for Erase.
+     */
+    struct WalRecord {
+        WalRecordType Type;
+        ByteView Key;
+        ByteView Value;
+    };
+
+    /*
+     * Counters of a WriteAheadLog.
+     *   - Records: records appended.
+     *   - Writes: write groups handed to the OS (one or more records each).
+     *   - Syncs: fdatasync calls.
+     *   - Bytes: bytes written, headers included.
+     */
+    struct WalStats {
+        std::uint64_t Records;
+        std::uint64_t Writes;
+        std::uint64_t Syncs;
+        std::uint64_t Bytes;
+    };
+
+    /*
+     * On-disk record: [crc32c:4][keySize:4][valueSize:4][type:1][key][value], integers little-endian;
+     * the checksum covers everything after it. A record cut short by a crash or failing its checksum
+     * ends the log.
+     */
+    class WriteAheadLog {
+        private:
+            int fd;
+            WalOptions options;
+            mutable std::mutex mux;
+            std::condition_variable flushed;
+            std::condition_variable_any tick;
+            ByteVector pending;   // records appended but not yet handed to the OS
+            ByteVector writing;   // group being written by the current leader
+            std::uint64_t appendedLsn = 0;
+            std::uint64_t writtenLsn = 0;
+            std::uint64_t syncedLsn = 0;
+            bool flushing = false;
+            bool syncRequested = false;   // set by the interval syncer for the next leader
+            std::error_code failure;
+            WalStats stats{};
+            std::jthread syncer;
+
+            void flushAsLeader(std::unique_lock<std::mutex>& lock, bool sync);
+            void syncLoop(std::stop_token stop);
+
+        public:
+            /*
+             * Open (or create) a log file for appending.
+             * Parameters:
+             *   - path: log file; existing records are kept, new ones are appended after them.
+             *   - options: sync policy.
+             * Throws:
+             *   - std::invalid_argument if the sync policy is Interval and options.Interval is not
+             *     positive; the background syncer would otherwise spin.
+             *   - std::system_error if the file cannot be opened.
+             * Notes:
+             *   - Replay the file first: appending after a torn tail would hide the new records.
+             */
+            WriteAheadLog(const std::string& path, WalOptions options = {});
+
+            /*
+             * Flush and sync what is still pending, then close the file.
+             * Thread-safety:
+             *   - Must be invoked when no other thread appends.
+             */
+            ~WriteAheadLog();
+
+            WriteAheadLog(const WriteAheadLog&) = delete;
+            WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+            /*
+             * Encode records into the pending group without waiting for any I/O.
+             * Parameters:
+             *   - records: operations in the order they must be replayed.
+             * Returns:
+             *   - Log sequence number of the last record, to pass to Commit.
+             * Throws:
+             *   - std::system_error if an earlier flush failed (the log no longer accepts records).
+             *   - std::length_error if a key or value is larger than 4 GiB.
+             * Thread-safety:
+             *   - Safe for concurrent calls; records of one call are contiguous in the log.
+             */
+            std::uint64_t Append(std::span<const WalRecord> records);
+
+            /*
+             * Wait until the record with the given sequence number is as durable as the sync policy
+             * requires. The first waiter that finds no flush in progress becomes the leader and writes
+             * everything pending; the others wait for it, then either return or lead the next group.
+             * Throws:
+             *   - std::system_error if writing or syncing the log failed.
+             */
+            void Commit(std::uint64_t lsn);
+
+            /*
+             * Write and fdatasync everything appended so far, regardless of the policy.
+             */
+            void Sync();
+
+            /*
+             * Snapshot of the counters.
+             */
+            WalStats Stats() const;
+
+            /*
+             * Read a log file and hand every intact record to apply, in log order.
+             * Parameters:
+             *   - path: log file; a missing file replays nothing.
+             *   - apply: called once per record; the views are only valid during the call.
+             * Returns:
+             *   - Number of records replayed.
+             * Effects:
+             *   - A torn or corrupt tail (the record being written at a crash) is cut off the file, so
+             *     that records appended afterwards are reachable by the next replay.
+             * Throws:
+             *   - std::system_error if the file exists but cannot be read or truncated.
+             */
+            static std::uint64_t Replay(const std::string& path, const std::function<void(const WalRecord&)>& apply);
+    };
+}
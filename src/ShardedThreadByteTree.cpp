@@ -0,0 +1,101 @@
+#include "ShardedThreadByteTree.h"
+#include "hash.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace tbt {
+
+    namespace {
+        constexpr std::size_t PrefixRange = 65536; // two key bytes
+    }
+
+    ShardedThreadByteTree::ShardedThreadByteTree(std::size_t shardCount, std::size_t maxLevel, float probability,
+                                                 Partitioning partitioning, Concurrency concurrency)
+        : partitioning(partitioning) {
+        if (shardCount == 0) {
+            throw std::invalid_argument("shard count must be at least 1");
+        }
+        if (partitioning == Partitioning::Prefix && shardCount > PrefixRange) {
+            throw std::invalid_argument("prefix partitioning supports at most 65536 shards");
+        }
+
+        shards.reserve(shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            shards.push_back(std::make_unique<List>(maxLevel, probability, concurrency));
+        }
+    }
+
+    std::size_t ShardedThreadByteTree::shardOf(const ByteView key) const {
+        if (partitioning == Partitioning::Hash) {
+            return static_cast<std::size_t>(ByteVectorHash(key) % shards.size());
+        }
+
+        // Missing bytes count as zero, matching "shorter is less" for equal leading bytes.
+        const std::size_t high = key.empty() ? 0 : key[0];
+        const std::size_t low = key.size() < 2 ? 0 : key[1];
+        return ((high << 8) | low) * shards.size() / PrefixRange;
+    }
+
+    void ShardedThreadByteTree::put(const ByteView key, const ByteView value) {
+        shards[shardOf(key)]->Insert(key, value);
+    }
+
+    ByteVector ShardedThreadByteTree::get(const ByteView key) const {
+        return shards[shardOf(key)]->Search(key);
+    }
+
+    bool ShardedThreadByteTree::get_into(const ByteView key, ByteVector& out) const {
+        return shards[shardOf(key)]->SearchInto(key, out);
+    }
+
+    ValueView ShardedThreadByteTree::get_view(const ByteView key) const {
+        return shards[shardOf(key)]->Find(key);
+    }
+
+    bool ShardedThreadByteTree::erase(const ByteView key) {
+        return shards[shardOf(key)]->Remove(key);
+    }
+
+    std::vector<Entry> ShardedThreadByteTree::scan(const ByteView begin, const ByteView end, const std::size_t limit) const {
+        std::vector<Entry> out;
+        if (partitioning == Partitioning::Prefix) {
+            // Shards are ordered ranges: concatenating their scans keeps the keys in order.
+            const std::size_t last = end.empty() ? shards.size() - 1 : shardOf(end);
+            for (std::size_t shard = shardOf(begin); shard <= last && out.size() < limit; ++shard) {
+                std::vector<Entry> part = shards[shard]->Scan(begin, end, limit - out.size());
+                out.insert(out.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+            }
+            return out;
+        }
+
+        // Any shard may hold the smallest keys of the range: take up to limit from each, merge
+        // the sorted runs and keep the first limit.
+        for (const auto& shard : shards) {
+            const auto middle = static_cast<std::ptrdiff_t>(out.size());
+            std::vector<Entry> part = shard->Scan(begin, end, limit);
+            out.insert(out.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+            std::inplace_merge(out.begin(), out.begin() + middle, out.end(),
+                               [](const Entry& left, const Entry& right) { return ByteVectorLess(left.Key, right.Key); });
+            if (out.size() > limit) {
+                out.resize(limit);
+            }
+        }
+        return out;
+    }
+
+    std::size_t ShardedThreadByteTree::shardCount() const {
+        return shards.size();
+    }
+
+    std::vector<LockStats> ShardedThreadByteTree::shardStats() const {
+        std::vector<LockStats> stats;
+        stats.reserve(shards.size());
+        for (const auto& shard : shards) {
+            stats.push_back(shard->GetLockStats());
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,663 @@
+#include "TieredThreadByteTree.h"
+#include "hash.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tbt {
+
+    namespace {
+        // Memtables and runs store every value behind a one-byte tag, so that an erase can be
+        // recorded as a tombstone that hides older versions of the key.
+        constexpr std::uint8_t TombstoneTag = 0;
+        constexpr std::uint8_t ValueTag = 1;
+
+        // Node header, tower and value buffer of a memtable entry, roughly.
+        constexpr std::size_t EntryOverhead = 64;
+        constexpr std::size_t SimilarSize = 2;
+        // How often an idle flusher retries freeing Versions that readers may still hold.
+        constexpr std::chrono::milliseconds ReclaimRetry{1};
+        constexpr const char* ManifestName = "MANIFEST";
+        constexpr const char* ManifestHeader = "tbt-manifest 1";
+
+        std::error_code lastError() {
+            return {errno, std::generic_category()};
+        }
+
+        // Replace path with bytes: write a temporary file, sync it, rename it over path and sync the directory.
+        void writeFileAtomically(const std::filesystem::path& path, const ByteView bytes) {
+            const std::string tempPath = path.string() + ".tmp";
+            const int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::system_error(lastError(), "cannot create " + tempPath);
+            }
+            std::size_t written = 0;
+            while (written < bytes.size()) {
+                const ssize_t result = ::write(fd, bytes.data() + written, bytes.size() - written);
+                if (result < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (result < 0) {
+                    const std::error_code error = lastError();
+                    ::close(fd);
+                    ::unlink(tempPath.c_str());
+                    throw std::system_error(error, "cannot write " + tempPath);
+                }
+                written += static_cast<std::size_t>(result);
+            }
+            if (::fsync(fd) != 0 || ::close(fd) != 0 || ::rename(tempPath.c_str(), path.c_str()) != 0) {
+                const std::error_code error = lastError();
+                ::unlink(tempPath.c_str());
+                throw std::system_error(error, "cannot replace " + path.string());
+            }
+            if (const int dir = ::open(path.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); dir >= 0) {
+                (void)::fsync(dir);
+                ::close(dir);
+            }
+        }
+
+        bool decode(const ByteView tagged, ByteVector& out) {
+            if (tagged.empty() || tagged[0] == TombstoneTag) {
+                out.clear();
+                return false;
+            }
+            out.assign(tagged.begin() + 1, tagged.end());
+            return true;
+        }
+
+        /*
+         * Sorted stream of tagged entries: a memtable through a cursor, or a run.
+         */
+        class Source {
+            public:
+                virtual ~Source() = default;
+                virtual bool Valid() const = 0;
+                virtual ByteView Key() const = 0;
+                virtual ByteView Value() const = 0;
+                virtual void Next() = 0;
+        };
+
+        class ListSource final : public Source {
+            private:
+                List::Cursor cursor;
+
+            public:
+                ListSource(const List& list, const ByteView begin, const ByteView end) : cursor(list.OpenCursor(begin, end)) {}
+
+                bool Valid() const override {
+                    return cursor.Valid();
+                }
+
+                ByteView Key() const override {
+                    return cursor.Key();
+                }
+
+                ByteView Value() const override {
+                    return cursor.Value();
+                }
+
+                void Next() override {
+                    cursor.Next();
+                }
+        };
+
+        class RunSource final : public Source {
+            private:
+                MappedSnapshot::Iterator it;
+
+            public:
+                RunSource(const MappedSnapshot& table, const ByteView begin) : it(table.NewIterator()) {
+                    if (begin.empty()) {
+                        it.SeekToFirst();
+                    } else {
+                        it.Seek(begin);
+                    }
+                }
+
+                bool Valid() const override {
+                    return it.Valid();
+                }
+
+                ByteView Key() const override {
+                    return it.Key();
+                }
+
+                ByteView Value() const override {
+                    return it.Value();
+                }
+
+                void Next() override {
+                    it.Next();
+                }
+        };
+
+        /*
+         * Merge of sources given newest first: yields every key once, with the entry of the newest
+         * source holding it. A handful of sources is expected, so the smallest key is found by a
+         * linear pass rather than a heap.
+         */
+        class MergingIterator {
+            private:
+                std::vector<std::unique_ptr<Source>> sources;
+                std::size_t top = 0;
+                ByteVector key;
+
+                void pick() {
+                    top = sources.size();
+                    for (std::size_t i = 0; i < sources.size(); i++) {
+                        if (sources[i]->Valid() && (top == sources.size() || ByteVectorLess(sources[i]->Key(), sources[top]->Key()))) {
+                            top = i;
+                        }
+                    }
+                }
+
+            public:
+                void Add(std::unique_ptr<Source> source) {
+                    sources.push_back(std::move(source));
+                    pick();
+                }
+
+                bool Valid() const {
+                    return top < sources.size();
+                }
+
+                ByteView Key() const {
+                    return sources[top]->Key();
+                }
+
+                ByteView Value() const {
+                    return sources[top]->Value();
+                }
+
+                void Next() {
+                    // Older sources holding the same key are shadowed: step over them too.
+                    key.assign(Key().begin(), Key().end());
+                    for (const auto& source : sources) {
+                        if (source->Valid() && ByteVectorEqual(source->Key(), key)) {
+                            source->Next();
+                        }
+                    }
+                    pick();
+                }
+        };
+
+        // Runs are newest first and sizes grow towards the oldest; find the newest window of at
+        // least trigger consecutive runs whose sizes are within SimilarSize of each other.
+        template <typename Runs>
+        std::optional<std::pair<std::size_t, std::size_t>> pickCompaction(const Runs& runs, const std::size_t trigger) {
+            for (std::size_t first = 0; first + trigger <= runs.size(); first++) {
+                std::uint64_t smallest = runs[first]->Bytes;
+                std::uint64_t largest = smallest;
+                std::size_t last = first + 1;
+                for (; last < runs.size(); last++) {
+                    const std::uint64_t bytes = runs[last]->Bytes;
+                    if (std::max(largest, bytes) > SimilarSize * std::min(smallest, bytes)) {
+                        break;
+                    }
+                    smallest = std::min(smallest, bytes);
+                    largest = std::max(largest, bytes);
+                }
+                if (last - first >= trigger) {
+                    return std::make_pair(first, last);
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Write the merged entries to a run file and its filter. Returns false, leaving no file
+        // behind, if stop was requested meanwhile.
+        bool writeRun(MergingIterator& it, const std::string& tablePath, const std::string& filterPath, const bool dropTombstones,
+                      const std::size_t bitsPerKey, const std::stop_token& stop) {
+            SnapshotWriter writer(tablePath);
+            std::vector<std::uint64_t> hashes;
+            for (; it.Valid(); it.Next()) {
+                if (dropTombstones && it.Value()[0] == TombstoneTag) {
+                    continue;
+                }
+                writer.Add(it.Key(), it.Value());
+                hashes.push_back(ByteVectorHash(it.Key()));
+                if (hashes.size() % 4096 == 0 && stop.stop_requested()) {
+                    return false;
+                }
+            }
+
+            BloomFilter filter(hashes.size(), bitsPerKey);
+            for (const std::uint64_t hash : hashes) {
+                filter.Add(hash);
+            }
+            writeFileAtomically(filterPath, filter.Encode());
+            writer.Finish();
+            return true;
+        }
+    }
+
+    struct TieredThreadByteTree::Run {
+        std::uint64_t Number;
+        std::uint64_t Bytes;
+        MappedSnapshot Table;
+        BloomFilter Filter;
+
+        Run(const std::uint64_t number, const std::string& path)
+            : Number(number), Bytes(std::filesystem::file_size(path)), Table(path) {}
+    };
+
+    struct TieredThreadByteTree::Version {
+        std::shared_ptr<List> Active;
+        std::vector<std::shared_ptr<List>> Frozen;  // newest first
+        std::vector<std::shared_ptr<Run>> Runs;     // newest first
+    };
+
+    TieredThreadByteTree::TieredThreadByteTree(const std::string& directory, const TieredOptions options)
+        : directory(directory), options(options) {
+        if (options.MemtableBytes == 0 || options.MaxFrozen == 0) {
+            throw std::invalid_argument("memtable budget and frozen memtables must be at least 1");
+        }
+        if (options.CompactionTrigger < 2) {
+            throw std::invalid_argument("compaction trigger must be at least 2");
+        }
+        std::filesystem::create_directories(directory);
+
+        std::vector<std::uint64_t> numbers;
+        const std::filesystem::path manifestPath = std::filesystem::path(directory) / ManifestName;
+        if (std::filesystem::exists(manifestPath)) {
+            std::ifstream in(manifestPath);
+            std::string header;
+            std::string word;
+            std::uint64_t number = 0;
+            if (!std::getline(in, header) || header != ManifestHeader || !(in >> word >> nextRunNumber) || word != "next") {
+                throw std::runtime_error("manifest is corrupt: " + manifestPath.string());
+            }
+            while (in >> word >> number) {
+                if (word != "run" || number >= nextRunNumber) {
+                    throw std::runtime_error("manifest is corrupt: " + manifestPath.string());
+                }
+                numbers.push_back(number);
+            }
+            if (!in.eof()) {
+                throw std::runtime_error("manifest is corrupt: " + manifestPath.string());
+            }
+        }
+
+        // Runs the manifest does not list were being written, or merged away, when the process stopped.
+        const std::set<std::uint64_t> live(numbers.begin(), numbers.end());
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            const std::string name = entry.path().filename().string();
+            unsigned long long number = 0;
+            char suffix[16] = {};
+            const bool isRun = std::sscanf(name.c_str(), "run-%llu.%15s", &number, suffix) == 2;
+            if ((isRun && !live.contains(number)) || (isRun && name.ends_with(".tmp")) || name == std::string(ManifestName) + ".tmp") {
+                std::filesystem::remove(entry.path());
+            }
+        }
+
+        auto version = std::make_shared<Version>();
+        for (const std::uint64_t number : numbers) {
+            version->Runs.push_back(openRun(number));
+        }
+        version->Active = std::make_shared<List>(options.MaxLevel, options.Probability, options.Mode);
+        active = version->Active.get();
+        published.store(version.get(), std::memory_order_release);
+        current = std::move(version);
+
+        flusher = std::jthread([this](const std::stop_token stop) { flushLoop(stop); });
+        compactor = std::jthread([this](const std::stop_token stop) { compactLoop(stop); });
+    }
+
+    TieredThreadByteTree::~TieredThreadByteTree() {
+        try {
+            flush();
+        } catch (...) {
+            // Reported to the writers and flush() callers that observed the failure.
+        }
+        compactor.request_stop();
+        flusher.request_stop();
+        compactor.join();
+        flusher.join();
+    }
+
+    std::string TieredThreadByteTree::runPath(const std::uint64_t number, const char* suffix) const {
+        char name[48];
+        std::snprintf(name, sizeof(name), "run-%06llu%s", static_cast<unsigned long long>(number), suffix);
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    std::shared_ptr<TieredThreadByteTree::Run> TieredThreadByteTree::openRun(const std::uint64_t number) const {
+        auto run = std::make_shared<Run>(number, runPath(number, ".sst"));
+        try {
+            std::ifstream in(runPath(number, ".filter"), std::ios::binary);
+            const ByteVector bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            run->Filter = BloomFilter::Decode(bytes);
+        } catch (const std::runtime_error&) {
+            // A missing or damaged filter is only an accelerator: rebuild it from the run.
+            run->Filter = BloomFilter(static_cast<std::size_t>(run->Table.Size()), options.BloomBitsPerKey);
+            auto it = run->Table.NewIterator();
+            for (it.SeekToFirst(); it.Valid(); it.Next()) {
+                run->Filter.Add(ByteVectorHash(it.Key()));
+            }
+        }
+        return run;
+    }
+
+    void TieredThreadByteTree::writeManifest(const std::vector<std::shared_ptr<Run>>& runs) {
+        std::ostringstream out;
+        out << ManifestHeader << "\nnext " << nextRunNumber << "\n";
+        for (const auto& run : runs) {
+            out << "run " << run->Number << "\n";
+        }
+        writeFileAtomically(std::filesystem::path(directory) / ManifestName, AsBytes(out.str()));
+    }
+
+    std::shared_ptr<const TieredThreadByteTree::Version> TieredThreadByteTree::acquire() const {
+        std::lock_guard<std::mutex> lock(stateMux);
+        return current;
+    }
+
+    void TieredThreadByteTree::publish(std::shared_ptr<const Version> next) {
+        published.store(next.get(), std::memory_order_release);
+        // Read the epoch only after the store, as EpochManager::Retire does for unlinked objects:
+        // a reader that can still see the old Version is pinned at that epoch or an older one.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        retiredVersions.emplace_back(readers.Epoch(), std::move(current));
+        current = std::move(next);
+        reclaimVersions();
+    }
+
+    void TieredThreadByteTree::reclaimVersions() {
+        // Same rule as EpochManager's own limbo lists: safe once the epoch moved two steps on.
+        readers.Collect();
+        const std::uint64_t epoch = readers.Epoch();
+        std::erase_if(retiredVersions, [epoch](const auto& retired) { return retired.first + 2 <= epoch; });
+    }
+
+    void TieredThreadByteTree::write(const ByteView key, const ByteView value, const bool tombstone) {
+        thread_local ByteVector tagged;
+        tagged.assign(1, tombstone ? TombstoneTag : ValueTag);
+        tagged.insert(tagged.end(), value.begin(), value.end());
+
+        std::size_t bytes;
+        {
+            std::shared_lock<std::shared_mutex> gate(writeGate);
+            active->Insert(key, tagged);
+            const std::size_t added = key.size() + tagged.size() + EntryOverhead;
+            bytes = activeBytes.fetch_add(added, std::memory_order_relaxed) + added;
+        }
+        if (bytes >= options.MemtableBytes) {
+            freeze(false);
+        }
+    }
+
+    void TieredThreadByteTree::freeze(const bool force) {
+        std::unique_lock<std::shared_mutex> gate(writeGate);
+        const std::size_t bytes = activeBytes.load(std::memory_order_relaxed);
+        if (bytes == 0 || (!force && bytes < options.MemtableBytes)) {
+            return; // nothing written, or another writer froze it first
+        }
+
+        std::unique_lock<std::mutex> lock(stateMux);
+        if (current->Frozen.size() >= options.MaxFrozen && !failure) {
+            // Writers stay blocked on the gate meanwhile: memory is bounded by MaxFrozen + 1 memtables.
+            stalls.fetch_add(1, std::memory_order_relaxed);
+            changed.wait(lock, [&] { return current->Frozen.size() < options.MaxFrozen || failure; });
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+
+        auto next = std::make_shared<Version>(*current);
+        next->Frozen.insert(next->Frozen.begin(), next->Active);
+        next->Active = std::make_shared<List>(options.MaxLevel, options.Probability, options.Mode);
+        active = next->Active.get();
+        activeBytes.store(0, std::memory_order_relaxed);
+        publish(std::move(next));
+        changed.notify_all();
+    }
+
+    void TieredThreadByteTree::flushLoop(const std::stop_token stop) {
+        while (true) {
+            std::shared_ptr<List> memtable;
+            bool dropTombstones;
+            {
+                std::unique_lock<std::mutex> lock(stateMux);
+                while (current->Frozen.empty()) {
+                    if (stop.stop_requested()) {
+                        return;
+                    }
+                    // A Version replaced by the last flush or compaction usually outlives its own
+                    // publish, as a reader may still pin the old epoch: free it here rather than
+                    // at the next publish, which an idle store may never reach.
+                    reclaimVersions();
+                    if (retiredVersions.empty()) {
+                        changed.wait(lock, stop, [&] { return !current->Frozen.empty() || !retiredVersions.empty(); });
+                    } else {
+                        changed.wait_for(lock, stop, ReclaimRetry, [&] { return !current->Frozen.empty(); });
+                    }
+                }
+                memtable = current->Frozen.back();
+                // The oldest memtable goes first and only this thread adds runs: with none yet,
+                // its tombstones have nothing left to hide.
+                dropTombstones = current->Runs.empty();
+            }
+
+            try {
+                std::uint64_t number;
+                {
+                    std::lock_guard<std::mutex> install(installMux);
+                    number = nextRunNumber++;
+                }
+                MergingIterator it;
+                it.Add(std::make_unique<ListSource>(*memtable, ByteView{}, ByteView{}));
+                writeRun(it, runPath(number, ".sst"), runPath(number, ".filter"), dropTombstones, options.BloomBitsPerKey, std::stop_token{});
+                std::shared_ptr<Run> run = openRun(number);
+
+                std::lock_guard<std::mutex> install(installMux);
+                std::vector<std::shared_ptr<Run>> runs{run};
+                const auto runsBefore = acquire()->Runs;
+                runs.insert(runs.end(), runsBefore.begin(), runsBefore.end());
+                writeManifest(runs);
+
+                std::lock_guard<std::mutex> lock(stateMux);
+                auto next = std::make_shared<Version>(*current);
+                next->Frozen.pop_back();
+                next->Runs = std::move(runs);
+                publish(std::move(next));
+                flushes.fetch_add(1, std::memory_order_relaxed);
+                changed.notify_all();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMux);
+                failure = std::current_exception();
+                changed.notify_all();
+                return;
+            }
+        }
+    }
+
+    void TieredThreadByteTree::compactLoop(const std::stop_token stop) {
+        while (true) {
+            std::vector<std::shared_ptr<Run>> runs;
+            std::pair<std::size_t, std::size_t> window;
+            bool includesOldest;
+            {
+                std::unique_lock<std::mutex> lock(stateMux);
+                const bool picked = changed.wait(lock, stop, [&] {
+                    const auto choice = pickCompaction(current->Runs, options.CompactionTrigger);
+                    if (choice) {
+                        window = *choice;
+                    }
+                    return choice.has_value() && !failure;
+                });
+                if (!picked) {
+                    return;
+                }
+                runs.assign(current->Runs.begin() + static_cast<std::ptrdiff_t>(window.first),
+                            current->Runs.begin() + static_cast<std::ptrdiff_t>(window.second));
+                // The flusher only adds runs in front, so a window reaching the oldest run keeps it:
+                // tombstones merged into it have nothing left to hide.
+                includesOldest = window.second == current->Runs.size();
+            }
+
+            try {
+                std::uint64_t number;
+                {
+                    std::lock_guard<std::mutex> install(installMux);
+                    number = nextRunNumber++;
+                }
+                MergingIterator it;
+                for (const auto& run : runs) {
+                    it.Add(std::make_unique<RunSource>(run->Table, ByteView{}));
+                }
+                if (!writeRun(it, runPath(number, ".sst"), runPath(number, ".filter"), includesOldest, options.BloomBitsPerKey, stop)) {
+                    return;
+                }
+                std::shared_ptr<Run> merged = openRun(number);
+
+                {
+                    std::lock_guard<std::mutex> install(installMux);
+                    std::vector<std::shared_ptr<Run>> next = acquire()->Runs;
+                    const auto first = std::find(next.begin(), next.end(), runs.front());
+                    const auto position = next.erase(first, first + static_cast<std::ptrdiff_t>(runs.size()));
+                    next.insert(position, merged);
+                    writeManifest(next);
+
+                    std::lock_guard<std::mutex> lock(stateMux);
+                    auto version = std::make_shared<Version>(*current);
+                    version->Runs = std::move(next);
+                    publish(std::move(version));
+                    compactions.fetch_add(1, std::memory_order_relaxed);
+                    changed.notify_all();
+                }
+
+                // Readers still holding the old runs keep their mappings after the unlink.
+                for (const auto& run : runs) {
+                    std::filesystem::remove(runPath(run->Number, ".sst"));
+                    std::filesystem::remove(runPath(run->Number, ".filter"));
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMux);
+                failure = std::current_exception();
+                changed.notify_all();
+                return;
+            }
+        }
+    }
+
+    void TieredThreadByteTree::put(const ByteView key, const ByteView value) {
+        write(key, value, false);
+    }
+
+    void TieredThreadByteTree::erase(const ByteView key) {
+        write(key, {}, true);
+    }
+
+    bool TieredThreadByteTree::get_into(const ByteView key, ByteVector& out) const {
+        EpochGuard guard(readers);
+        const Version& version = *published.load(std::memory_order_acquire);
+        if (const ValueView found = version.Active->Find(key)) {
+            return decode(found.View(), out);
+        }
+        for (const auto& memtable : version.Frozen) {
+            if (const ValueView found = memtable->Find(key)) {
+                return decode(found.View(), out);
+            }
+        }
+
+        const std::uint64_t hash = ByteVectorHash(key);
+        ReadCounters& counters = readCounters[ThreadIndex() % readCounters.size()];
+        for (const auto& run : version.Runs) {
+            if (!run->Filter.MayContain(hash)) {
+                counters.FilterSkips.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (const auto found = run->Table.Get(key)) {
+                return decode(*found, out);
+            }
+            counters.FilterFalsePositives.fetch_add(1, std::memory_order_relaxed);
+        }
+        out.clear();
+        return false;
+    }
+
+    ByteVector TieredThreadByteTree::get(const ByteView key) const {
+        ByteVector out;
+        get_into(key, out);
+        return out;
+    }
+
+    std::vector<Entry> TieredThreadByteTree::scan(const ByteView begin, const ByteView end, const std::size_t limit) const {
+        const std::shared_ptr<const Version> version = acquire();
+        MergingIterator it;
+        it.Add(std::make_unique<ListSource>(*version->Active, begin, end));
+        for (const auto& memtable : version->Frozen) {
+            it.Add(std::make_unique<ListSource>(*memtable, begin, end));
+        }
+        for (const auto& run : version->Runs) {
+            it.Add(std::make_unique<RunSource>(run->Table, begin));
+        }
+
+        std::vector<Entry> out;
+        for (; it.Valid() && out.size() < limit; it.Next()) {
+            if (!end.empty() && !ByteVectorLess(it.Key(), end)) {
+                break;
+            }
+            const ByteView value = it.Value();
+            if (value[0] == TombstoneTag) {
+                continue;
+            }
+            out.push_back({ByteVector(it.Key().begin(), it.Key().end()), ByteVector(value.begin() + 1, value.end())});
+        }
+        return out;
+    }
+
+    void TieredThreadByteTree::flush() {
+        freeze(true);
+        std::unique_lock<std::mutex> lock(stateMux);
+        changed.wait(lock, [&] { return current->Frozen.empty() || failure; });
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    TieredStats TieredThreadByteTree::stats() const {
+        std::shared_ptr<const Version> version;
+        std::size_t retired;
+        {
+            std::lock_guard<std::mutex> lock(stateMux);
+            version = current;
+            retired = retiredVersions.size();
+        }
+        std::uint64_t runBytes = 0;
+        for (const auto& run : version->Runs) {
+            runBytes += run->Bytes;
+        }
+        std::uint64_t skips = 0;
+        std::uint64_t falsePositives = 0;
+        for (const ReadCounters& counters : readCounters) {
+            skips += counters.FilterSkips.load(std::memory_order_relaxed);
+            falsePositives += counters.FilterFalsePositives.load(std::memory_order_relaxed);
+        }
+        return {
+            1 + version->Frozen.size(),
+            version->Runs.size(),
+            runBytes,
+            flushes.load(std::memory_order_relaxed),
+            compactions.load(std::memory_order_relaxed),
+            stalls.load(std::memory_order_relaxed),
+            skips,
+            falsePositives,
+            retired
+        };
+    }
+
+}
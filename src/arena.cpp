@@ -0,0 +1,191 @@
+#include "arena.h"
+
+#include "epoch.h"
+
+#include <new>
+#include <thread>
+
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/asan_interface.h>
+// Blocks parked in a free list are poisoned (except the list link) so that ASan builds still
+// report a reader touching a node or value after it was recycled.
+#define TBT_POISON(address, size) ASAN_POISON_MEMORY_REGION(address, size)
+#define TBT_UNPOISON(address, size) ASAN_UNPOISON_MEMORY_REGION(address, size)
+#else
+#define TBT_POISON(address, size) ((void)(address), (void)(size))
+#define TBT_UNPOISON(address, size) ((void)(address), (void)(size))
+#endif
+
+namespace tbt {
+    namespace {
+        class LatchGuard {
+            private:
+                std::atomic_flag& latch;
+
+            public:
+                explicit LatchGuard(std::atomic_flag& latch) : latch(latch) {
+                    while (latch.test_and_set(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                }
+
+                ~LatchGuard() {
+                    latch.clear(std::memory_order_release);
+                }
+
+                LatchGuard(const LatchGuard&) = delete;
+                LatchGuard& operator=(const LatchGuard&) = delete;
+        };
+
+        constexpr std::size_t roundUp(const std::size_t size, const std::size_t alignment) {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        constexpr std::size_t LargeHeaderSize = roundUp(3 * sizeof(void*), Arena::Alignment);
+    }
+
+    std::size_t Arena::classOf(const std::size_t size) {
+        if (size <= 256) {
+            return (size + 15) / 16 - 1;
+        }
+        std::size_t sizeClass = 16;
+        for (std::size_t limit = 512; limit < size; limit <<= 1) {
+            sizeClass++;
+        }
+        return sizeClass;
+    }
+
+    std::size_t Arena::classSize(const std::size_t sizeClass) {
+        if (sizeClass < 16) {
+            return (sizeClass + 1) * 16;
+        }
+        return std::size_t{512} << (sizeClass - 16);
+    }
+
+    Arena::~Arena() {
+        Release();
+    }
+
+    Arena::Shard& Arena::localShard() {
+        return shards[ThreadIndex() % ShardCount];
+    }
+
+    char* Arena::newChunk() {
+        auto* chunk = static_cast<char*>(::operator new(ChunkSize, std::align_val_t{Alignment}));
+        std::lock_guard<std::mutex> lock(chunkMux);
+        chunks.push_back(chunk);
+        return chunk;
+    }
+
+    void* Arena::Allocate(const std::size_t size) {
+        if (size > MaxSmallSize) {
+            auto* raw = static_cast<char*>(::operator new(LargeHeaderSize + size, std::align_val_t{Alignment}));
+            auto* block = new (raw) LargeBlock{nullptr, nullptr, size};
+            std::lock_guard<std::mutex> lock(chunkMux);
+            block->next = largeBlocks;
+            if (largeBlocks != nullptr) {
+                largeBlocks->prev = block;
+            }
+            largeBlocks = block;
+            largeBytes += size;
+            return raw + LargeHeaderSize;
+        }
+
+        const std::size_t sizeClass = classOf(size);
+        const std::size_t blockSize = classSize(sizeClass);
+        Shard& shard = localShard();
+        LatchGuard guard(shard.latch);
+
+        void* block = nullptr;
+        if (FreeBlock* recycled = shard.freeLists[sizeClass]; recycled != nullptr) {
+            shard.freeLists[sizeClass] = recycled->next;
+            TBT_UNPOISON(recycled, blockSize);
+            shard.freeListBytes.store(shard.freeListBytes.load(std::memory_order_relaxed) - blockSize, std::memory_order_relaxed);
+            block = recycled;
+        } else {
+            if (static_cast<std::size_t>(shard.end - shard.cursor) < blockSize) {
+                // The tail of the old chunk is abandoned; it is at most one block of waste.
+                shard.cursor = newChunk();
+                shard.end = shard.cursor + ChunkSize;
+            }
+            block = shard.cursor;
+            shard.cursor += blockSize;
+        }
+        shard.usedBytes.store(shard.usedBytes.load(std::memory_order_relaxed) + blockSize, std::memory_order_relaxed);
+        return block;
+    }
+
+    void Arena::Free(void* block, const std::size_t size) {
+        if (size > MaxSmallSize) {
+            auto* large = reinterpret_cast<LargeBlock*>(static_cast<char*>(block) - LargeHeaderSize);
+            {
+                std::lock_guard<std::mutex> lock(chunkMux);
+                if (large->prev != nullptr) {
+                    large->prev->next = large->next;
+                } else {
+                    largeBlocks = large->next;
+                }
+                if (large->next != nullptr) {
+                    large->next->prev = large->prev;
+                }
+                largeBytes -= large->size;
+            }
+            ::operator delete(large, std::align_val_t{Alignment});
+            return;
+        }
+
+        const std::size_t sizeClass = classOf(size);
+        const std::size_t blockSize = classSize(sizeClass);
+        Shard& shard = localShard();
+        LatchGuard guard(shard.latch);
+        shard.freeLists[sizeClass] = new (block) FreeBlock{shard.freeLists[sizeClass]};
+        TBT_POISON(static_cast<char*>(block) + sizeof(FreeBlock), blockSize - sizeof(FreeBlock));
+        shard.freeListBytes.store(shard.freeListBytes.load(std::memory_order_relaxed) + blockSize, std::memory_order_relaxed);
+        // A block may be freed by another thread's shard than the one that allocated it,
+        // so per-shard usage can go negative; only the sum is meaningful.
+        shard.usedBytes.store(shard.usedBytes.load(std::memory_order_relaxed) - blockSize, std::memory_order_relaxed);
+    }
+
+    void Arena::Release() {
+        std::lock_guard<std::mutex> lock(chunkMux);
+        for (char* chunk : chunks) {
+            TBT_UNPOISON(chunk, ChunkSize);
+            ::operator delete(chunk, std::align_val_t{Alignment});
+        }
+        chunks.clear();
+        while (largeBlocks != nullptr) {
+            LargeBlock* next = largeBlocks->next;
+            ::operator delete(largeBlocks, std::align_val_t{Alignment});
+            largeBlocks = next;
+        }
+        largeBytes = 0;
+
+        for (Shard& shard : shards) {
+            shard.cursor = nullptr;
+            shard.end = nullptr;
+            for (FreeBlock*& head : shard.freeLists) {
+                head = nullptr;
+            }
+            shard.usedBytes.store(0, std::memory_order_relaxed);
+            shard.freeListBytes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ArenaStats Arena::Stats() const {
+        std::size_t used = 0;
+        std::size_t free = 0;
+        for (const Shard& shard : shards) {
+            used += shard.usedBytes.load(std::memory_order_relaxed);
+            free += shard.freeListBytes.load(std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(chunkMux);
+        return {
+            chunks.size() * ChunkSize + largeBytes,
+            used + largeBytes,
+            free,
+            largeBytes,
+            chunks.size()
+        };
+    }
+}
@@ -1,28 +1,74 @@
 #include "comparator.h"
 
+#include <bit>
+#include <cstring>
+
 namespace tbt {
-	bool ByteVectorLess(const ByteVector& leftHand, const ByteVector& rightHand) noexcept {
+	namespace {
+		std::uint64_t loadWord(const std::uint8_t* bytes) noexcept {
+			std::uint64_t word;
+			std::memcpy(&word, bytes, sizeof(word));
+			return word;
+		}
+
+		std::uint64_t loadBigEndian(const std::uint8_t* bytes) noexcept {
+			const std::uint64_t word = loadWord(bytes);
+			if constexpr (std::endian::native == std::endian::little) {
+				return std::byteswap(word);
+			}
+			return word;
+		}
+	}
+
+	// Most keys differ within their first eight bytes, which one word compare settles without a
+	// call. Longer common runs go to memcmp, which the C library already dispatches to an
+	// SSE2/AVX2/NEON implementation for the running CPU.
+	bool ByteVectorLess(const ByteView leftHand, const ByteView rightHand) noexcept {
 		const std::size_t leftSize = leftHand.size(), rightSize = rightHand.size();
+		const std::size_t common = leftSize < rightSize ? leftSize : rightSize;
+		std::size_t offset = 0;
+
+		if (common >= 8) {
+			const std::uint64_t left = loadBigEndian(leftHand.data());
+			const std::uint64_t right = loadBigEndian(rightHand.data());
+			if (left != right) {
+				return left < right;
+			}
+			offset = 8;
+		}
 
-		for (std::size_t iterate = 0; iterate < leftSize && iterate < rightSize; ++iterate) {
-			if (leftHand[iterate] < rightHand[iterate]) return true;
-			if (leftHand[iterate] > rightHand[iterate]) return false;
+		if (common > offset) {
+			const int order = std::memcmp(leftHand.data() + offset, rightHand.data() + offset, common - offset);
+			if (order != 0) {
+				return order < 0;
+			}
 		}
 
 		return leftSize < rightSize;
 	}
 
-	bool ByteVectorEqual(const ByteVector& leftHand, const ByteVector& rightHand) noexcept{
-		if (leftHand.size() != rightHand.size()) {
+	bool ByteVectorEqual(const ByteView leftHand, const ByteView rightHand) noexcept{
+		const std::size_t size = leftHand.size();
+		if (size != rightHand.size()) {
 			return false;
 		}
 
-		for (std::size_t iterate = 0; iterate < leftHand.size(); ++iterate) {
-			if (leftHand[iterate] != rightHand[iterate]) {
-				return false;
-			}
+		if (size >= 8) {
+			return loadWord(leftHand.data()) == loadWord(rightHand.data())
+				&& std::memcmp(leftHand.data() + 8, rightHand.data() + 8, size - 8) == 0;
+		}
+		return size == 0 || std::memcmp(leftHand.data(), rightHand.data(), size) == 0;
+	}
+
+	std::uint64_t ByteVectorPrefix(const ByteView bytes) noexcept {
+		if (bytes.size() >= 8) {
+			return loadBigEndian(bytes.data());
 		}
 
-		return true;
+		std::uint64_t prefix = 0;
+		for (std::size_t iterate = 0; iterate < 8; ++iterate) {
+			prefix = (prefix << 8) | (iterate < bytes.size() ? bytes[iterate] : 0u);
+		}
+		return prefix;
 	}
-}
\ No newline at end of file
+}
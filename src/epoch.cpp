@@ -0,0 +1,204 @@
+#include "epoch.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace tbt {
+    namespace {
+        // Live domains by id. Exiting threads consult it before touching a domain, and a
+        // domain leaves it before freeing its participants.
+        struct Registry {
+            std::mutex mux;
+            std::unordered_set<std::uint64_t> live;
+            std::uint64_t nextId = 1;
+        };
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+    }
+
+    struct EpochManager::ThreadCache {
+        struct Entry {
+            EpochManager* manager;
+            std::uint64_t id;
+            Participant* participant;
+        };
+
+        std::vector<Entry> entries;
+        std::uint64_t lastId = 0;
+        Participant* last = nullptr;
+
+        ~ThreadCache() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mux);
+            for (const Entry& entry : entries) {
+                if (reg.live.contains(entry.id)) {
+                    entry.manager->release(entry.participant);
+                }
+            }
+        }
+    };
+
+    EpochManager::EpochManager() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mux);
+        id = reg.nextId++;
+        reg.live.insert(id);
+    }
+
+    EpochManager::~EpochManager() {
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mux);
+            reg.live.erase(id);
+        }
+
+        ReclaimAll();
+        Participant* current = participants.load(std::memory_order_acquire);
+        while (current != nullptr) {
+            Participant* next = current->next;
+            delete current;
+            current = next;
+        }
+    }
+
+    EpochManager::Participant* EpochManager::local() {
+        thread_local ThreadCache cache;
+        if (cache.lastId == id) {
+            return cache.last;
+        }
+
+        auto found = std::find_if(cache.entries.begin(), cache.entries.end(),
+                                  [this](const ThreadCache::Entry& entry) { return entry.id == id; });
+        if (found == cache.entries.end()) {
+            {
+                // Drop entries of domains destroyed since this thread last used them.
+                Registry& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mux);
+                std::erase_if(cache.entries, [&reg](const ThreadCache::Entry& entry) {
+                    return !reg.live.contains(entry.id);
+                });
+            }
+            cache.entries.push_back({this, id, acquire()});
+            found = cache.entries.end() - 1;
+        }
+
+        cache.lastId = id;
+        cache.last = found->participant;
+        return cache.last;
+    }
+
+    EpochManager::Participant* EpochManager::acquire() {
+        for (Participant* current = participants.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+            bool expected = false;
+            if (current->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return current;
+            }
+        }
+
+        auto* participant = new Participant();
+        Participant* head = participants.load(std::memory_order_relaxed);
+        do {
+            participant->next = head;
+        } while (!participants.compare_exchange_weak(head, participant, std::memory_order_release, std::memory_order_relaxed));
+        return participant;
+    }
+
+    void EpochManager::release(Participant* participant) {
+        if (!participant->limbo.empty()) {
+            std::lock_guard<std::mutex> lock(orphanMux);
+            orphans.insert(orphans.end(), participant->limbo.begin(), participant->limbo.end());
+            participant->limbo.clear();
+        }
+        participant->depth = 0;
+        participant->state.store(0, std::memory_order_release);
+        participant->claimed.store(false, std::memory_order_release);
+    }
+
+    bool EpochManager::tryAdvance() {
+        std::uint64_t epoch = globalEpoch.load(std::memory_order_seq_cst);
+        for (Participant* current = participants.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+            const std::uint64_t state = current->state.load(std::memory_order_seq_cst);
+            if ((state & 1) != 0 && (state >> 1) != epoch) {
+                return false;
+            }
+        }
+        return globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    void EpochManager::reclaim(std::vector<Retired>& retired, const std::uint64_t safeEpoch) {
+        auto pending = std::partition(retired.begin(), retired.end(),
+                                      [safeEpoch](const Retired& item) { return item.epoch + 2 > safeEpoch; });
+        for (auto it = pending; it != retired.end(); ++it) {
+            it->deleter(it->object, it->context);
+        }
+        retired.erase(pending, retired.end());
+    }
+
+    void EpochManager::Enter() {
+        Participant* participant = local();
+        if (participant->depth++ == 0) {
+            const std::uint64_t epoch = globalEpoch.load(std::memory_order_relaxed);
+            participant->state.store((epoch << 1) | 1, std::memory_order_relaxed);
+            // Publish the pin before any shared pointer is read.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void EpochManager::Exit() {
+        Participant* participant = local();
+        if (--participant->depth == 0) {
+            participant->state.store(participant->state.load(std::memory_order_relaxed) & ~std::uint64_t{1}, std::memory_order_release);
+            if (participant->limbo.size() >= CollectThreshold) {
+                Collect();
+            }
+        }
+    }
+
+    void EpochManager::Retire(void* object, const Deleter deleter, void* context) {
+        Participant* participant = local();
+        // Tag with the epoch observed after the object was unlinked: it is freed once the
+        // global epoch has moved two steps past it.
+        participant->limbo.push_back({object, deleter, context, globalEpoch.load(std::memory_order_seq_cst)});
+    }
+
+    void EpochManager::Collect() {
+        tryAdvance();
+        tryAdvance();
+        const std::uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+
+        reclaim(local()->limbo, epoch);
+
+        std::unique_lock<std::mutex> lock(orphanMux, std::try_to_lock);
+        if (lock.owns_lock() && !orphans.empty()) {
+            reclaim(orphans, epoch);
+        }
+    }
+
+    void EpochManager::ReclaimAll() {
+        for (Participant* current = participants.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+            for (const Retired& retired : current->limbo) {
+                retired.deleter(retired.object, retired.context);
+            }
+            current->limbo.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(orphanMux);
+        for (const Retired& retired : orphans) {
+            retired.deleter(retired.object, retired.context);
+        }
+        orphans.clear();
+    }
+
+    std::uint64_t EpochManager::Epoch() const noexcept {
+        return globalEpoch.load(std::memory_order_acquire);
+    }
+
+    std::size_t ThreadIndex() noexcept {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+}
@@ -0,0 +1,176 @@
+#include "filter.h"
+
+#include "epoch.h"
+#include "hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace tbt {
+    namespace {
+        constexpr std::size_t BlockBits = 512;
+        constexpr std::size_t HeaderSize = 12;
+        constexpr std::size_t BlockCounters = 128;
+        constexpr std::uint64_t CounterMax = 15;
+
+        // Counter index of the next probe. Stepping by a fixed delta, as BloomFilter does, gives
+        // keys with overlapping probe sets in a block of only 128 counters; remixing does not.
+        std::uint32_t nextCounter(std::uint32_t& mix) {
+            mix = mix * 0x9E3779B1u + 0x7F4A7C15u;
+            return mix >> 25;
+        }
+    }
+
+    BloomFilter::BloomFilter(const std::size_t keys, const std::size_t bitsPerKey) {
+        const std::size_t bits = std::max<std::size_t>(keys, 1) * std::max<std::size_t>(bitsPerKey, 1);
+        blocks.resize((bits + BlockBits - 1) / BlockBits, Block{});
+        // k = bits per key * ln 2 minimizes the false-positive rate; blocking costs a little on top.
+        probes = static_cast<std::uint32_t>(std::clamp(std::lround(static_cast<double>(bitsPerKey) * 0.69), 1l, 16l));
+    }
+
+    void BloomFilter::Add(const std::uint64_t hash) {
+        Block& block = blocks[blockOf(hash)];
+        auto bit = static_cast<std::uint32_t>(hash);
+        const std::uint32_t delta = std::rotr(bit, 17);
+        for (std::uint32_t i = 0; i < probes; i++) {
+            const std::uint32_t position = bit % BlockBits;
+            block.Words[position / 64] |= std::uint64_t{1} << (position % 64);
+            bit += delta;
+        }
+    }
+
+    bool BloomFilter::MayContain(const std::uint64_t hash) const {
+        if (blocks.empty()) {
+            return false;
+        }
+        const Block& block = blocks[blockOf(hash)];
+        auto bit = static_cast<std::uint32_t>(hash);
+        const std::uint32_t delta = std::rotr(bit, 17);
+        for (std::uint32_t i = 0; i < probes; i++) {
+            const std::uint32_t position = bit % BlockBits;
+            if ((block.Words[position / 64] & (std::uint64_t{1} << (position % 64))) == 0) {
+                return false;
+            }
+            bit += delta;
+        }
+        return true;
+    }
+
+    ByteVector BloomFilter::Encode() const {
+        ByteVector out;
+        out.reserve(HeaderSize + SizeBytes() + 4);
+        PutFixed(out, probes, 4);
+        PutFixed(out, blocks.size(), 8);
+        for (const Block& block : blocks) {
+            for (const std::uint64_t word : block.Words) {
+                PutFixed(out, word, 8);
+            }
+        }
+        PutFixed(out, Crc32c(out), 4);
+        return out;
+    }
+
+    BloomFilter BloomFilter::Decode(const ByteView bytes) {
+        if (bytes.size() < HeaderSize + 4) {
+            ThrowCorrupt("filter", "too short");
+        }
+        const std::uint64_t count = GetFixed(bytes.data() + 4, 8);
+        if (count > (bytes.size() - HeaderSize - 4) / sizeof(Block) || bytes.size() != HeaderSize + count * sizeof(Block) + 4) {
+            ThrowCorrupt("filter", "bad size");
+        }
+        if (Crc32c(bytes.first(bytes.size() - 4)) != static_cast<std::uint32_t>(GetFixed(bytes.data() + bytes.size() - 4, 4))) {
+            ThrowCorrupt("filter", "checksum mismatch");
+        }
+
+        BloomFilter filter;
+        filter.probes = static_cast<std::uint32_t>(GetFixed(bytes.data(), 4));
+        filter.blocks.resize(static_cast<std::size_t>(count));
+        const std::uint8_t* in = bytes.data() + HeaderSize;
+        for (Block& block : filter.blocks) {
+            for (std::uint64_t& word : block.Words) {
+                word = GetFixed(in, 8);
+                in += 8;
+            }
+        }
+        return filter;
+    }
+
+    CountingBloomFilter::CountingBloomFilter(const std::size_t expectedKeys, const double falsePositiveRate) {
+        if (expectedKeys == 0) {
+            throw std::invalid_argument("filter must expect at least one key");
+        }
+        if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0)) {
+            throw std::invalid_argument("false-positive rate must be between 0 and 1");
+        }
+        // An ideal filter needs log2(1/rate) / ln 2 counters per key. Small blocks are loaded
+        // unevenly, which hurts more the lower the rate; 5% more per halving of it makes up for that.
+        const double bits = std::log2(1.0 / falsePositiveRate);
+        const double perKey = bits / 0.69;
+        const auto counters = static_cast<std::size_t>(std::ceil(perKey * (1.0 + 0.05 * bits)));
+        blockCount = (expectedKeys * counters + BlockCounters - 1) / BlockCounters;
+        blocks = std::make_unique<Block[]>(blockCount);
+        probes = static_cast<std::uint32_t>(std::clamp(std::lround(perKey * 0.69), 1l, 16l));
+    }
+
+    template <typename Update>
+    void CountingBloomFilter::update(const std::uint64_t hash, Update step) {
+        Block& block = blocks[blockOf(hash)];
+        auto mix = static_cast<std::uint32_t>(hash);
+        for (std::uint32_t i = 0; i < probes; i++) {
+            const std::uint32_t position = nextCounter(mix);
+            std::atomic<std::uint64_t>& word = block.Words[position / 16];
+            const unsigned shift = 4 * (position % 16);
+            std::uint64_t current = word.load(std::memory_order_relaxed);
+            while (true) {
+                const std::uint64_t counter = (current >> shift) & CounterMax;
+                if (counter == CounterMax) {
+                    break; // saturated: no longer known exactly, so never decremented
+                }
+                const std::uint64_t next = step(counter);
+                if (next == counter || word.compare_exchange_weak(current, (current & ~(CounterMax << shift)) | (next << shift),
+                                                                  std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+        }
+    }
+
+    void CountingBloomFilter::Add(const std::uint64_t hash) {
+        update(hash, [](const std::uint64_t counter) { return counter + 1; });
+    }
+
+    void CountingBloomFilter::Remove(const std::uint64_t hash) {
+        update(hash, [](const std::uint64_t counter) { return counter == 0 ? counter : counter - 1; });
+    }
+
+    bool CountingBloomFilter::MayContain(const std::uint64_t hash) const {
+        const Block& block = blocks[blockOf(hash)];
+        auto mix = static_cast<std::uint32_t>(hash);
+        for (std::uint32_t i = 0; i < probes; i++) {
+            const std::uint32_t position = nextCounter(mix);
+            if (((block.Words[position / 16].load(std::memory_order_acquire) >> (4 * (position % 16))) & CounterMax) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void CountingBloomFilter::RecordLookup(const bool passed, const bool found) const {
+        Outcomes& stripe = outcomes[ThreadIndex() % OutcomeStripes];
+        std::atomic<std::uint64_t>& counter = !passed ? stripe.Negatives : found ? stripe.Hits : stripe.FalsePositives;
+        // Threads map to different stripes, so the line is rarely shared with another thread.
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FilterStats CountingBloomFilter::Stats() const {
+        FilterStats stats{};
+        for (const Outcomes& stripe : outcomes) {
+            stats.Negatives += stripe.Negatives.load(std::memory_order_relaxed);
+            stats.Hits += stripe.Hits.load(std::memory_order_relaxed);
+            stats.FalsePositives += stripe.FalsePositives.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,83 @@
+#include "hash.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace tbt {
+    namespace {
+        constexpr std::uint64_t Seed = 0x9E3779B97F4A7C15ull;
+        constexpr std::uint64_t MultiplyA = 0xBF58476D1CE4E5B9ull;
+        constexpr std::uint64_t MultiplyB = 0x94D049BB133111EBull;
+
+        std::uint64_t mix(std::uint64_t word) {
+            word *= MultiplyA;
+            word ^= word >> 31;
+            word *= MultiplyB;
+            return word;
+        }
+
+        constexpr std::array<std::uint32_t, 256> CrcTable = [] {
+            std::array<std::uint32_t, 256> table{};
+            for (std::uint32_t byte = 0; byte < 256; byte++) {
+                std::uint32_t crc = byte;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ ((crc & 1) != 0 ? 0x82F63B78u : 0u);
+                }
+                table[byte] = crc;
+            }
+            return table;
+        }();
+    }
+
+    std::uint64_t ByteVectorHash(const ByteView bytes) noexcept {
+        const std::size_t size = bytes.size();
+        const uint8_t* data = bytes.data();
+        std::uint64_t hash = Seed ^ (static_cast<std::uint64_t>(size) * MultiplyA);
+
+        std::size_t offset = 0;
+        for (; offset + sizeof(std::uint64_t) <= size; offset += sizeof(std::uint64_t)) {
+            std::uint64_t word;
+            std::memcpy(&word, data + offset, sizeof(word));
+            hash = std::rotl(hash ^ mix(word), 27) * MultiplyA;
+        }
+        if (offset < size) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, data + offset, size - offset);
+            hash = std::rotl(hash ^ mix(word), 27) * MultiplyA;
+        }
+
+        hash ^= hash >> 33;
+        hash *= MultiplyB;
+        hash ^= hash >> 29;
+        return hash;
+    }
+
+    std::uint32_t Crc32c(const ByteView bytes, std::uint32_t crc) noexcept {
+        crc = ~crc;
+        for (const std::uint8_t byte : bytes) {
+            crc = CrcTable[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void PutFixed(ByteVector& out, std::uint64_t value, const int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out.push_back(static_cast<std::uint8_t>(value));
+            value >>= 8;
+        }
+    }
+
+    std::uint64_t GetFixed(const std::uint8_t* in, const int bytes) noexcept {
+        std::uint64_t value = 0;
+        for (int i = bytes; i-- > 0;) {
+            value = (value << 8) | in[i];
+        }
+        return value;
+    }
+
+    void ThrowCorrupt(const char* format, const std::string& what) {
+        throw std::runtime_error(std::string(format) + " is corrupt: " + what);
+    }
+}
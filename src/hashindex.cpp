@@ -0,0 +1,121 @@
+#include "hashindex.h"
+
+#include "skiplist.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace tbt {
+    namespace {
+        constexpr std::uint64_t Empty = 0;
+        constexpr std::uint64_t Tombstone = 1; // nodes are aligned, so no entry has this value
+        constexpr unsigned TagShift = 48;
+        constexpr std::uint64_t PointerMask = (std::uint64_t{1} << TagShift) - 1;
+        // Eight cache lines; at half load a probe sequence is rarely longer than a few slots.
+        constexpr std::size_t MaxProbes = 64;
+
+        std::uint64_t tagOf(const std::uint64_t hash) {
+            return hash >> TagShift;
+        }
+
+        Node* nodeOf(const std::uint64_t slot) {
+            return reinterpret_cast<Node*>(slot & PointerMask);
+        }
+
+        bool sameKey(const Node* node, const ByteView key) {
+            const ByteView stored = node->Key();
+            return stored.size() == key.size() && (key.empty() || std::memcmp(stored.data(), key.data(), key.size()) == 0);
+        }
+    }
+
+    HashIndex::HashIndex(const std::size_t expectedKeys) {
+        if (expectedKeys == 0) {
+            throw std::invalid_argument("index must expect at least one key");
+        }
+        const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(expectedKeys * 2, MaxProbes));
+        slots = std::make_unique<std::atomic<std::uint64_t>[]>(capacity);
+        mask = capacity - 1;
+    }
+
+    Node* HashIndex::Find(const std::uint64_t hash, const ByteView key) const {
+        const std::uint64_t tag = tagOf(hash);
+        for (std::size_t i = 0; i < MaxProbes; i++) {
+            const std::uint64_t slot = slots[(hash + i) & mask].load(std::memory_order_acquire);
+            if (slot == Empty) {
+                return nullptr;
+            }
+            if (slot != Tombstone && (slot >> TagShift) == tag && sameKey(nodeOf(slot), key)) {
+                return nodeOf(slot);
+            }
+        }
+        return nullptr;
+    }
+
+    bool HashIndex::Store(const std::uint64_t hash, Node* node) {
+        const auto pointer = reinterpret_cast<std::uint64_t>(node);
+        if ((pointer & ~PointerMask) != 0) {
+            return false; // the address needs the tag bits; the list alone finds this node
+        }
+        const std::uint64_t entry = (tagOf(hash) << TagShift) | pointer;
+        const ByteView key = node->Key();
+
+        // Look for the key along its whole probe sequence before taking the first free slot, so a
+        // key has one entry; a lost CAS means the sequence changed, and the scan starts over.
+        while (true) {
+            std::atomic<std::uint64_t>* reusable = nullptr;
+            std::uint64_t expected = Empty;
+            bool retry = false;
+            for (std::size_t i = 0; i < MaxProbes && !retry; i++) {
+                std::atomic<std::uint64_t>& slot = slots[(hash + i) & mask];
+                std::uint64_t current = slot.load(std::memory_order_acquire);
+                if (current == Tombstone) {
+                    if (reusable == nullptr) {
+                        reusable = &slot;
+                        expected = Tombstone;
+                    }
+                    continue;
+                }
+                if (current == Empty) {
+                    if (reusable == nullptr) {
+                        reusable = &slot;
+                        expected = Empty;
+                    }
+                    break;
+                }
+                if ((current >> TagShift) == (entry >> TagShift) && sameKey(nodeOf(current), key)) {
+                    if (slot.compare_exchange_strong(current, entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        return true;
+                    }
+                    retry = true;
+                }
+            }
+            if (retry) {
+                continue;
+            }
+            if (reusable == nullptr) {
+                return false;
+            }
+            if (reusable->compare_exchange_strong(expected, entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+
+    void HashIndex::Erase(const std::uint64_t hash, const Node* node) {
+        const std::uint64_t entry = (tagOf(hash) << TagShift) | reinterpret_cast<std::uint64_t>(node);
+        for (std::size_t i = 0; i < MaxProbes; i++) {
+            std::atomic<std::uint64_t>& slot = slots[(hash + i) & mask];
+            std::uint64_t current = slot.load(std::memory_order_acquire);
+            if (current == Empty) {
+                return;
+            }
+            if (current == entry) {
+                // A failed CAS means a newer node of the key replaced this one: nothing to drop.
+                slot.compare_exchange_strong(current, Tombstone, std::memory_order_acq_rel, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#include "merge.h"
+
+#include "hash.h"
+
+#include <stdexcept>
+
+namespace tbt {
+    void MergeAddInt64(const std::optional<ByteView> existing, const ByteView operand, ByteVector& out) {
+        const std::int64_t base = existing.has_value() ? DecodeInt64(*existing) : 0;
+        // Unsigned addition: wraps instead of overflowing.
+        const auto sum = static_cast<std::uint64_t>(base) + static_cast<std::uint64_t>(DecodeInt64(operand));
+        out = EncodeInt64(static_cast<std::int64_t>(sum));
+    }
+
+    void MergeAppend(const std::optional<ByteView> existing, const ByteView operand, ByteVector& out) {
+        out.reserve((existing.has_value() ? existing->size() : 0) + operand.size());
+        if (existing.has_value()) {
+            out.assign(existing->begin(), existing->end());
+        }
+        out.insert(out.end(), operand.begin(), operand.end());
+    }
+
+    ByteVector EncodeInt64(const std::int64_t value) {
+        ByteVector out;
+        out.reserve(8);
+        PutFixed(out, static_cast<std::uint64_t>(value), 8);
+        return out;
+    }
+
+    std::int64_t DecodeInt64(const ByteView bytes) {
+        if (bytes.size() != 8) {
+            throw std::invalid_argument("an int64 value must be 8 bytes long");
+        }
+        return static_cast<std::int64_t>(GetFixed(bytes.data(), 8));
+    }
+}
@@ -0,0 +1,51 @@
+#include "metrics.h"
+
+#include "epoch.h"
+
+namespace tbt {
+    MetricCounters::Stripe& MetricCounters::local() {
+        return stripes[ThreadIndex() % Stripes];
+    }
+
+    void MetricCounters::Linked(const std::size_t height, const std::size_t keyBytes, const std::size_t valueBytes) {
+        Stripe& stripe = local();
+        stripe.Entries.fetch_add(1, std::memory_order_relaxed);
+        stripe.KeyBytes.fetch_add(static_cast<std::int64_t>(keyBytes), std::memory_order_relaxed);
+        stripe.ValueBytes.fetch_add(static_cast<std::int64_t>(valueBytes), std::memory_order_relaxed);
+        stripe.Heights[height - 1].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MetricCounters::Unlinked(const std::size_t height, const std::size_t keyBytes, const std::size_t valueBytes) {
+        // Another thread may have counted the node in: stripes go negative, only sums are meaningful.
+        Stripe& stripe = local();
+        stripe.Entries.fetch_sub(1, std::memory_order_relaxed);
+        stripe.KeyBytes.fetch_sub(static_cast<std::int64_t>(keyBytes), std::memory_order_relaxed);
+        stripe.ValueBytes.fetch_sub(static_cast<std::int64_t>(valueBytes), std::memory_order_relaxed);
+        stripe.Heights[height - 1].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void MetricCounters::Replaced(const std::size_t oldBytes, const std::size_t newBytes) {
+        local().ValueBytes.fetch_add(static_cast<std::int64_t>(newBytes) - static_cast<std::int64_t>(oldBytes), std::memory_order_relaxed);
+    }
+
+    void MetricCounters::Searched(const std::size_t visited) {
+        Stripe& stripe = local();
+        stripe.Searches.fetch_add(1, std::memory_order_relaxed);
+        stripe.NodesVisited.fetch_add(visited, std::memory_order_relaxed);
+    }
+
+    MetricTotals MetricCounters::Totals() const {
+        MetricTotals totals{};
+        for (const Stripe& stripe : stripes) {
+            totals.Entries += stripe.Entries.load(std::memory_order_relaxed);
+            totals.KeyBytes += stripe.KeyBytes.load(std::memory_order_relaxed);
+            totals.ValueBytes += stripe.ValueBytes.load(std::memory_order_relaxed);
+            totals.Searches += stripe.Searches.load(std::memory_order_relaxed);
+            totals.NodesVisited += stripe.NodesVisited.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < MetricTotals::MaxHeights; i++) {
+                totals.Heights[i] += stripe.Heights[i].load(std::memory_order_relaxed);
+            }
+        }
+        return totals;
+    }
+}
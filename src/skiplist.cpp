@@ -1,9 +1,10 @@
 #include "skiplist.h"
 
+#include <cstring>
+#include <limits>
+#include <new>
 #include <stdexcept>
 #include <random>
-#include <shared_mutex>
-#include <mutex>
 
 namespace tbt {
     bool checkProbability(const float probability) {
@@ -16,155 +17,75 @@ namespace tbt {
         return distribution(generator) < probability;
     }
 
-    void List::clear() const {
-        Node* current = head -> Forward[0];
-        while (current != nullptr) {
-            Node *next = current->Forward[0];
-            delete current;
-            current = next;
+    namespace detail {
+        void deleteNode(void* object, void* context) {
+            auto* node = static_cast<Node*>(object);
+            static_cast<Arena*>(context)->Free(node, node->AllocationSize());
         }
-    }
 
-    List::List(const std::size_t maxLevel, const float probability) {
-        if (!checkProbability(probability)) {
-            throw std::invalid_argument("probability must be between 0 and 1");
+        void deleteValue(void* object, void* context) {
+            auto* value = static_cast<ValueBuffer*>(object);
+            static_cast<Arena*>(context)->Free(value->Block(), value->AllocationSize());
         }
-
-        head = new Node(ByteVector(), ByteVector(), maxLevel);
-        this->maxLevel = maxLevel;
-        this->currentLevel = 0;
-        this->probability = probability;
-    }
-
-    List::~List() {
-        std::unique_lock<std::shared_mutex> lock(mux);
-        clear();
-        delete head;
     }
 
-    ByteVector List::Search(const ByteVector &key) const {
-        std::shared_lock<std::shared_mutex> lock(mux);
-        Node *current = head;
-        for (std::size_t i = currentLevel + 1; i-- > 0;) {
-            while (current->Forward[i] != nullptr && ByteVectorLess(current->Forward[i]->Key, key)) {
-                current = current->Forward[i];
+    namespace {
+        std::uint32_t checkedSize(const std::size_t size) {
+            if (size > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error("keys and values are limited to 4 GiB");
             }
+            return static_cast<std::uint32_t>(size);
         }
-        Node* next = current->Forward[0];
-        if (next != nullptr && ByteVectorEqual(next->Key, key)) {
-            return next->Value;
+
+        constexpr std::size_t roundUp(const std::size_t size, const std::size_t alignment) {
+            return (size + alignment - 1) / alignment * alignment;
         }
-        return {};
     }
 
-    void List::Insert(const ByteVector& key, const ByteVector& value) {
-        std::unique_lock<std::shared_mutex> lock(mux);
-
-        std::size_t newLevel = 0;
-        while ((newLevel + 1) < maxLevel && toss(probability)) {
-            newLevel++;
-        }
+    ValueBuffer* ValueBuffer::Create(Arena& arena, const ByteView value) {
+        const std::uint32_t size = checkedSize(value.size());
+        auto* buffer = new (arena.Allocate(sizeof(ValueBuffer) + size)) ValueBuffer{size, false};
+        std::memcpy(buffer + 1, value.data(), size);
+        return buffer;
+    }
 
-        if (currentLevel < newLevel) {
-            currentLevel = newLevel;
-        }
+    ValueBuffer* ValueBuffer::CreateVersion(Arena& arena, const ByteView value, const std::uint64_t sequence, ValueBuffer* older, const bool tombstone) {
+        static_assert(sizeof(VersionHeader) % alignof(ValueBuffer) == 0);
+        const std::uint32_t size = checkedSize(value.size());
+        void* block = arena.Allocate(sizeof(VersionHeader) + sizeof(ValueBuffer) + size);
+        new (block) VersionHeader{sequence, older};
+        auto* buffer = new (static_cast<std::uint8_t*>(block) + sizeof(VersionHeader)) ValueBuffer{size, false, true, tombstone};
+        std::memcpy(buffer + 1, value.data(), size);
+        return buffer;
+    }
 
-        Node* current = head;
-        std::vector<Node*> update(currentLevel + 1, nullptr);
+    static_assert(sizeof(Node) == 24, "node header grew past its budget");
 
-        for (std::size_t i = currentLevel + 1; i-- > 0;) {
-            while (current->Forward[i] != nullptr && ByteVectorLess(current->Forward[i]->Key, key)) {
-                current = current->Forward[i];
-            }
-            update[i] = current;
-        }
+    std::size_t Node::valueOffset() const {
+        return roundUp(sizeof(Node) + Height * sizeof(std::atomic<Node*>) + KeySize, alignof(ValueBuffer));
+    }
 
-        Node* next = current->Forward[0];
+    std::size_t Node::AllocationSize(const std::size_t keySize, const std::size_t valueSize, const std::size_t heightLevels) {
+        return roundUp(sizeof(Node) + heightLevels * sizeof(std::atomic<Node*>) + keySize, alignof(ValueBuffer))
+            + sizeof(ValueBuffer) + valueSize;
+    }
 
-        if (next == nullptr || !ByteVectorEqual(next->Key, key)) {
-            Node *newNode = new Node(key, value, newLevel + 1);
+    Node* Node::Create(Arena& arena, const ByteView key, const std::uint64_t keyPrefix, const ByteView value, const std::size_t heightLevels) {
+        const std::uint32_t keySize = checkedSize(key.size());
+        const std::uint32_t valueSize = checkedSize(value.size());
+        void* block = arena.Allocate(AllocationSize(keySize, valueSize, heightLevels));
 
-            for (std::size_t i = 0; i <= newLevel; i++) {
-                newNode->Forward[i] = update[i]->Forward[i];
-                update[i]->Forward[i] = newNode;
-            }
-        } else {
-            next->Value = value; // Update existing value
+        auto* node = new (block) Node(keyPrefix, keySize, static_cast<std::uint8_t>(heightLevels));
+        for (std::size_t i = 0; i < heightLevels; i++) {
+            new (&node->Forward(i)) std::atomic<Node*>(nullptr);
         }
+        std::memcpy(const_cast<uint8_t*>(node->Key().data()), key.data(), keySize);
+
+        auto* inlineValue = new (node->InlineValue()) ValueBuffer{valueSize, true};
+        std::memcpy(inlineValue + 1, value.data(), valueSize);
+        node->Value.store(inlineValue, std::memory_order_relaxed);
+        return node;
     }
 
-    // Unnecessary functionality
-    //
-    // void List::Remove(const ByteVector &data) {
-    //     Node *current = head;
-    //     std::vector<Node*> update(currentLevel + 1, nullptr);
-    //
-    //     for (std::size_t i = currentLevel + 1; i-- > 0;) {
-    //         while (current -> Forward[i] != nullptr && ByteVectorLess(current -> Data, data)) {
-    //             current = current -> Forward[i];
-    //         }
-    //         update[i] = current;
-    //     }
-    //
-    //     current = current->Forward[0];
-    //
-    //     if (current != nullptr && ByteVectorEqual(current -> Data, data)) {
-    //         std::lock_guard lock(mux);
-    //         for (std::size_t i = 0; i <= currentLevel; i++) {
-    //             if (update[i] -> Forward[i] != current) {
-    //                 break;
-    //             }
-    //             update[i] -> Forward[i] = current -> Forward[i];
-    //         }
-    //         delete current;
-    //
-    //         while (currentLevel > 0 && head -> Forward[currentLevel] == nullptr) {
-    //             currentLevel--;
-    //         }
-    //
-    //         size--;
-    //     } else {
-    //         // Element not found, do nothing
-    //     }
-    // }
-    //
-    // void List::ReCalibrate() {
-    //     std::lock_guard lock(mux);
-    //
-    //     std::vector <ByteVector> elements;
-    //     Node *current = head;
-    //     elements.reserve(size);
-    //
-    //     while (current -> Forward[0] != nullptr) {
-    //         current = current -> Forward[0];
-    //         elements.push_back(current -> Data);
-    //     }
-    //
-    //     clear();
-    //     head -> Forward.assign(maxLevel, nullptr);
-    //     currentLevel = 0;
-    //     size = 0;
-    //
-    //     for (const auto &element : elements) {
-    //         Insert(element);
-    //     }
-    // }
-    //
-    // void List::ChangeProbability(const float newProbability) {
-    //     if (!checkProbability(probability)) {
-    //         throw std::invalid_argument("probability must be between 0 and 1");
-    //     }
-    //
-    //     std::lock_guard lock(mux);
-    //
-    //     probability = newProbability;
-    //     ReCalibrate();
-    // }
-    //
-    // void List::ChangeMaxLevel(std::size_t newMaxLevel) {
-    //     std::lock_guard lock(mux);
-    //
-    //     maxLevel = newMaxLevel;
-    //     ReCalibrate();
-    // }
+    template class BasicList<ByteOrder>;
 }
@@ -0,0 +1,83 @@
+#include "smallkey.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace tbt {
+    SmallKey::SmallKey(const ByteView bytes) {
+        Assign(bytes);
+    }
+
+    SmallKey::SmallKey(const SmallKey& other) {
+        Assign(other);
+    }
+
+    SmallKey::SmallKey(SmallKey&& other) noexcept {
+        // Both representations are plain bytes: taking them over moves the heap buffer too.
+        std::memcpy(storage, other.storage, sizeof(storage));
+        other.storage[InlineCapacity] = 0;
+    }
+
+    SmallKey& SmallKey::operator=(const SmallKey& other) {
+        if (this != &other) {
+            Assign(other);
+        }
+        return *this;
+    }
+
+    SmallKey& SmallKey::operator=(SmallKey&& other) noexcept {
+        if (this != &other) {
+            release();
+            std::memcpy(storage, other.storage, sizeof(storage));
+            other.storage[InlineCapacity] = 0;
+        }
+        return *this;
+    }
+
+    SmallKey::~SmallKey() {
+        release();
+    }
+
+    void SmallKey::Assign(const ByteView bytes) {
+        if (bytes.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("keys are limited to 4 GiB");
+        }
+        const auto size = static_cast<std::uint32_t>(bytes.size());
+
+        if (size > InlineCapacity && spilled() && heap().Capacity >= size) {
+            Heap current = heap();
+            // memmove: bytes may be a view of this very buffer.
+            std::memmove(current.Data, bytes.data(), size);
+            current.Size = size;
+            setHeap(current);
+            return;
+        }
+        if (size <= InlineCapacity && !spilled()) {
+            std::memmove(storage, bytes.data(), size);
+            storage[InlineCapacity] = static_cast<std::uint8_t>(size);
+            return;
+        }
+
+        // A new buffer, or back inline from a spilled key: copy before releasing the old storage,
+        // which bytes may point into.
+        if (size <= InlineCapacity) {
+            std::uint8_t copy[InlineCapacity];
+            std::memcpy(copy, bytes.data(), size);
+            release();
+            std::memcpy(storage, copy, size);
+            storage[InlineCapacity] = static_cast<std::uint8_t>(size);
+            return;
+        }
+        auto* data = new std::uint8_t[size];
+        std::memcpy(data, bytes.data(), size);
+        release();
+        setHeap(Heap{data, size, size});
+    }
+
+    void SmallKey::release() noexcept {
+        if (spilled()) {
+            delete[] heap().Data;
+            storage[InlineCapacity] = 0;
+        }
+    }
+}
@@ -0,0 +1,342 @@
+#include "snapshot.h"
+
+#include "hash.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tbt {
+    namespace {
+        constexpr std::uint64_t Magic = 0x31504E5354425454ull; // "TTBTSNP1"
+        constexpr std::uint32_t Version = 1;
+        constexpr std::size_t FooterSize = 48;
+        constexpr std::size_t IndexRecordHeader = 16;
+        constexpr std::size_t CrcSize = 4;
+
+        void putVarint(ByteVector& out, std::uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        bool getVarint(ByteView& in, std::uint64_t& value) {
+            value = 0;
+            for (unsigned shift = 0; shift < 64 && !in.empty(); shift += 7) {
+                const std::uint8_t byte = in.front();
+                in = in.subspan(1);
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::error_code lastError() {
+            return {errno, std::generic_category()};
+        }
+    }
+
+    SnapshotWriter::SnapshotWriter(const std::string& path) : path(path), tempPath(path + ".tmp") {
+        fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(lastError(), "cannot create snapshot " + tempPath);
+        }
+        block.reserve(BlockSize * 2);
+    }
+
+    SnapshotWriter::~SnapshotWriter() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (!finished) {
+            ::unlink(tempPath.c_str());
+        }
+    }
+
+    void SnapshotWriter::writeBytes(const ByteVector& bytes) {
+        std::size_t written = 0;
+        while (written < bytes.size()) {
+            const ssize_t result = ::write(fd, bytes.data() + written, bytes.size() - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(lastError(), "cannot write snapshot " + tempPath);
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        fileOffset += bytes.size();
+    }
+
+    void SnapshotWriter::Add(const ByteView key, const ByteView value) {
+        if (key.size() > std::numeric_limits<std::uint32_t>::max() || value.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("snapshot entry larger than 4 GiB");
+        }
+        if (entries > 0 && !ByteVectorLess(lastKey, key)) {
+            throw std::invalid_argument("snapshot keys must be strictly increasing");
+        }
+
+        std::size_t shared = 0;
+        if (blockStarted) {
+            const std::size_t limit = std::min(lastKey.size(), key.size());
+            shared = static_cast<std::size_t>(std::mismatch(key.begin(), key.begin() + static_cast<std::ptrdiff_t>(limit), lastKey.begin()).first - key.begin());
+        } else {
+            // The sparse index keeps the first key of each block in full.
+            indexOffsets.push_back(index.size());
+            PutFixed(index, fileOffset, 8);
+            PutFixed(index, 0, 4); // block size, patched in flushBlock
+            PutFixed(index, key.size(), 4);
+            index.insert(index.end(), key.begin(), key.end());
+            blockStarted = true;
+        }
+
+        putVarint(block, shared);
+        putVarint(block, key.size() - shared);
+        putVarint(block, value.size());
+        block.insert(block.end(), key.begin() + static_cast<std::ptrdiff_t>(shared), key.end());
+        block.insert(block.end(), value.begin(), value.end());
+        lastKey.assign(key.begin(), key.end());
+        entries++;
+
+        if (block.size() >= BlockSize) {
+            flushBlock();
+        }
+    }
+
+    void SnapshotWriter::flushBlock() {
+        if (!blockStarted) {
+            return;
+        }
+        PutFixed(block, Crc32c(block), CrcSize);
+        std::uint8_t* sizeField = index.data() + indexOffsets.back() + 8;
+        for (int i = 0; i < 4; i++) {
+            sizeField[i] = static_cast<std::uint8_t>(block.size() >> (8 * i));
+        }
+        writeBytes(block);
+        block.clear();
+        blockStarted = false;
+    }
+
+    void SnapshotWriter::Finish() {
+        flushBlock();
+
+        const std::uint64_t indexStart = fileOffset;
+        ByteVector tail = std::move(index);
+        const std::uint64_t offsetsStart = indexStart + tail.size();
+        for (const std::uint64_t offset : indexOffsets) {
+            PutFixed(tail, indexStart + offset, 8);
+        }
+        const std::uint32_t indexCrc = Crc32c(tail);
+        PutFixed(tail, indexStart, 8);
+        PutFixed(tail, offsetsStart, 8);
+        PutFixed(tail, indexOffsets.size(), 8);
+        PutFixed(tail, entries, 8);
+        PutFixed(tail, indexCrc, 4);
+        PutFixed(tail, Version, 4);
+        PutFixed(tail, Magic, 8);
+        writeBytes(tail);
+
+        if (::fsync(fd) != 0) {
+            throw std::system_error(lastError(), "cannot sync snapshot " + tempPath);
+        }
+        ::close(fd);
+        fd = -1;
+        if (::rename(tempPath.c_str(), path.c_str()) != 0) {
+            throw std::system_error(lastError(), "cannot rename snapshot to " + path);
+        }
+        finished = true;
+
+        // Make the rename itself durable.
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (parent.empty()) {
+            parent = ".";
+        }
+        if (const int dir = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); dir >= 0) {
+            (void)::fsync(dir);
+            ::close(dir);
+        }
+    }
+
+    MappedSnapshot::MappedSnapshot(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(lastError(), "cannot open snapshot " + path);
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            const std::error_code error = lastError();
+            ::close(fd);
+            throw std::system_error(error, "cannot stat snapshot " + path);
+        }
+        size = static_cast<std::size_t>(info.st_size);
+        if (size < FooterSize) {
+            ::close(fd);
+            ThrowCorrupt("snapshot", "file too small");
+        }
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        const std::error_code mapError = lastError();
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(mapError, "cannot map snapshot " + path);
+        }
+        data = static_cast<const std::uint8_t*>(mapping);
+
+        try {
+            const std::uint8_t* footer = data + size - FooterSize;
+            const std::uint64_t indexOffset = GetFixed(footer, 8);
+            offsetsOffset = GetFixed(footer + 8, 8);
+            blockCount = GetFixed(footer + 16, 8);
+            entryCount = GetFixed(footer + 24, 8);
+            const auto indexCrc = static_cast<std::uint32_t>(GetFixed(footer + 32, 4));
+            if (GetFixed(footer + 40, 8) != Magic || GetFixed(footer + 36, 4) != Version) {
+                ThrowCorrupt("snapshot", "bad magic or version");
+            }
+            const std::uint64_t footerOffset = size - FooterSize;
+            if (indexOffset > offsetsOffset || offsetsOffset > footerOffset || (footerOffset - offsetsOffset) / 8 != blockCount ||
+                (footerOffset - offsetsOffset) % 8 != 0) {
+                ThrowCorrupt("snapshot", "bad footer");
+            }
+            if (Crc32c(ByteView(data + indexOffset, footerOffset - indexOffset)) != indexCrc) {
+                ThrowCorrupt("snapshot", "index checksum mismatch");
+            }
+            verified = std::make_unique<std::atomic<std::uint64_t>[]>((blockCount + 63) / 64);
+        } catch (...) {
+            ::munmap(mapping, size);
+            throw;
+        }
+    }
+
+    MappedSnapshot::~MappedSnapshot() {
+        ::munmap(const_cast<std::uint8_t*>(data), size);
+    }
+
+    MappedSnapshot::BlockRef MappedSnapshot::blockAt(const std::uint64_t index, const bool verify) const {
+        const std::uint64_t recordOffset = GetFixed(data + offsetsOffset + 8 * index, 8);
+        if (recordOffset + IndexRecordHeader > offsetsOffset) {
+            ThrowCorrupt("snapshot", "bad index record");
+        }
+        const std::uint8_t* record = data + recordOffset;
+        const std::uint64_t blockOffset = GetFixed(record, 8);
+        const std::uint64_t blockSize = GetFixed(record + 8, 4);
+        const std::uint64_t keySize = GetFixed(record + 12, 4);
+        if (recordOffset + IndexRecordHeader + keySize > offsetsOffset || blockSize < CrcSize || blockOffset + blockSize > size - FooterSize) {
+            ThrowCorrupt("snapshot", "bad index record");
+        }
+
+        const ByteView entries(data + blockOffset, blockSize - CrcSize);
+        std::atomic<std::uint64_t>& word = verified[index / 64];
+        const std::uint64_t bit = std::uint64_t{1} << (index % 64);
+        if (verify && (word.load(std::memory_order_acquire) & bit) == 0) {
+            if (Crc32c(entries) != static_cast<std::uint32_t>(GetFixed(data + blockOffset + blockSize - CrcSize, 4))) {
+                ThrowCorrupt("snapshot", "checksum mismatch in block " + std::to_string(index));
+            }
+            word.fetch_or(bit, std::memory_order_release);
+        }
+        return {entries, ByteView(record + IndexRecordHeader, keySize)};
+    }
+
+    std::uint64_t MappedSnapshot::blockFor(const ByteView key) const {
+        // Last block whose first key is not greater than key; blockCount if key precedes them all.
+        std::uint64_t low = 0;
+        std::uint64_t high = blockCount;
+        while (low < high) {
+            const std::uint64_t middle = low + (high - low) / 2;
+            if (ByteVectorLess(key, blockAt(middle, false).FirstKey)) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        return low == 0 ? blockCount : low - 1;
+    }
+
+    MappedSnapshot::Iterator::Iterator(const MappedSnapshot& snapshot) : snapshot(&snapshot), blockIndex(snapshot.blockCount) {}
+
+    void MappedSnapshot::Iterator::loadBlock(const std::uint64_t index) {
+        blockIndex = index;
+        rest = snapshot->blockAt(index, true).Entries;
+        key.clear();
+    }
+
+    void MappedSnapshot::Iterator::SeekToFirst() {
+        valid = false;
+        if (snapshot->blockCount == 0) {
+            return;
+        }
+        loadBlock(0);
+        Next();
+    }
+
+    void MappedSnapshot::Iterator::Seek(const ByteView target) {
+        const std::uint64_t index = snapshot->blockFor(target);
+        if (index == snapshot->blockCount) {
+            SeekToFirst();
+            return;
+        }
+        loadBlock(index);
+        Next();
+        while (valid && ByteVectorLess(key, target)) {
+            Next();
+        }
+    }
+
+    void MappedSnapshot::Iterator::Next() {
+        while (rest.empty()) {
+            if (blockIndex + 1 >= snapshot->blockCount) {
+                valid = false;
+                return;
+            }
+            loadBlock(blockIndex + 1);
+        }
+
+        std::uint64_t shared = 0;
+        std::uint64_t unshared = 0;
+        std::uint64_t valueSize = 0;
+        if (!getVarint(rest, shared) || !getVarint(rest, unshared) || !getVarint(rest, valueSize) ||
+            shared > key.size() || unshared > rest.size() || valueSize > rest.size() - unshared) {
+            ThrowCorrupt("snapshot", "bad entry in block " + std::to_string(blockIndex));
+        }
+        key.resize(shared);
+        key.insert(key.end(), rest.begin(), rest.begin() + static_cast<std::ptrdiff_t>(unshared));
+        value = rest.subspan(unshared, valueSize);
+        rest = rest.subspan(unshared + valueSize);
+        valid = true;
+    }
+
+    std::optional<ByteView> MappedSnapshot::Get(const ByteView key) const {
+        Iterator it(*this);
+        it.Seek(key);
+        if (it.Valid() && ByteVectorEqual(it.Key(), key)) {
+            return it.Value();
+        }
+        return std::nullopt;
+    }
+
+    std::vector<Entry> MappedSnapshot::Scan(const ByteView begin, const ByteView end, const std::size_t limit) const {
+        std::vector<Entry> out;
+        Iterator it(*this);
+        if (begin.empty()) {
+            it.SeekToFirst();
+        } else {
+            it.Seek(begin);
+        }
+        for (; it.Valid() && out.size() < limit; it.Next()) {
+            if (!end.empty() && !ByteVectorLess(it.Key(), end)) {
+                break;
+            }
+            out.push_back({ByteVector(it.Key().begin(), it.Key().end()), ByteVector(it.Value().begin(), it.Value().end())});
+        }
+        return out;
+    }
+}
@@ -0,0 +1,300 @@
+#include "wal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tbt {
+    namespace {
+        constexpr std::size_t HeaderSize = 13;
+        constexpr std::size_t ReadChunk = 1 << 20;
+
+        void storeLittleEndian(std::uint8_t* out, const std::uint32_t word) {
+            for (int i = 0; i < 4; i++) {
+                out[i] = static_cast<std::uint8_t>(word >> (8 * i));
+            }
+        }
+
+        std::uint32_t loadLittleEndian(const std::uint8_t* in) {
+            std::uint32_t word = 0;
+            for (int i = 0; i < 4; i++) {
+                word |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+            }
+            return word;
+        }
+
+        std::error_code lastError() {
+            return {errno, std::generic_category()};
+        }
+
+        std::error_code writeAll(const int fd, const ByteVector& bytes) {
+            std::size_t written = 0;
+            while (written < bytes.size()) {
+                const ssize_t result = ::write(fd, bytes.data() + written, bytes.size() - written);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return lastError();
+                }
+                written += static_cast<std::size_t>(result);
+            }
+            return {};
+        }
+
+        std::error_code syncData(const int fd) {
+#if defined(__linux__)
+            const int result = ::fdatasync(fd);
+#else
+            const int result = ::fsync(fd);
+#endif
+            return result == 0 ? std::error_code() : lastError();
+        }
+
+        // A freshly created file is only durable once its directory entry is: sync the parent.
+        void syncParent(const std::string& path) {
+            std::filesystem::path parent = std::filesystem::path(path).parent_path();
+            if (parent.empty()) {
+                parent = ".";
+            }
+            const int dir = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dir >= 0) {
+                // Best effort: some file systems refuse to sync directories.
+                (void)::fsync(dir);
+                ::close(dir);
+            }
+        }
+
+        void encode(ByteVector& out, const WalRecord& record) {
+            const std::size_t offset = out.size();
+            out.resize(offset + HeaderSize + record.Key.size() + record.Value.size());
+            std::uint8_t* header = out.data() + offset;
+            storeLittleEndian(header + 4, static_cast<std::uint32_t>(record.Key.size()));
+            storeLittleEndian(header + 8, static_cast<std::uint32_t>(record.Value.size()));
+            header[12] = static_cast<std::uint8_t>(record.Type);
+            std::copy(record.Key.begin(), record.Key.end(), header + HeaderSize);
+            std::copy(record.Value.begin(), record.Value.end(), header + HeaderSize + record.Key.size());
+            const ByteView checked(header + 4, out.size() - offset - 4);
+            storeLittleEndian(header, Crc32c(checked));
+        }
+    }
+
+    WriteAheadLog::WriteAheadLog(const std::string& path, const WalOptions options) : options(options) {
+        if (options.Sync == SyncPolicy::Interval && options.Interval <= std::chrono::milliseconds::zero()) {
+            throw std::invalid_argument("write-ahead log sync interval must be positive");
+        }
+        constexpr int Flags = O_WRONLY | O_APPEND | O_CLOEXEC;
+        fd = ::open(path.c_str(), Flags | O_CREAT | O_EXCL, 0644);
+        const bool created = fd >= 0;
+        if (!created && errno == EEXIST) {
+            fd = ::open(path.c_str(), Flags);
+        }
+        if (fd < 0) {
+            throw std::system_error(lastError(), "cannot open write-ahead log " + path);
+        }
+        if (created) {
+            syncParent(path);
+        }
+
+        if (options.Sync == SyncPolicy::Interval) {
+            syncer = std::jthread([this](const std::stop_token stop) { syncLoop(stop); });
+        }
+    }
+
+    WriteAheadLog::~WriteAheadLog() {
+        if (syncer.joinable()) {
+            syncer.request_stop();
+            syncer.join();
+        }
+        try {
+            Sync();
+        } catch (const std::system_error&) {
+            // Already reported to the writers whose records were affected.
+        }
+        ::close(fd);
+    }
+
+    void WriteAheadLog::flushAsLeader(std::unique_lock<std::mutex>& lock, bool sync) {
+        // The leader takes the whole pending group and does the I/O without the mutex, so writers
+        // keep appending to a fresh group meanwhile.
+        sync = sync || syncRequested;
+        syncRequested = false;
+        flushing = true;
+        writing.swap(pending);
+        const std::uint64_t upto = appendedLsn;
+        lock.unlock();
+
+        std::error_code error = writeAll(fd, writing);
+        if (!error && sync) {
+            error = syncData(fd);
+        }
+
+        lock.lock();
+        if (error) {
+            failure = error;
+        } else {
+            writtenLsn = upto;
+            if (sync) {
+                syncedLsn = upto;
+                stats.Syncs++;
+            }
+            if (!writing.empty()) {
+                stats.Writes++;
+                stats.Bytes += writing.size();
+            }
+        }
+        writing.clear();
+        flushing = false;
+        flushed.notify_all();
+    }
+
+    void WriteAheadLog::syncLoop(const std::stop_token stop) {
+        std::unique_lock<std::mutex> lock(mux);
+        while (!stop.stop_requested()) {
+            tick.wait_for(lock, stop, options.Interval, [] { return false; });
+            if (failure || syncedLsn >= appendedLsn) {
+                continue;
+            }
+            if (flushing) {
+                // Under steady load a flush is nearly always running: let the next leader sync
+                // instead of waiting for a gap.
+                syncRequested = true;
+            } else {
+                flushAsLeader(lock, true);
+            }
+        }
+    }
+
+    std::uint64_t WriteAheadLog::Append(const std::span<const WalRecord> records) {
+        for (const WalRecord& record : records) {
+            if (record.Key.size() > std::numeric_limits<std::uint32_t>::max() || record.Value.size() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error("log record larger than 4 GiB");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mux);
+        if (failure) {
+            throw std::system_error(failure, "write-ahead log failed");
+        }
+        for (const WalRecord& record : records) {
+            encode(pending, record);
+        }
+        appendedLsn += records.size();
+        stats.Records += records.size();
+        return appendedLsn;
+    }
+
+    void WriteAheadLog::Commit(const std::uint64_t lsn) {
+        const bool sync = options.Sync == SyncPolicy::EveryOperation;
+        std::unique_lock<std::mutex> lock(mux);
+        while ((sync ? syncedLsn : writtenLsn) < lsn) {
+            if (failure) {
+                throw std::system_error(failure, "write-ahead log failed");
+            }
+            if (flushing) {
+                flushed.wait(lock);
+            } else {
+                flushAsLeader(lock, sync);
+            }
+        }
+    }
+
+    void WriteAheadLog::Sync() {
+        std::unique_lock<std::mutex> lock(mux);
+        const std::uint64_t target = appendedLsn;
+        while (syncedLsn < target) {
+            if (failure) {
+                throw std::system_error(failure, "write-ahead log failed");
+            }
+            if (flushing) {
+                flushed.wait(lock);
+            } else {
+                flushAsLeader(lock, true);
+            }
+        }
+    }
+
+    WalStats WriteAheadLog::Stats() const {
+        std::lock_guard<std::mutex> lock(mux);
+        return stats;
+    }
+
+    std::uint64_t WriteAheadLog::Replay(const std::string& path, const std::function<void(const WalRecord&)>& apply) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT) {
+                return 0;
+            }
+            throw std::system_error(lastError(), "cannot open write-ahead log " + path);
+        }
+
+        ByteVector buffer;
+        std::size_t parsed = 0;
+        std::uint64_t validBytes = 0;
+        std::uint64_t records = 0;
+        bool corrupt = false;
+        bool eof = false;
+        while (true) {
+            while (buffer.size() - parsed >= HeaderSize) {
+                const std::uint8_t* header = buffer.data() + parsed;
+                const std::uint32_t keySize = loadLittleEndian(header + 4);
+                const std::uint32_t valueSize = loadLittleEndian(header + 8);
+                const std::size_t total = HeaderSize + std::size_t{keySize} + valueSize;
+                if (buffer.size() - parsed < total) {
+                    break;
+                }
+                const auto type = static_cast<WalRecordType>(header[12]);
+                if (Crc32c(ByteView(header + 4, total - 4)) != loadLittleEndian(header) || (type != WalRecordType::Put && type != WalRecordType::Erase)) {
+                    corrupt = true;
+                    break;
+                }
+                apply({type, ByteView(header + HeaderSize, keySize), ByteView(header + HeaderSize + keySize, valueSize)});
+                parsed += total;
+                validBytes += total;
+                records++;
+            }
+            if (corrupt || eof) {
+                break;
+            }
+
+            buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(parsed));
+            parsed = 0;
+            const std::size_t filled = buffer.size();
+            buffer.resize(filled + ReadChunk);
+            ssize_t result;
+            do {
+                result = ::read(fd, buffer.data() + filled, ReadChunk);
+            } while (result < 0 && errno == EINTR);
+            if (result < 0) {
+                const std::error_code error = lastError();
+                ::close(fd);
+                throw std::system_error(error, "cannot read write-ahead log " + path);
+            }
+            buffer.resize(filled + static_cast<std::size_t>(result));
+            eof = result == 0;
+        }
+
+        struct stat info{};
+        const bool sized = ::fstat(fd, &info) == 0;
+        ::close(fd);
+        if (sized && static_cast<std::uint64_t>(info.st_size) > validBytes) {
+            // Cut the torn record off so that new appends follow the last intact one.
+            const int writable = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+            if (writable < 0 || ::ftruncate(writable, static_cast<off_t>(validBytes)) != 0 || syncData(writable)) {
+                const std::error_code error = lastError();
+                if (writable >= 0) {
+                    ::close(writable);
+                }
+                throw std::system_error(error, "cannot truncate write-ahead log " + path);
+            }
+            ::close(writable);
+        }
+        return records;
+    }
+}
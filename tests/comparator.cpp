@@ -8,10 +8,14 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+#include <random>
 #include "comparator.h"
+#include "smallkey.h"
 
 using tbt::ByteVector;
 using tbt::ByteVectorLess;
+using tbt::ByteVectorPrefix;
 
 static ByteVector bv(std::initializer_list<int> il) {
     ByteVector v;
@@ -65,6 +69,11 @@ int main() {
     tests.push_back({"case: differ late [10,0] < [10,1]", bv({10, 0}), bv({10, 1}), true});
     tests.push_back({"case: [255,0] < [255,1]", bv({255, 0}), bv({255, 1}), true});
 
+    // Keys longer than the 8-byte prefix
+    tests.push_back({"long: differ after prefix", bv({1, 2, 3, 4, 5, 6, 7, 8, 0}), bv({1, 2, 3, 4, 5, 6, 7, 8, 1}), true});
+    tests.push_back({"long: differ inside prefix", bv({1, 2, 3, 4, 5, 6, 7, 9}), bv({1, 2, 3, 4, 5, 6, 7, 8, 255}), false});
+    tests.push_back({"long: zero padding ties", bv({1, 2}), bv({1, 2, 0, 0, 0, 0, 0, 0, 0}), true});
+
     int failed = 0;
     int total = 0;
 
@@ -76,6 +85,10 @@ int main() {
 
         bool ok = (res == tc.expectLess) && !(res && res_rev);
         if (eq) ok = ok && (!res && !res_rev);
+        // The prefix may tie where the keys differ, but must never contradict their order.
+        const auto prefixLeft = ByteVectorPrefix(tc.left);
+        const auto prefixRight = ByteVectorPrefix(tc.right);
+        ok = ok && !(prefixLeft < prefixRight && !res) && !(prefixRight < prefixLeft && !res_rev);
 
         if (!ok) {
             std::cerr << "FAIL: " << tc.name << "\n"
@@ -105,6 +118,79 @@ int main() {
         }
     }
 
+    // Order policies: reverse flips every comparison, IntegerOrder compares host-order integers
+    {
+        ++total;
+        auto a = bv({1, 2});
+        auto b = bv({1, 2, 3});
+        const int small = -5, large = 300;
+        ByteVector left(sizeof(int)), right(sizeof(int));
+        std::memcpy(left.data(), &small, sizeof(int));
+        std::memcpy(right.data(), &large, sizeof(int));
+        bool ok = tbt::ReverseByteOrder::Less(b, a) && !tbt::ReverseByteOrder::Less(a, b)
+            && tbt::ReverseByteOrder::Prefix(b) <= tbt::ReverseByteOrder::Prefix(a)
+            && tbt::IntegerOrder<int>::Less(left, right) && !tbt::IntegerOrder<int>::Less(right, left)
+            && tbt::ByteOrder::Equal(a, a) && !tbt::ByteOrder::Equal(a, b);
+        if (!ok) {
+            std::cerr << "FAIL: order policies\n";
+            ++failed;
+        }
+    }
+
+    // FixedKey agrees with ByteOrder on keys of its size and of any other size
+    {
+        ++total;
+        std::mt19937_64 rng(7);
+        auto random_key = [&](std::size_t size) {
+            ByteVector v(size);
+            // Few distinct byte values, so long shared runs and equal keys are common
+            for (auto& byte : v) byte = static_cast<uint8_t>(rng() % 3);
+            return v;
+        };
+        auto agrees = [&]<std::size_t Size>(tbt::FixedKey<Size>) {
+            for (int i = 0; i < 2000; ++i) {
+                const auto a = random_key(i % 7 == 0 ? rng() % (Size + 2) : Size);
+                const auto b = random_key(i % 5 == 0 ? rng() % (Size + 2) : Size);
+                using Fixed = tbt::FixedKey<Size>;
+                if (Fixed::Less(a, b) != ByteVectorLess(a, b) || Fixed::Equal(a, b) != tbt::ByteVectorEqual(a, b)) return false;
+                if (Fixed::Prefix(a) != ByteVectorPrefix(a)) return false;
+            }
+            return true;
+        };
+        const auto encoded = tbt::FixedKey<8>::Encode(std::uint64_t{0x0102030405060708});
+        bool ok = agrees(tbt::FixedKey<3>{}) && agrees(tbt::FixedKey<8>{}) && agrees(tbt::FixedKey<12>{}) && agrees(tbt::FixedKey<16>{})
+            && encoded[0] == 1 && encoded[7] == 8
+            && tbt::FixedKey<8>::Decode<std::uint64_t>(encoded) == 0x0102030405060708
+            && tbt::FixedKey<4>::Less(tbt::FixedKey<4>::Encode(255u), tbt::FixedKey<4>::Encode(256u));
+        if (!ok) {
+            std::cerr << "FAIL: fixed key order\n";
+            ++failed;
+        }
+    }
+
+    // SmallKey keeps short keys inline, spills long ones, and survives copies, moves and
+    // self-assignment from a view of itself
+    {
+        ++total;
+        const ByteVector shortBytes(23, 0xAB), longBytes(40, 0xCD);
+        tbt::SmallKey small(shortBytes), large(longBytes);
+        bool ok = small.IsInline() && !large.IsInline() && tbt::ByteView(small).size() == 23
+            && ByteVector(small.Data(), small.Data() + small.Size()) == shortBytes
+            && ByteVector(large.Data(), large.Data() + large.Size()) == longBytes && small < large;
+        tbt::SmallKey copy(large);
+        tbt::SmallKey moved(std::move(large));
+        ok = ok && copy == moved && copy.Data() != moved.Data() && large.Size() == 0;
+        moved.Assign(tbt::ByteView(moved).subspan(5));
+        copy = small;
+        ok = ok && moved.Size() == 35 && moved.Data()[0] == 0xCD && copy == small && copy.IsInline();
+        small.Assign(tbt::ByteView(small).first(4));
+        ok = ok && small.Size() == 4 && small.Data()[3] == 0xAB;
+        if (!ok) {
+            std::cerr << "FAIL: small key\n";
+            ++failed;
+        }
+    }
+
     if (failed == 0) {
         std::cout << "OK: all tests passed (" << total << ")\n";
         return 0;
@@ -0,0 +1,141 @@
+/*
+ * Tests for the membership filters only: the Bloom filter of tiered runs and the counting Bloom
+ * filter that can sit in front of a list, including concurrent counting.
+ */
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/filter.h"
+#include "include/hash.h"
+
+using namespace tbt;
+
+namespace {
+    ByteVector key_of(int x) {
+        const std::string key = "key:" + std::to_string(1000000 + x);
+        return ByteVector(key.begin(), key.end());
+    }
+
+    std::uint64_t hash_of(int x) {
+        return ByteVectorHash(key_of(x));
+    }
+}
+
+static bool test_bloom_filter() {
+    const int count = 10000;
+    BloomFilter filter(count, 10);
+    for (int i = 0; i < count; ++i) filter.Add(hash_of(i));
+
+    bool ok = true;
+    for (int i = 0; i < count && ok; ++i) ok = filter.MayContain(hash_of(i));
+    int positives = 0;
+    for (int i = count; i < 11 * count; ++i) positives += filter.MayContain(hash_of(i)) ? 1 : 0;
+    ok = ok && positives < 10 * count * 3 / 100; // under 3% with 10 bits per key
+
+    // Encode/Decode round trip; damage is detected
+    ByteVector bytes = filter.Encode();
+    const BloomFilter copy = BloomFilter::Decode(bytes);
+    for (int i = 0; i < count && ok; ++i) ok = copy.MayContain(hash_of(i));
+    bytes[20] ^= 0x01;
+    bool threw = false;
+    try { BloomFilter::Decode(bytes); } catch (const std::runtime_error&) { threw = true; }
+    return ok && threw && !BloomFilter().MayContain(42);
+}
+
+static bool test_counting_filter() {
+    const int count = 10000;
+    CountingBloomFilter filter(count, 0.01);
+    for (int i = 0; i < count; ++i) filter.Add(hash_of(i));
+
+    bool ok = true;
+    for (int i = 0; i < count && ok; ++i) ok = filter.MayContain(hash_of(i));
+    int positives = 0;
+    for (int i = count; i < 11 * count; ++i) positives += filter.MayContain(hash_of(i)) ? 1 : 0;
+    ok = ok && positives < 10 * count * 2 / 100; // near the 1% asked for
+
+    // Removing half of the keys keeps the other half and lets most removed ones go
+    for (int i = 0; i < count; i += 2) filter.Remove(hash_of(i));
+    int lingering = 0;
+    for (int i = 0; i < count && ok; ++i) {
+        if (i % 2 == 1) ok = filter.MayContain(hash_of(i));
+        else lingering += filter.MayContain(hash_of(i)) ? 1 : 0;
+    }
+    ok = ok && lingering < count / 2 * 2 / 100;
+
+    // A key added past counter saturation is never reported absent again
+    for (int i = 0; i < 20; ++i) filter.Add(hash_of(-1));
+    for (int i = 0; i < 20; ++i) filter.Remove(hash_of(-1));
+    ok = ok && filter.MayContain(hash_of(-1));
+
+    // Outcomes are summed over all stripes
+    filter.RecordLookup(false, false);
+    filter.RecordLookup(true, true);
+    filter.RecordLookup(true, false);
+    const FilterStats stats = filter.Stats();
+    ok = ok && stats.Negatives == 1 && stats.Hits == 1 && stats.FalsePositives == 1;
+
+    int rejected = 0;
+    try { CountingBloomFilter bad(0, 0.01); } catch (const std::invalid_argument&) { ++rejected; }
+    try { CountingBloomFilter bad(10, 1.0); } catch (const std::invalid_argument&) { ++rejected; }
+    try { CountingBloomFilter bad(10, 0.0); } catch (const std::invalid_argument&) { ++rejected; }
+    return ok && rejected == 3;
+}
+
+static bool test_counting_filter_concurrent() {
+    const int threads = 4;
+    const int perThread = 5000;
+    CountingBloomFilter filter(threads * perThread, 0.01);
+    // Stable keys stay counted in while other threads churn keys sharing their blocks
+    for (int i = 0; i < perThread; ++i) filter.Add(hash_of(i));
+
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int round = 0; round < 5; ++round) {
+                for (int i = t * perThread; i < (t + 1) * perThread; ++i) filter.Add(hash_of(i));
+                for (int i = t * perThread; i < (t + 1) * perThread; ++i) filter.Remove(hash_of(i));
+            }
+            for (int i = t * perThread; i < (t + 1) * perThread; ++i) filter.Add(hash_of(i));
+        });
+    }
+    std::thread reader([&]() {
+        while (!done.load()) {
+            for (int i = 0; i < perThread; ++i) {
+                if (!filter.MayContain(hash_of(i))) ok = false;
+            }
+        }
+    });
+    for (auto& worker : workers) worker.join();
+    done = true;
+    reader.join();
+
+    for (int i = 0; i < threads * perThread && ok; ++i) ok = filter.MayContain(hash_of(i));
+    return ok;
+}
+
+int main() {
+    int failed = 0;
+    auto run = [&](const char* name, bool (*fn)()) {
+        bool ok = fn();
+        std::cout << (ok ? "OK: " : "FAIL: ") << name << "\n";
+        if (!ok) ++failed;
+    };
+
+    run("bloom_filter", &test_bloom_filter);
+    run("counting_filter", &test_counting_filter);
+    run("counting_filter_concurrent", &test_counting_filter_concurrent);
+
+    if (failed == 0) {
+        std::cout << "All Filter tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << failed << " Filter test(s) failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,162 @@
+/*
+ * Tests for ShardedThreadByteTree only: routing, put/get/erase across shards,
+ * ordered prefix partitioning and per-shard contention counters.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <thread>
+
+#include "ShardedThreadByteTree.h"
+#include "include/hash.h"
+
+using namespace tbt;
+
+static ByteVector key_of(int x) {
+    // 4-byte big-endian representation to preserve numeric order under lexicographic compare
+    ByteVector v(4);
+    v[0] = static_cast<uint8_t>((x >> 24) & 0xFF);
+    v[1] = static_cast<uint8_t>((x >> 16) & 0xFF);
+    v[2] = static_cast<uint8_t>((x >> 8) & 0xFF);
+    v[3] = static_cast<uint8_t>(x & 0xFF);
+    return v;
+}
+
+static ByteVector val_of(int x) {
+    // Single byte value mod 256
+    return ByteVector{static_cast<uint8_t>(x & 0xFF)};
+}
+
+static bool test_sharded_basic(Partitioning partitioning) {
+    ShardedThreadByteTree tree(8, 16, 0.5f, partitioning);
+    for (int i = 0; i < 1000; ++i) tree.put(key_of(i * 977), val_of(i));
+
+    for (int i = 0; i < 1000; ++i) {
+        if (!ByteVectorEqual(tree.get(key_of(i * 977)), val_of(i))) return false;
+    }
+    if (!tree.get(key_of(1)).empty()) return false;
+
+    tree.put(key_of(977), val_of(99));
+    if (!ByteVectorEqual(tree.get(key_of(977)), val_of(99))) return false;
+    if (!tree.erase(key_of(977)) || !tree.get(key_of(977)).empty()) return false;
+    return !tree.erase(key_of(977));
+}
+
+static bool test_sharded_basic_hash() {
+    return test_sharded_basic(Partitioning::Hash);
+}
+
+static bool test_sharded_basic_prefix() {
+    return test_sharded_basic(Partitioning::Prefix);
+}
+
+static bool test_sharded_hash_spread() {
+    ShardedThreadByteTree tree(16, 16, 0.5f, Partitioning::Hash);
+    if (ByteVectorHash(key_of(12345)) != ByteVectorHash(key_of(12345))) return false;
+
+    std::vector<int> perShard(tree.shardCount(), 0);
+    for (int i = 0; i < 16000; ++i) perShard[tree.shardOf(key_of(i))]++;
+    // Sequential keys must not pile up in a few shards
+    for (int count : perShard) {
+        if (count < 500 || count > 1500) return false;
+    }
+    return true;
+}
+
+static bool test_sharded_prefix_ordered() {
+    ShardedThreadByteTree tree(7, 16, 0.5f, Partitioning::Prefix);
+    // Shards are ordered ranges: a larger key never maps to a smaller shard
+    std::size_t previous = 0;
+    for (int i = 0; i < 65536; i += 3) {
+        const std::size_t shard = tree.shardOf(ByteVector{static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i & 0xFF), 0x7F});
+        if (shard < previous || shard >= tree.shardCount()) return false;
+        previous = shard;
+    }
+    if (tree.shardOf(ByteVector{}) != 0 || tree.shardOf(ByteVector{0xFF, 0xFF, 0xFF}) != tree.shardCount() - 1) return false;
+    return true;
+}
+
+static bool test_sharded_scan(Partitioning partitioning) {
+    ShardedThreadByteTree tree(8, 16, 0.5f, partitioning);
+    // Keys spread over the lower half of the two-byte prefix range: several shards in either mode
+    for (int i = 0; i < 4000; ++i) tree.put(key_of(i * 500009), val_of(i));
+
+    const auto all = tree.scan({}, {});
+    if (all.size() != 4000) return false;
+    for (std::size_t i = 1; i < all.size(); ++i) {
+        if (!ByteVectorLess(all[i - 1].Key, all[i].Key)) return false;
+    }
+    if (all.front().Key != key_of(0) || all.front().Value != val_of(0)) return false;
+
+    // Bounds spanning several shards, and a limit that stops inside one
+    const ByteVector begin = key_of(500 * 500009);
+    const ByteVector end = key_of(2500 * 500009);
+    const auto range = tree.scan(begin, end);
+    if (range.size() != 2000 || range.front().Key != begin || range.back().Key != key_of(2499 * 500009)) return false;
+    const auto page = tree.scan(begin, end, 10);
+    if (page.size() != 10 || !std::equal(page.begin(), page.end(), range.begin(),
+                                         [](const Entry& left, const Entry& right) { return left.Key == right.Key; })) return false;
+    return tree.scan(end, begin).empty() && tree.scan({}, {}, 0).empty();
+}
+
+static bool test_sharded_scan_hash() {
+    return test_sharded_scan(Partitioning::Hash);
+}
+
+static bool test_sharded_scan_prefix() {
+    return test_sharded_scan(Partitioning::Prefix);
+}
+
+static bool test_sharded_concurrency_and_stats() {
+    ShardedThreadByteTree tree(4, 16, 0.5f, Partitioning::Hash);
+    const int writers = 4;
+    const int per_writer = 1500;
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([w, per_writer, &tree]() {
+            for (int i = w * per_writer; i < (w + 1) * per_writer; ++i) tree.put(key_of(i), val_of(i));
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    for (int i = 0; i < writers * per_writer; ++i) {
+        if (!ByteVectorEqual(tree.get(key_of(i)), val_of(i))) {
+            std::cerr << "sharded_concurrency wrong value at " << i << "\n";
+            return false;
+        }
+    }
+
+    // Every put takes exactly one shard's lock once; contention never exceeds acquisitions
+    std::uint64_t acquisitions = 0;
+    for (const LockStats& stats : tree.shardStats()) {
+        if (stats.Contended > stats.Acquisitions) return false;
+        acquisitions += stats.Acquisitions;
+    }
+    return acquisitions == static_cast<std::uint64_t>(writers * per_writer);
+}
+
+int main() {
+    int failed = 0;
+    auto run = [&](const char* name, bool (*fn)()) {
+        bool ok = fn();
+        std::cout << (ok ? "OK: " : "FAIL: ") << name << "\n";
+        if (!ok) ++failed;
+    };
+
+    run("sharded_basic_hash", &test_sharded_basic_hash);
+    run("sharded_basic_prefix", &test_sharded_basic_prefix);
+    run("sharded_hash_spread", &test_sharded_hash_spread);
+    run("sharded_prefix_ordered", &test_sharded_prefix_ordered);
+    run("sharded_scan_hash", &test_sharded_scan_hash);
+    run("sharded_scan_prefix", &test_sharded_scan_prefix);
+    run("sharded_concurrency_and_stats", &test_sharded_concurrency_and_stats);
+
+    if (failed == 0) {
+        std::cout << "All ShardedThreadByteTree tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << failed << " ShardedThreadByteTree test(s) failed" << std::endl;
+    return 1;
+}
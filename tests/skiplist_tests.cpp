@@ -6,10 +6,15 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <barrier>
 #include <random>
 #include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
 #include "include/skiplist.h"
+#include "include/smallkey.h"
 
 using namespace tbt;
 
@@ -93,6 +98,1121 @@ static bool test_skiplist_concurrency() {
     return true;
 }
 
+static bool test_skiplist_lockfree_basic() {
+    List list(16, 0.5f, Concurrency::LockFree);
+    list.Insert(key_of(3), val_of(30));
+    list.Insert(key_of(1), val_of(10));
+    list.Insert(key_of(2), val_of(20));
+
+    if (!ByteVectorEqual(list.Search(key_of(1)), val_of(10))) return false;
+    if (!ByteVectorEqual(list.Search(key_of(2)), val_of(20))) return false;
+    if (!ByteVectorEqual(list.Search(key_of(3)), val_of(30))) return false;
+    if (!list.Search(key_of(99)).empty()) return false;
+
+    list.Insert(key_of(2), val_of(200));
+    if (!ByteVectorEqual(list.Search(key_of(2)), val_of(200))) return false;
+
+    return true;
+}
+
+static bool test_skiplist_lockfree_stress() {
+    List list(18, 0.5f, Concurrency::LockFree);
+
+    const int writers = 8;
+    const int keys = 4000;
+    const int rounds = 3;
+    std::vector<std::thread> threads;
+    std::barrier sync(writers);
+
+    // Writers interleave over the same key space so CAS races on shared predecessors are common;
+    // every round rewrites each key, exercising update-in-place concurrently with inserts.
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([w, &list, &sync]() {
+            for (int r = 0; r < rounds; ++r) {
+                for (int i = w; i < keys; i += writers / 2) {
+                    list.Insert(key_of(i), val_of(i + r));
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<bool> torn{false};
+    std::thread reader([&]() {
+        std::mt19937 rng(777);
+        std::uniform_int_distribution<int> dist(0, keys - 1);
+        while (!stop.load(std::memory_order_relaxed)) {
+            int k = dist(rng);
+            auto got = list.Search(key_of(k));
+            if (!got.empty()) {
+                const uint8_t v = got[0];
+                bool known = false;
+                for (int r = 0; r < rounds; ++r) known = known || v == val_of(k + r)[0];
+                if (got.size() != 1 || !known) torn.store(true);
+            }
+        }
+    });
+
+    for (auto &t : threads) t.join();
+    stop.store(true);
+    reader.join();
+
+    if (torn.load()) {
+        std::cerr << "skiplist_lockfree_stress reader observed an unexpected value\n";
+        return false;
+    }
+    for (int i = 0; i < keys; ++i) {
+        if (!ByteVectorEqual(list.Search(key_of(i)), val_of(i + rounds - 1))) {
+            std::cerr << "skiplist_lockfree_stress missing or wrong value at " << i << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_skiplist_remove(Concurrency concurrency) {
+    List list(16, 0.5f, concurrency);
+    for (int i = 0; i < 100; ++i) list.Insert(key_of(i), val_of(i));
+
+    // Remove every other key, including the first and the last one
+    for (int i = 0; i < 100; i += 2) {
+        if (!list.Remove(key_of(i))) return false;
+    }
+    if (list.Remove(key_of(0))) return false;     // already removed
+    if (list.Remove(key_of(1000))) return false;  // never present
+
+    for (int i = 0; i < 100; ++i) {
+        auto got = list.Search(key_of(i));
+        if (i % 2 == 0 && !got.empty()) return false;
+        if (i % 2 == 1 && !ByteVectorEqual(got, val_of(i))) return false;
+    }
+
+    // A removed key can be inserted again
+    list.Insert(key_of(4), val_of(44));
+    return ByteVectorEqual(list.Search(key_of(4)), val_of(44));
+}
+
+static bool test_skiplist_remove_locked() {
+    return test_skiplist_remove(Concurrency::Locked);
+}
+
+static bool test_skiplist_remove_lockfree() {
+    return test_skiplist_remove(Concurrency::LockFree);
+}
+
+static bool test_skiplist_remove_combining() {
+    return test_skiplist_remove(Concurrency::Combining);
+}
+
+static ByteVector wide_val_of(int x, int version) {
+    // Multi-byte value so that a reader copying a freed or half-written buffer is detected
+    ByteVector v(32);
+    for (std::size_t i = 0; i < v.size(); ++i) v[i] = static_cast<uint8_t>((x + version) & 0xFF);
+    return v;
+}
+
+static bool test_skiplist_churn(Concurrency concurrency) {
+    List list(16, 0.5f, concurrency);
+
+    const int writers = 4;
+    const int keys = 256;
+    const int operations = 6000;
+    std::atomic<bool> stop{false};
+    std::atomic<bool> torn{false};
+
+    // Writers insert, update and remove the same small key space so that readers constantly
+    // stand on nodes and values that are being unlinked and retired.
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([w, &list]() {
+            std::mt19937 rng(static_cast<unsigned>(w + 1));
+            std::uniform_int_distribution<int> key(0, keys - 1);
+            std::uniform_int_distribution<int> action(0, 2);
+            for (int i = 0; i < operations; ++i) {
+                const int k = key(rng);
+                if (action(rng) == 0) {
+                    list.Remove(key_of(k));
+                } else {
+                    list.Insert(key_of(k), wide_val_of(k, i % 7));
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([r, &list, &stop, &torn]() {
+            std::mt19937 rng(static_cast<unsigned>(100 + r));
+            std::uniform_int_distribution<int> key(0, keys - 1);
+            while (!stop.load(std::memory_order_relaxed)) {
+                const int k = key(rng);
+                auto got = list.Search(key_of(k));
+                if (got.empty()) continue;
+                bool consistent = got.size() == 32;
+                for (std::size_t i = 1; consistent && i < got.size(); ++i) consistent = got[i] == got[0];
+                bool known = false;
+                for (int version = 0; version < 7; ++version) known = known || got[0] == wide_val_of(k, version)[0];
+                if (!consistent || !known) torn.store(true);
+            }
+        });
+    }
+
+    for (auto &t : threads) t.join();
+    stop.store(true);
+    for (auto &t : readers) t.join();
+
+    if (torn.load()) {
+        std::cerr << "skiplist_churn reader observed a torn or foreign value\n";
+        return false;
+    }
+
+    // Quiescent state: removing everything must leave the list empty
+    for (int k = 0; k < keys; ++k) list.Remove(key_of(k));
+    for (int k = 0; k < keys; ++k) {
+        if (!list.Search(key_of(k)).empty()) return false;
+    }
+    return true;
+}
+
+static bool test_skiplist_churn_locked() {
+    return test_skiplist_churn(Concurrency::Locked);
+}
+
+static bool test_skiplist_churn_lockfree() {
+    return test_skiplist_churn(Concurrency::LockFree);
+}
+
+static bool test_skiplist_churn_combining() {
+    return test_skiplist_churn(Concurrency::Combining);
+}
+
+static bool test_skiplist_combining() {
+    List list(18, 0.5f, Concurrency::Combining);
+    list.EnableIndex(8000);
+
+    const int writers = 8;
+    const int per_writer = 1000;
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::barrier sync(writers);
+
+    // Writers hammer neighbouring keys in bursts so that most writes find the lock held and are
+    // applied by another thread's pass; each one still reports its own outcome.
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([w, &list, &ok, &sync]() {
+            for (int i = 0; i < per_writer; ++i) list.Insert(key_of(i * writers + w), val_of(i));
+            sync.arrive_and_wait();
+            for (int i = 0; i < per_writer; i += 2) {
+                if (!list.Remove(key_of(i * writers + w))) ok = false;
+                if (list.Remove(key_of(i * writers + w))) ok = false;
+            }
+            for (int i = 1; i < per_writer; i += 2) list.Insert(key_of(i * writers + w), val_of(i + 1));
+        });
+    }
+    // A finished write is visible to every later read
+    std::thread reader([&]() {
+        ByteVector out;
+        for (int i = 0; !done.load(); i = (i + 7) % (writers * per_writer)) {
+            if (list.SearchInto(key_of(i), out) && out != val_of(i / writers) && out != val_of(i / writers + 1)) ok = false;
+        }
+    });
+    for (auto& t : threads) t.join();
+    done = true;
+    reader.join();
+
+    for (int i = 0; i < writers * per_writer; ++i) {
+        const ByteVector found = list.Search(key_of(i));
+        if (i / writers % 2 == 0 ? !found.empty() : found != val_of(i / writers + 1)) return false;
+    }
+    const LockStats stats = list.GetLockStats();
+    return ok && list.Scan({}, {}).size() == writers * per_writer / 2 && stats.Combined <= stats.Contended
+        && stats.Acquisitions + stats.Combined >= writers * per_writer * 2;
+}
+
+static bool test_skiplist_memory_stats() {
+    List list(16, 0.5f);
+    if (list.GetMemoryStats().UsedBytes == 0) return false; // the head node lives in the arena too
+
+    const std::size_t before = list.GetMemoryStats().UsedBytes;
+    for (int i = 0; i < 1000; ++i) list.Insert(key_of(i), val_of(i));
+    const ArenaStats filled = list.GetMemoryStats();
+    // One block per entry: header, tower, 4 key bytes and 1 value byte fit well under 128 bytes
+    if (filled.UsedBytes - before > 1000 * 128) return false;
+
+    // Replaced values and removed nodes go back to the arena once readers are gone
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 1000; ++i) list.Remove(key_of(i));
+        for (int i = 0; i < 1000; ++i) list.Insert(key_of(i), val_of(i + round));
+    }
+    const ArenaStats churned = list.GetMemoryStats();
+    return churned.FreeListBytes > 0 && churned.ReservedBytes < filled.ReservedBytes * 4;
+}
+
+namespace {
+    // ASCII case-insensitive order without a prefix summary: exercises the plain Less/Equal path.
+    struct CaseInsensitiveOrder {
+        static uint8_t fold(uint8_t c) { return (c >= 'a' && c <= 'z') ? static_cast<uint8_t>(c - 32) : c; }
+
+        static bool Less(ByteView a, ByteView b) noexcept {
+            for (std::size_t i = 0; i < a.size() && i < b.size(); ++i) {
+                if (fold(a[i]) != fold(b[i])) return fold(a[i]) < fold(b[i]);
+            }
+            return a.size() < b.size();
+        }
+
+        static bool Equal(ByteView a, ByteView b) noexcept {
+            return !Less(a, b) && !Less(b, a);
+        }
+    };
+
+    ByteVector bytes_of(const char* text) {
+        return ByteVector(text, text + std::char_traits<char>::length(text));
+    }
+
+    template <KeyOrder Order>
+    bool roundtrip(Concurrency concurrency, ByteVector (*make_key)(int)) {
+        BasicList<Order> list(16, 0.5f, concurrency);
+        for (int i = 0; i < 2000; ++i) list.Insert(make_key(i), val_of(i));
+        for (int i = 0; i < 2000; i += 2) {
+            if (!list.Remove(make_key(i))) return false;
+        }
+        for (int i = 0; i < 2000; ++i) {
+            const ByteVector got = list.Search(make_key(i));
+            if (i % 2 == 0 ? !got.empty() : !ByteVectorEqual(got, val_of(i))) return false;
+        }
+        return true;
+    }
+
+    ByteVector native_key_of(int x) {
+        ByteVector v(sizeof(x));
+        std::memcpy(v.data(), &x, sizeof(x));
+        return v;
+    }
+}
+
+static bool test_skiplist_custom_order() {
+    BasicList<CaseInsensitiveOrder> list(16, 0.5f);
+    list.Insert(bytes_of("Key"), val_of(1));
+    list.Insert(bytes_of("KEY"), val_of(2)); // same key under this order: updates in place
+    list.Insert(bytes_of("other"), val_of(3));
+    if (!ByteVectorEqual(list.Search(bytes_of("key")), val_of(2))) return false;
+    if (!list.Remove(bytes_of("kEy"))) return false;
+    if (!list.Search(bytes_of("Key")).empty()) return false;
+    if (!ByteVectorEqual(list.Search(bytes_of("OTHER")), val_of(3))) return false;
+
+    return roundtrip<ReverseByteOrder>(Concurrency::Locked, &key_of)
+        && roundtrip<ReverseByteOrder>(Concurrency::LockFree, &key_of)
+        && roundtrip<IntegerOrder<int>>(Concurrency::Locked, &native_key_of)
+        && roundtrip<IntegerOrder<int>>(Concurrency::LockFree, &native_key_of)
+        && roundtrip<FixedKey<4>>(Concurrency::Locked, &key_of)
+        && roundtrip<FixedKey<4>>(Concurrency::LockFree, &key_of);
+}
+
+static bool test_skiplist_fixed_keys() {
+    // Fixed keys order like bytes: a scan walks the ids in numeric order
+    BasicList<FixedKey<8>> list(16, 0.5f);
+    for (std::uint64_t id = 1000; id-- > 0;) list.Insert(FixedKey<8>::Encode(id * 7919 % 1000), val_of(static_cast<int>(id)));
+    const auto all = list.Scan({}, {});
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        if (FixedKey<8>::Decode<std::uint64_t>(all[i].Key) != i) return false;
+    }
+    if (all.size() != 1000) return false;
+
+    // Short variable keys built without a vector, inline and spilled alike
+    List named(16, 0.5f);
+    const SmallKey shortKey(AsBytes("user:42")), longKey(AsBytes("user:42:preferences:notifications"));
+    named.Insert(shortKey, val_of(1));
+    named.Insert(longKey, val_of(2));
+    return shortKey.IsInline() && !longKey.IsInline()
+        && ByteVectorEqual(named.Search(AsBytes("user:42")), val_of(1))
+        && ByteVectorEqual(named.Search(longKey), val_of(2));
+}
+
+static bool test_skiplist_scan() {
+    List list(16, 0.5f);
+    for (int i = 0; i < 500; ++i) list.Insert(key_of(i * 2), val_of(i)); // even keys only
+    list.Remove(key_of(10));
+
+    // [7, 15): 8, 12, 14 (10 was removed)
+    const auto range = list.Scan(key_of(7), key_of(15));
+    if (range.size() != 3 || range[0].Key != key_of(8) || range[1].Key != key_of(12) || range[2].Key != key_of(14)) return false;
+    if (range[1].Value != val_of(6)) return false;
+    if (list.Scan(key_of(0), {}, 5).size() != 5 || list.Scan({}, {}).size() != 499) return false;
+    if (!list.Scan(key_of(2000), {}).empty()) return false;
+
+    const auto bound = list.LowerBound(key_of(9));
+    if (!bound || bound->Key != key_of(12)) return false;
+    if (list.LowerBound(key_of(999))) return false;
+
+    // key_of(0x0100..0x01FF) share the prefix {0, 0, 1}
+    const auto prefixed = list.ScanPrefix(ByteVector{0, 0, 1});
+    if (prefixed.size() != 128 || prefixed.front().Key != key_of(0x100) || prefixed.back().Key != key_of(0x1FE)) return false;
+    List edge(8, 0.5f);
+    edge.Insert(ByteVector{0xFF, 0xFF}, val_of(1));
+    edge.Insert(ByteVector{0xFF, 0xFF, 0x01}, val_of(2));
+    edge.Insert(ByteVector{0xFE}, val_of(3));
+    return edge.ScanPrefix(ByteVector{0xFF}).size() == 2;
+}
+
+static bool test_skiplist_cursor() {
+    List list(16, 0.5f);
+    const int count = 1000; // spans many cursor batches
+    for (int i = 0; i < count; ++i) list.Insert(key_of(i), val_of(i));
+
+    int expected = 0;
+    for (auto cursor = list.OpenCursor(); cursor.Valid(); cursor.Next(), ++expected) {
+        if (cursor.Key() != key_of(expected) || cursor.Value() != val_of(expected)) return false;
+    }
+    if (expected != count) return false;
+
+    expected = 899;
+    for (auto cursor = list.OpenCursor(key_of(100), key_of(900), ScanOrder::Descending); cursor.Valid(); cursor.Next(), --expected) {
+        if (cursor.Key() != key_of(expected)) return false;
+    }
+    if (expected != 99) return false;
+
+    // Reverse byte order walks keys from largest to smallest
+    BasicList<ReverseByteOrder> reversed(16, 0.5f);
+    for (int i = 0; i < 100; ++i) reversed.Insert(key_of(i), val_of(i));
+    const auto top = reversed.Scan({}, {}, 3);
+    return top.size() == 3 && top[0].Key == key_of(99) && top[2].Key == key_of(97);
+}
+
+static bool test_skiplist_cursor_concurrent() {
+    // Stable keys (multiples of 4) must be returned exactly once and in order while writers
+    // insert and remove the keys in between.
+    List list(18, 0.5f, Concurrency::LockFree);
+    const int count = 4000;
+    for (int i = 0; i < count; i += 4) list.Insert(key_of(i), val_of(i));
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w]() {
+            std::mt19937 rng(static_cast<unsigned>(w));
+            while (!stop.load(std::memory_order_relaxed)) {
+                const int k = static_cast<int>(rng() % count) | 1;
+                if (rng() % 2) list.Insert(key_of(k), val_of(k));
+                else list.Remove(key_of(k));
+            }
+        });
+    }
+
+    bool ok = true;
+    for (int pass = 0; pass < 20 && ok; ++pass) {
+        const ScanOrder order = pass % 2 == 0 ? ScanOrder::Ascending : ScanOrder::Descending;
+        int stable = 0;
+        ByteVector previous;
+        for (auto cursor = list.OpenCursor({}, {}, order); cursor.Valid(); cursor.Next()) {
+            if (!previous.empty() && (order == ScanOrder::Ascending) != ByteVectorLess(previous, cursor.Key())) ok = false;
+            previous = cursor.Key();
+            const int k = (cursor.Key()[2] << 8) | cursor.Key()[3];
+            if (k % 4 == 0) ++stable;
+        }
+        if (stable != count / 4) ok = false;
+    }
+    stop.store(true);
+    for (auto& t : writers) t.join();
+    return ok;
+}
+
+static bool test_skiplist_multi(Concurrency concurrency) {
+    List list(16, 0.5f, concurrency);
+    std::mt19937 rng(7);
+
+    // Unsorted batch with a duplicate key: the later value wins
+    std::vector<ByteVector> keys;
+    std::vector<ByteVector> values;
+    for (int i = 0; i < 3000; ++i) {
+        keys.push_back(key_of(static_cast<int>(rng() % 100000) * 2));
+        values.push_back(val_of(i));
+    }
+    keys.push_back(keys[10]);
+    values.push_back(val_of(77));
+    std::vector<std::pair<ByteView, ByteView>> batch;
+    for (std::size_t i = 0; i < keys.size(); ++i) batch.emplace_back(keys[i], values[i]);
+    list.MultiInsert(batch);
+    list.MultiInsert(std::span<const std::pair<ByteView, ByteView>>(batch).subspan(500, 500)); // updates in place
+
+    std::vector<ByteView> probe;
+    for (const auto& key : keys) probe.push_back(key);
+    const ByteVector missing = key_of(3); // odd keys were never inserted
+    probe.push_back(missing);
+    const auto found = list.MultiSearch(probe);
+    if (found.size() != probe.size() || found.back().has_value()) return false;
+    for (std::size_t i = 0; i + 1 < probe.size(); ++i) {
+        // Reference answer from a point lookup
+        if (!found[i] || *found[i] != list.Search(probe[i])) return false;
+    }
+    if (*found[10] != val_of(77)) return false;
+
+    // Every key is linked on every level exactly once: a full scan sees each distinct key once
+    const auto all = list.Scan({}, {});
+    for (std::size_t i = 1; i < all.size(); ++i) {
+        if (!ByteVectorLess(all[i - 1].Key, all[i].Key)) return false;
+    }
+    return true;
+}
+
+static bool test_skiplist_multi_locked() {
+    return test_skiplist_multi(Concurrency::Locked);
+}
+
+static bool test_skiplist_multi_lockfree() {
+    return test_skiplist_multi(Concurrency::LockFree);
+}
+
+static bool test_skiplist_multi_search_concurrent() {
+    // Batched readers race point writers; stable keys must always be found.
+    List list(16, 0.5f, Concurrency::LockFree);
+    std::vector<ByteVector> stable;
+    for (int i = 0; i < 2000; i += 2) {
+        stable.push_back(key_of(i));
+        list.Insert(key_of(i), val_of(i));
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        std::mt19937 rng(3);
+        while (!stop.load(std::memory_order_relaxed)) {
+            const int k = static_cast<int>(rng() % 2000) | 1;
+            if (rng() % 2) list.Insert(key_of(k), val_of(k));
+            else list.Remove(key_of(k));
+        }
+    });
+
+    const std::vector<ByteView> probe(stable.begin(), stable.end());
+    bool ok = true;
+    for (int round = 0; round < 50 && ok; ++round) {
+        for (const auto& value : list.MultiSearch(probe)) {
+            if (!value) ok = false;
+        }
+    }
+    stop.store(true);
+    writer.join();
+    return ok;
+}
+
+static bool test_skiplist_bulk_load() {
+    // Sorted input with a run of equal keys: the last one wins
+    std::vector<std::pair<ByteVector, ByteVector>> entries;
+    for (int i = 0; i < 20000; ++i) {
+        entries.emplace_back(key_of(i * 2), val_of(i));
+        if (i == 100) entries.emplace_back(key_of(i * 2), val_of(77));
+    }
+
+    List single(18, 0.5f);
+    List parallel(18, 0.5f, Concurrency::LockFree);
+    single.BulkLoad(entries);
+    parallel.BulkLoad(entries, 4);
+
+    const auto loaded = single.Scan({}, {});
+    if (loaded.size() != 20000 || parallel.Scan({}, {}).size() != loaded.size()) return false;
+    for (int i = 0; i < 20000; ++i) {
+        const ByteVector expected = i == 100 ? val_of(77) : val_of(i);
+        if (single.Search(key_of(i * 2)) != expected || parallel.Search(key_of(i * 2)) != expected) return false;
+        if (!single.Search(key_of(i * 2 + 1)).empty()) return false;
+    }
+
+    // The loaded towers take regular writes afterwards
+    parallel.Insert(key_of(1), val_of(1));
+    if (!parallel.Remove(key_of(0)) || parallel.Search(key_of(1)) != val_of(1)) return false;
+    const auto after = parallel.Scan({}, {}, 2);
+    if (after.size() != 2 || after[0].Key != key_of(1) || after[1].Key != key_of(2)) return false;
+
+    // Unsorted input is rejected before anything is linked; a non-empty list refuses a load
+    std::swap(entries[5], entries[6]);
+    List rejected(18, 0.5f);
+    bool threw = false;
+    try { rejected.BulkLoad(entries); } catch (const std::invalid_argument&) { threw = true; }
+    if (!threw || !rejected.Scan({}, {}).empty()) return false;
+    threw = false;
+    try { single.BulkLoad(std::vector<std::pair<ByteVector, ByteVector>>{}); } catch (const std::logic_error&) { threw = true; }
+    return threw;
+}
+
+static bool test_skiplist_filter() {
+    for (const Concurrency mode : {Concurrency::Locked, Concurrency::LockFree}) {
+        List list(18, 0.5f, mode);
+        list.EnableFilter(20000, 0.01);
+        for (int i = 0; i < 20000; ++i) list.Insert(key_of(i * 2), val_of(i));
+        for (int i = 0; i < 20000; i += 3) list.Insert(key_of(i * 2), val_of(i + 1));
+        for (int i = 1; i < 20000; i += 3) {
+            if (!list.Remove(key_of(i * 2))) return false;
+        }
+
+        // No present key is ever filtered out; most absent ones are
+        for (int i = 0; i < 20000; ++i) {
+            const ByteVector found = list.Search(key_of(i * 2));
+            if (i % 3 == 0 && found != val_of(i + 1)) return false;
+            if (i % 3 == 1 && !found.empty()) return false;
+            if (i % 3 == 2 && found != val_of(i)) return false;
+            if (!list.Search(key_of(i * 2 + 1)).empty()) return false;
+        }
+        const FilterStats stats = list.GetFilterStats();
+        if (stats.Hits != 20000 - 6667 || stats.Negatives + stats.FalsePositives != 20000 + 6667) return false;
+        if (stats.FalsePositives * 20 > stats.Negatives) return false;
+
+        // Batched lookups and batched writes keep it in step too
+        std::vector<ByteVector> keys;
+        std::vector<ByteVector> added;
+        for (int i = 0; i < 300; ++i) {
+            keys.push_back(key_of(i));
+            added.push_back(key_of(100000 + i));
+        }
+        std::vector<ByteView> probe(keys.begin(), keys.end());
+        std::vector<std::pair<ByteView, ByteView>> writes;
+        std::vector<ByteVector> addedValues;
+        for (int i = 0; i < 300; ++i) addedValues.push_back(val_of(i));
+        for (int i = 0; i < 300; ++i) writes.emplace_back(added[i], addedValues[i]);
+        const auto values = list.MultiSearch(probe);
+        for (int i = 0; i < 300; ++i) {
+            if (values[i].has_value() != (i % 2 == 0 && i / 2 % 3 != 1)) return false;
+        }
+        list.MultiInsert(writes);
+        list.MultiInsert(writes);
+        for (int i = 0; i < 300; ++i) {
+            if (list.Search(key_of(100000 + i)) != val_of(i)) return false;
+        }
+
+        // Only an empty list without a filter takes one
+        bool threw = false;
+        try { list.EnableFilter(100, 0.01); } catch (const std::logic_error&) { threw = true; }
+        if (!threw) return false;
+        List filled(18, 0.5f, mode);
+        filled.Insert(key_of(1), val_of(1));
+        threw = false;
+        try { filled.EnableFilter(100, 0.01); } catch (const std::logic_error&) { threw = true; }
+        if (!threw || filled.GetFilterStats().Negatives != 0) return false;
+    }
+
+    // Lock-free churn next to stable keys: readers must always find the stable ones
+    List list(18, 0.5f, Concurrency::LockFree);
+    list.EnableFilter(4000, 0.01);
+    for (int i = 0; i < 2000; ++i) list.Insert(key_of(i * 2), val_of(i));
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w]() {
+            for (int round = 0; round < 10; ++round) {
+                for (int i = w; i < 2000; i += 2) list.Insert(key_of(i * 2 + 1), val_of(round));
+                for (int i = w; i < 2000; i += 2) list.Remove(key_of(i * 2 + 1));
+            }
+        });
+    }
+    std::thread reader([&]() {
+        ByteVector out;
+        while (!done.load()) {
+            for (int i = 0; i < 2000; ++i) {
+                if (!list.SearchInto(key_of(i * 2), out) || out != val_of(i)) ok = false;
+            }
+        }
+    });
+    for (auto& writer : writers) writer.join();
+    done = true;
+    reader.join();
+    for (int i = 0; i < 2000 && ok; ++i) {
+        if (!list.Search(key_of(i * 2 + 1)).empty()) ok = false;
+    }
+    return ok;
+}
+
+static bool test_skiplist_filter_failed_batch() {
+    // A value over the 4 GiB limit throws before any byte of it is read
+    const ByteVector small(1, 0);
+    const ByteView oversized(small.data(), std::size_t{5} << 30);
+    std::vector<ByteVector> keys;
+    for (int i = 0; i < 200; ++i) keys.push_back(key_of(1000 + i));
+
+    auto rejectsAll = [&](const List& list) {
+        for (const ByteVector& key : keys) {
+            if (!list.Search(key).empty()) return false;
+        }
+        // Without leaked counts almost every probe stops at the filter
+        const FilterStats stats = list.GetFilterStats();
+        return stats.FalsePositives * 20 < stats.Negatives;
+    };
+
+    for (const Concurrency mode : {Concurrency::Locked, Concurrency::LockFree}) {
+        // MultiInsert fails on its first key in order: none of the others was reached
+        List list(18, 0.5f, mode);
+        list.EnableFilter(1000, 0.01);
+        std::vector<std::pair<ByteView, ByteView>> writes;
+        for (const ByteVector& key : keys) writes.emplace_back(key, ByteView(small));
+        writes.front().second = oversized;
+        bool threw = false;
+        try { list.MultiInsert(writes); } catch (const std::length_error&) { threw = true; }
+        if (!threw || !rejectsAll(list)) return false;
+
+        // BulkLoad fails on its last key: the nodes built before it are never linked
+        List loaded(18, 0.5f, mode);
+        loaded.EnableFilter(1000, 0.01);
+        writes.front().second = ByteView(small);
+        writes.back().second = oversized;
+        threw = false;
+        try { loaded.BulkLoad(writes); } catch (const std::length_error&) { threw = true; }
+        if (!threw || !rejectsAll(loaded)) return false;
+    }
+    return true;
+}
+
+static bool test_skiplist_index(Concurrency concurrency) {
+    List list(18, 0.5f, concurrency);
+    list.EnableIndex(10000);
+    list.EnableFilter(10000, 0.01);
+    for (int i = 0; i < 10000; ++i) list.Insert(key_of(i * 2), val_of(i));
+    for (int i = 0; i < 10000; i += 2) list.Insert(key_of(i * 2), val_of(i + 1)); // updated in place
+    for (int i = 1; i < 10000; i += 4) {
+        if (!list.Remove(key_of(i * 2))) return false;
+    }
+    for (int i = 1; i < 10000; i += 8) list.Insert(key_of(i * 2), val_of(i + 2)); // new nodes
+    for (int i = 0; i < 10000; ++i) {
+        const ByteVector found = list.Search(key_of(i * 2));
+        const ByteVector expected = i % 2 == 0 ? val_of(i + 1) : i % 8 == 1 ? val_of(i + 2) : i % 4 == 1 ? ByteVector{} : val_of(i);
+        if (found != expected || !list.Search(key_of(i * 2 + 1)).empty()) return false;
+    }
+    // Ordered reads still come from the list
+    if (list.Scan({}, {}).size() != 10000 - 1250 || list.LowerBound(key_of(3))->Key != key_of(4)) return false;
+
+    // A key the index has no room for is still found through the list
+    List small(18, 0.5f, concurrency);
+    small.EnableIndex(1);
+    for (int i = 0; i < 1000; ++i) small.Insert(key_of(i), val_of(i));
+    for (int i = 0; i < 1000; ++i) {
+        if (small.Search(key_of(i)) != val_of(i)) return false;
+    }
+
+    // Bulk loads index what they link; only an empty list without an index takes one
+    std::vector<std::pair<ByteVector, ByteVector>> entries;
+    for (int i = 0; i < 5000; ++i) entries.emplace_back(key_of(i), val_of(i));
+    List loaded(18, 0.5f, concurrency);
+    loaded.EnableIndex(5000);
+    loaded.BulkLoad(entries, 2);
+    loaded.Insert(key_of(7), val_of(70));
+    if (loaded.Search(key_of(7)) != val_of(70) || loaded.Search(key_of(4999)) != val_of(4999)) return false;
+    bool threw = false;
+    try { loaded.EnableIndex(10); } catch (const std::logic_error&) { threw = true; }
+    if (!threw) return false;
+    List plain(18, 0.5f, concurrency);
+    plain.Insert(key_of(1), val_of(1));
+    threw = false;
+    try { plain.EnableIndex(10); } catch (const std::logic_error&) { threw = true; }
+    if (!threw) return false;
+
+    // Writers re-create and update a few hot keys while readers only ever see values of that key
+    List hot(18, 0.5f, concurrency);
+    hot.EnableIndex(64);
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < 2; ++w) {
+        threads.emplace_back([&, w]() {
+            std::mt19937 rng(static_cast<unsigned>(w));
+            for (int i = 0; i < 20000; ++i) {
+                const int key = static_cast<int>(rng() % 16);
+                if (rng() % 3 == 0) hot.Remove(key_of(key));
+                else hot.Insert(key_of(key), ByteVector{static_cast<uint8_t>(key), static_cast<uint8_t>(i)});
+            }
+        });
+    }
+    threads.emplace_back([&]() {
+        ByteVector out;
+        for (int i = 0; !done.load(); i = (i + 1) % 16) {
+            if (hot.SearchInto(key_of(i), out) && (out.size() != 2 || out[0] != i)) ok = false;
+        }
+    });
+    threads[0].join();
+    threads[1].join();
+    done = true;
+    threads[2].join();
+    for (int i = 0; i < 16; ++i) {
+        hot.Insert(key_of(i), val_of(i));
+        if (hot.Search(key_of(i)) != val_of(i)) ok = false;
+    }
+    return ok;
+}
+
+static bool test_skiplist_metrics() {
+    for (const Concurrency mode : {Concurrency::Locked, Concurrency::LockFree, Concurrency::Combining}) {
+        List list(16, 0.5f, mode);
+        for (int i = 0; i < 4000; ++i) list.Insert(key_of(i), val_of(i));               // 4 + 1 bytes each
+        for (int i = 0; i < 4000; i += 2) list.Insert(key_of(i), ByteVector(3, 0x11));  // 2 more value bytes
+        for (int i = 0; i < 4000; i += 4) list.Remove(key_of(i));
+        for (int i = 0; i < 500; ++i) list.Search(key_of(i));
+
+        const ListMetrics metrics = list.GetMetrics();
+        if (metrics.MaxLevel != 16 || metrics.Probability != 0.5f || metrics.Heights.size() != 16) return false;
+        if (metrics.Lock.Acquisitions == 0 && mode != Concurrency::LockFree) return false;
+        if (!MetricsEnabled) {
+            // Compiled out: nothing is counted and everything in use is overhead
+            if (metrics.Entries != 0 || metrics.Searches != 0) return false;
+            if (metrics.OverheadBytes != list.GetMemoryStats().UsedBytes) return false;
+            continue;
+        }
+        std::uint64_t nodes = 0;
+        for (const std::uint64_t count : metrics.Heights) nodes += count;
+        // A p = 0.5 list of 3000 nodes keeps about half of them at height 1 and needs ~13 levels
+        if (metrics.Entries != 3000 || nodes != 3000 || metrics.KeyBytes != 3000 * 4 || metrics.ValueBytes != 3000 + 1000 * 2) return false;
+        if (metrics.Heights[0] < 1300 || metrics.Heights[0] > 1700 || metrics.SuggestedMaxLevel != 13) return false;
+        if (metrics.OverheadBytes == 0 || metrics.Searches != 500 || metrics.AverageVisited() < 5 || metrics.AverageVisited() > 60) return false;
+    }
+
+    // A bulk-loaded list is counted once its nodes are linked
+    if (MetricsEnabled) {
+        std::vector<std::pair<ByteVector, ByteVector>> entries;
+        for (int i = 0; i < 10000; ++i) entries.emplace_back(key_of(i), val_of(i));
+        List loaded(8, 0.25f);
+        loaded.BulkLoad(entries);
+        const ListMetrics metrics = loaded.GetMetrics();
+        if (metrics.Entries != 10000 || metrics.KeyBytes != 40000 || metrics.SuggestedMaxLevel != 8) return false;
+    }
+    return true;
+}
+
+static bool test_skiplist_snapshots(Concurrency concurrency) {
+    List list(16, 0.5f, concurrency);
+    bool threw = false;
+    try { list.OpenSnapshot(); } catch (const std::logic_error&) { threw = true; }
+    if (!threw) return false;
+    list.EnableSnapshots();
+
+    for (int i = 0; i < 1000; ++i) list.Insert(key_of(i), val_of(i));
+    std::size_t retained = 0;
+    {
+        const List::Snapshot snapshot = list.OpenSnapshot();
+        // Overwrite, remove and reinsert behind the snapshot's back
+        for (int i = 0; i < 1000; i += 2) list.Insert(key_of(i), val_of(i + 1));
+        for (int i = 1; i < 1000; i += 4) list.Remove(key_of(i));
+        for (int i = 1000; i < 1100; ++i) list.Insert(key_of(i), val_of(i));
+        for (int i = 3; i < 1000; i += 8) { list.Remove(key_of(i)); list.Insert(key_of(i), val_of(i + 7)); }
+
+        const List::Snapshot later = list.OpenSnapshot();
+        if (later.Sequence() <= snapshot.Sequence()) return false;
+        for (int i = 0; i < 1100; ++i) {
+            const ByteVector then = snapshot.Search(key_of(i));
+            const ByteVector now = list.Search(key_of(i));
+            if (then != (i < 1000 ? val_of(i) : ByteVector{})) return false;
+            if (later.Search(key_of(i)) != now) return false;
+            if (i < 1000 && i % 4 == 1 && !now.empty()) return false;
+        }
+        if (list.Search(key_of(3)) != val_of(10)) return false;
+
+        // Paging through the snapshot sees the same 1000 entries whatever happens in between
+        std::vector<Entry> seen;
+        ByteVector begin;
+        while (true) {
+            std::vector<Entry> page = snapshot.Scan(begin, {}, 128);
+            if (page.empty()) break;
+            begin = page.back().Key;
+            begin.push_back(0);
+            list.Remove(page.front().Key);
+            seen.insert(seen.end(), page.begin(), page.end());
+        }
+        if (seen.size() != 1000) return false;
+        for (int i = 0; i < 1000; ++i) {
+            if (seen[i].Key != key_of(i) || seen[i].Value != val_of(i)) return false;
+        }
+        retained = list.GetMemoryStats().UsedBytes;
+    }
+
+    // Once closed, the kept versions are dropped and the tombstones unlinked
+    for (int i = 0; i < 64; ++i) list.Insert(key_of(2), val_of(i)); // lets the epoch reclaim
+    if (list.GetMemoryStats().UsedBytes + 500 * 24 > retained) return false;
+    for (int i = 2000; i < 3000; ++i) list.Insert(key_of(i), val_of(i));
+    for (int i = 1; i < 1000; i += 4) {
+        if (!list.Search(key_of(i)).empty() || list.Remove(key_of(i))) return false;
+    }
+
+    // Writers keep going while a reader walks a snapshot
+    auto same = [](const std::vector<Entry>& a, const std::vector<Entry>& b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i].Key != b[i].Key || a[i].Value != b[i].Value) return false;
+        }
+        return true;
+    };
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 2000; i < 3000; i += 3) list.Insert(key_of(i), val_of(i + round + 1));
+            for (int i = 2001; i < 3000; i += 3) list.Remove(key_of(i));
+            for (int i = 2001; i < 3000; i += 3) list.Insert(key_of(i), val_of(i));
+        }
+        done = true;
+    });
+    while (!done.load()) {
+        const List::Snapshot snapshot = list.OpenSnapshot();
+        const std::vector<Entry> all = snapshot.Scan(key_of(2000), key_of(3000));
+        if (!same(all, snapshot.Scan(key_of(2000), key_of(3000))) || all.size() < 666) ok = false;
+        for (const Entry& entry : all) {
+            if (snapshot.Search(entry.Key) != entry.Value) ok = false;
+        }
+    }
+    writer.join();
+
+    // Versions need serialized writers and a fresh list
+    List lockFree(16, 0.5f, Concurrency::LockFree);
+    List used(16, 0.5f, concurrency);
+    used.Insert(key_of(1), val_of(1));
+    int refused = 0;
+    try { lockFree.EnableSnapshots(); } catch (const std::logic_error&) { ++refused; }
+    try { used.EnableSnapshots(); } catch (const std::logic_error&) { ++refused; }
+    try { list.EnableSnapshots(); } catch (const std::logic_error&) { ++refused; }
+    return ok && refused == 3;
+}
+
+static bool test_skiplist_snapshots_locked() {
+    return test_skiplist_snapshots(Concurrency::Locked);
+}
+
+static bool test_skiplist_snapshots_combining() {
+    return test_skiplist_snapshots(Concurrency::Combining);
+}
+
+static bool test_skiplist_read_modify_write(Concurrency concurrency) {
+    List list(16, 0.5f, concurrency);
+    list.EnableFilter(1000, 0.01);
+    list.EnableIndex(1000);
+
+    // Update sees the current value (or its absence) and may decline to write
+    auto doubled = [](std::optional<ByteView> current, ByteVector& out) {
+        if (!current.has_value()) {
+            out = {1};
+            return true;
+        }
+        if (current->front() >= 100) return false;
+        out = {static_cast<uint8_t>(current->front() * 2)};
+        return true;
+    };
+    if (!list.Update(key_of(1), doubled) || list.Search(key_of(1)) != ByteVector{1}) return false;
+    for (int i = 0; i < 7; ++i) list.Update(key_of(1), doubled);
+    if (list.Update(key_of(1), doubled) || list.Search(key_of(1)) != ByteVector{128}) return false;
+    if (list.Update(key_of(2), [](std::optional<ByteView>, ByteVector&) { return false; }) || !list.Search(key_of(2)).empty()) return false;
+
+    // Compare-and-insert and insert-if-absent
+    if (!list.InsertIfAbsent(key_of(3), val_of(3)) || list.InsertIfAbsent(key_of(3), val_of(4))) return false;
+    if (list.CompareAndInsert(key_of(3), ByteView(val_of(9)), val_of(5)) || list.Search(key_of(3)) != val_of(3)) return false;
+    if (!list.CompareAndInsert(key_of(3), ByteView(val_of(3)), val_of(5)) || list.Search(key_of(3)) != val_of(5)) return false;
+    if (list.CompareAndInsert(key_of(4), ByteView(val_of(4)), val_of(5)) || !list.Search(key_of(4)).empty()) return false;
+    list.Remove(key_of(3));
+    if (!list.InsertIfAbsent(key_of(3), val_of(6)) || list.Search(key_of(3)) != val_of(6)) return false;
+
+    // Merge needs an operator; a failing one leaves the key alone
+    bool threw = false;
+    try { list.Merge(key_of(10), EncodeInt64(1)); } catch (const std::logic_error&) { threw = true; }
+    if (!threw) return false;
+    list.SetMergeOperator(&MergeAddInt64);
+    threw = false;
+    try { list.SetMergeOperator(&MergeAppend); } catch (const std::logic_error&) { threw = true; }
+    if (!threw) return false;
+    list.Merge(key_of(10), EncodeInt64(-5));
+    threw = false;
+    try { list.Merge(key_of(10), ByteVector(3, 0)); } catch (const std::invalid_argument&) { threw = true; }
+    if (!threw || DecodeInt64(list.Search(key_of(10))) != -5) return false;
+
+    // Concurrent counters lose no increment
+    const int threads = 4;
+    const int perThread = 2000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&list, t]() {
+            for (int i = 0; i < perThread; ++i) list.Merge(key_of(100 + (i + t) % 8), EncodeInt64(i % 3 + 1));
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    std::int64_t total = 0;
+    for (int k = 0; k < 8; ++k) total += DecodeInt64(list.Search(key_of(100 + k)));
+    std::int64_t expected = 0;
+    for (int i = 0; i < perThread; ++i) expected += threads * (i % 3 + 1);
+    if (total != expected) return false;
+
+    // Append merges bytes in place of a get + put
+    List log(8, 0.5f, concurrency);
+    log.SetMergeOperator(&MergeAppend);
+    for (int i = 0; i < 5; ++i) log.Merge(key_of(1), val_of(i));
+    return log.Search(key_of(1)) == ByteVector({0, 1, 2, 3, 4});
+}
+
+static bool test_skiplist_read_modify_write_locked() {
+    return test_skiplist_read_modify_write(Concurrency::Locked);
+}
+
+static bool test_skiplist_read_modify_write_lockfree() {
+    return test_skiplist_read_modify_write(Concurrency::LockFree);
+}
+
+static bool test_skiplist_read_modify_write_combining() {
+    return test_skiplist_read_modify_write(Concurrency::Combining);
+}
+
+static bool test_skiplist_adaptive_levels() {
+    // Four levels are far too few for 20000 keys: a descent walks hundreds of nodes on the top one
+    List list(4, 0.5f);
+    list.EnableIndex(30000);
+    const int count = 20000;
+    for (int i = 0; i < count; ++i) list.Insert(key_of(i), val_of(i));
+    const LevelStats shallow = list.GetLevelStats();
+    if (shallow.MaxLevel != 4 || shallow.Entries != 0 || shallow.SearchDepth < 200) return false;
+
+    // The limit follows the entry count from now on: ceil(log2 20000) + 1 levels
+    list.EnableAdaptiveLevels();
+    if (list.GetLevelStats().MaxLevel != 16 || list.GetLevelStats().Entries != count) return false;
+
+    // Rebalance in small steps while a reader checks every key and a writer updates through the index
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+        ByteVector out;
+        for (int i = 0; !done.load(); i = (i + 7919) % count) {
+            if (!list.SearchInto(key_of(i), out)) ok = false;
+        }
+    });
+    std::thread writer([&]() {
+        for (int i = 0; i < count; i += 5) list.Insert(key_of(i), val_of(i + 1));
+    });
+    list.Rebalance(64);
+    writer.join();
+    done = true;
+    reader.join();
+
+    const LevelStats balanced = list.GetLevelStats();
+    if (!ok || balanced.Passes != 1 || balanced.Relocated == 0 || balanced.SearchDepth > 60 || balanced.CurrentLevel < 14) return false;
+    const std::vector<Entry> all = list.Scan({}, {});
+    if (all.size() != static_cast<std::size_t>(count)) return false;
+    for (int i = 0; i < count; ++i) {
+        if (all[i].Key != key_of(i) || all[i].Value != val_of(i % 5 == 0 ? i + 1 : i)) return false;
+    }
+
+    // Shrinking lowers the limit, and a pass drops the levels no longer needed
+    for (int i = 1000; i < count; ++i) list.Remove(key_of(i));
+    for (int i = 0; i < 1000; ++i) list.Insert(key_of(i), val_of(i));
+    list.Rebalance();
+    const LevelStats shrunk = list.GetLevelStats();
+    if (shrunk.MaxLevel != 11 || shrunk.Entries != 1000 || shrunk.CurrentLevel >= 11) return false;
+
+    // Snapshots keep reading through re-towered nodes
+    List versioned(2, 0.5f, Concurrency::Combining);
+    versioned.EnableSnapshots();
+    for (int i = 0; i < 3000; ++i) versioned.Insert(key_of(i), val_of(i));
+    versioned.EnableAdaptiveLevels();
+    const List::Snapshot snapshot = versioned.OpenSnapshot();
+    for (int i = 0; i < 3000; i += 2) versioned.Insert(key_of(i), val_of(i + 1));
+    versioned.Rebalance();
+    for (int i = 0; i < 3000; ++i) {
+        if (snapshot.Search(key_of(i)) != val_of(i) || versioned.Search(key_of(i)) != val_of(i % 2 == 0 ? i + 1 : i)) return false;
+    }
+
+    int refused = 0;
+    List lockFree(16, 0.5f, Concurrency::LockFree);
+    try { lockFree.RebalanceStep(); } catch (const std::logic_error&) { ++refused; }
+    try { list.EnableAdaptiveLevels(); } catch (const std::logic_error&) { ++refused; }
+    return refused == 2;
+}
+
+static bool test_skiplist_eviction() {
+    for (const Concurrency mode : {Concurrency::Locked, Concurrency::LockFree, Concurrency::Combining}) {
+        List list(16, 0.5f, mode);
+        list.EnableIndex(4096);
+        const std::size_t budget = 64 * 1024;
+        list.EnableEviction(budget);
+        const ByteVector payload(32, 0x5A);
+
+        // A read-through cache: 100 hot keys looked up every 50 writes, and put back on a miss,
+        // stay cached while 10000 cold keys stream past them. The first turn of the hand finds
+        // every entry referenced and clears all bits, so each hot key may miss once.
+        std::uint64_t hotMisses = 0;
+        for (int i = 0; i < 100; ++i) list.Insert(key_of(i), payload);
+        for (int i = 100; i < 10100; ++i) {
+            list.Insert(key_of(i), payload);
+            if (i % 50 == 0) {
+                for (int hot = 0; hot < 100; ++hot) {
+                    if (list.Search(key_of(hot)).empty()) {
+                        ++hotMisses;
+                        list.Insert(key_of(hot), payload);
+                    }
+                }
+            }
+        }
+        CacheStats stats = list.GetCacheStats();
+        if (stats.BudgetBytes != budget || stats.ChargedBytes > budget || stats.ChargedBytes < budget / 2) return false;
+        if (stats.Evictions < 9000 || stats.SecondChances == 0 || stats.Hits + stats.Misses != 100 * 200) return false;
+        if (stats.Misses != hotMisses || hotMisses > 100 || stats.HitRate() < 0.99) return false;
+        if (!list.Search(key_of(999999)).empty() || list.GetCacheStats().Misses != hotMisses + 1) return false;
+
+        // Replacing values is charged too, and removing every entry leaves nothing charged
+        for (int hot = 0; hot < 100; ++hot) list.Insert(key_of(hot), ByteVector(64, 1));
+        stats = list.GetCacheStats();
+        if (stats.ChargedBytes > budget || list.Search(key_of(99)) != ByteVector(64, 1)) return false;
+        for (const Entry& entry : list.Scan({}, {})) list.Remove(entry.Key);
+        if (list.GetCacheStats().ChargedBytes != 0) return false;
+    }
+
+    // An existing list is charged when eviction is enabled, and trimmed by the next write
+    List grown(16, 0.5f);
+    for (int i = 0; i < 5000; ++i) grown.Insert(key_of(i), val_of(i));
+    grown.EnableEviction(16 * 1024);
+    if (grown.GetCacheStats().ChargedBytes < 16 * 1024) return false;
+    grown.Insert(key_of(5000), val_of(5000));
+    if (grown.GetCacheStats().ChargedBytes > 16 * 1024 || grown.Search(key_of(5000)).empty()) return false;
+
+    int refused = 0;
+    try { grown.EnableEviction(1024); } catch (const std::logic_error&) { ++refused; }
+    try { grown.EnableSnapshots(); } catch (const std::logic_error&) { ++refused; }
+    List versioned(16, 0.5f);
+    versioned.EnableSnapshots();
+    try { versioned.EnableEviction(1024); } catch (const std::logic_error&) { ++refused; }
+    try { List(16, 0.5f).EnableEviction(0); } catch (const std::invalid_argument&) { ++refused; }
+    return refused == 4 && List(16, 0.5f).GetCacheStats().BudgetBytes == 0;
+}
+
+static bool test_skiplist_eviction_concurrent() {
+    List list(16, 0.5f, Concurrency::LockFree);
+    const std::size_t budget = 128 * 1024;
+    list.EnableEviction(budget);
+    const int writers = 4;
+    const int perWriter = 5000;
+    std::atomic<bool> ok{true};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            for (int i = w; i < writers * perWriter; i += writers) list.Insert(key_of(i), val_of(i));
+        });
+    }
+    // Readers set reference bits and must only ever see the right value, or none once evicted
+    std::thread reader([&]() {
+        ByteVector out;
+        for (int i = 0; !done.load(); i = (i + 7919) % (writers * perWriter)) {
+            if (list.SearchInto(key_of(i), out) && out != val_of(i)) ok = false;
+        }
+    });
+    for (auto& thread : threads) thread.join();
+    done = true;
+    reader.join();
+
+    // A writer that found the hand taken may have left the total a little over; the next write trims it
+    list.Insert(key_of(writers * perWriter), val_of(writers * perWriter));
+    const CacheStats stats = list.GetCacheStats();
+    std::size_t live = 0;
+    for (const Entry& entry : list.Scan({}, {})) {
+        if (entry.Value != val_of(entry.Key[3])) return false; // val_of keeps the low byte
+        ++live;
+    }
+    return ok && stats.ChargedBytes <= budget && stats.Evictions > 0 && live + stats.Evictions == writers * perWriter + 1;
+}
+
+static bool test_skiplist_index_locked() {
+    return test_skiplist_index(Concurrency::Locked);
+}
+
+static bool test_skiplist_index_lockfree() {
+    return test_skiplist_index(Concurrency::LockFree);
+}
+
 int main() {
     int failed = 0;
     auto run = [&](const char* name, bool (*fn)()) {
@@ -103,6 +1223,38 @@ int main() {
 
     run("skiplist_basic", &test_skiplist_basic);
     run("skiplist_concurrency", &test_skiplist_concurrency);
+    run("skiplist_lockfree_basic", &test_skiplist_lockfree_basic);
+    run("skiplist_lockfree_stress", &test_skiplist_lockfree_stress);
+    run("skiplist_remove_locked", &test_skiplist_remove_locked);
+    run("skiplist_remove_lockfree", &test_skiplist_remove_lockfree);
+    run("skiplist_remove_combining", &test_skiplist_remove_combining);
+    run("skiplist_churn_locked", &test_skiplist_churn_locked);
+    run("skiplist_churn_lockfree", &test_skiplist_churn_lockfree);
+    run("skiplist_churn_combining", &test_skiplist_churn_combining);
+    run("skiplist_combining", &test_skiplist_combining);
+    run("skiplist_memory_stats", &test_skiplist_memory_stats);
+    run("skiplist_custom_order", &test_skiplist_custom_order);
+    run("skiplist_fixed_keys", &test_skiplist_fixed_keys);
+    run("skiplist_scan", &test_skiplist_scan);
+    run("skiplist_cursor", &test_skiplist_cursor);
+    run("skiplist_cursor_concurrent", &test_skiplist_cursor_concurrent);
+    run("skiplist_multi_locked", &test_skiplist_multi_locked);
+    run("skiplist_multi_lockfree", &test_skiplist_multi_lockfree);
+    run("skiplist_multi_search_concurrent", &test_skiplist_multi_search_concurrent);
+    run("skiplist_bulk_load", &test_skiplist_bulk_load);
+    run("skiplist_filter", &test_skiplist_filter);
+    run("skiplist_filter_failed_batch", &test_skiplist_filter_failed_batch);
+    run("skiplist_metrics", &test_skiplist_metrics);
+    run("skiplist_index_locked", &test_skiplist_index_locked);
+    run("skiplist_index_lockfree", &test_skiplist_index_lockfree);
+    run("skiplist_snapshots_locked", &test_skiplist_snapshots_locked);
+    run("skiplist_snapshots_combining", &test_skiplist_snapshots_combining);
+    run("skiplist_read_modify_write_locked", &test_skiplist_read_modify_write_locked);
+    run("skiplist_read_modify_write_lockfree", &test_skiplist_read_modify_write_lockfree);
+    run("skiplist_read_modify_write_combining", &test_skiplist_read_modify_write_combining);
+    run("skiplist_adaptive_levels", &test_skiplist_adaptive_levels);
+    run("skiplist_eviction", &test_skiplist_eviction);
+    run("skiplist_eviction_concurrent", &test_skiplist_eviction_concurrent);
 
     if (failed == 0) {
         std::cout << "All SkipList tests passed" << std::endl;
@@ -0,0 +1,165 @@
+/*
+ * Tests for snapshot files only: SnapshotWriter/MappedSnapshot round trip, lookups and scans
+ * across block boundaries, damage detection, and snapshots of a ThreadByteTree under writers.
+ */
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ThreadByteTree.h"
+#include "include/snapshot.h"
+
+using namespace tbt;
+
+namespace {
+    std::string temp_snapshot(const char* name) {
+        const auto path = std::filesystem::temp_directory_path() / (std::string("tbt_snapshot_") + name + "_" + std::to_string(::getpid()) + ".snap");
+        std::filesystem::remove(path);
+        return path.string();
+    }
+
+    // Keys sharing long prefixes, so prefix compression is exercised
+    ByteVector key_of(int x) {
+        const std::string key = "user:" + std::to_string(1000000 + x);
+        return ByteVector(key.begin(), key.end());
+    }
+
+    ByteVector val_of(int x) {
+        return ByteVector(static_cast<std::size_t>(x % 50), static_cast<uint8_t>(x));
+    }
+}
+
+static bool test_snapshot_round_trip() {
+    const std::string path = temp_snapshot("round_trip");
+    const int count = 5000;
+    {
+        SnapshotWriter writer(path);
+        for (int i = 0; i < count; i += 2) writer.Add(key_of(i), val_of(i));
+        writer.Finish();
+    }
+
+    MappedSnapshot snapshot(path);
+    bool ok = snapshot.Size() == count / 2 && snapshot.BlockCount() > 1;
+    for (int i = 0; i < count && ok; ++i) {
+        const auto value = snapshot.Get(key_of(i));
+        if (i % 2 == 0) ok = value && ByteVectorEqual(*value, val_of(i));
+        else ok = !value;
+    }
+    ok = ok && !snapshot.Get(AsBytes("a")) && !snapshot.Get(AsBytes("zzz")) && !snapshot.Get({});
+
+    // Scans start mid-block, cross block boundaries and stop at the bound
+    const auto page = snapshot.Scan(key_of(1001), key_of(2001));
+    ok = ok && page.size() == 500 && page.front().Key == key_of(1002) && page.back().Key == key_of(2000);
+    ok = ok && snapshot.Scan({}, {}).size() == count / 2 && snapshot.Scan({}, {}, 3).size() == 3;
+    std::filesystem::remove(path);
+    return ok;
+}
+
+static bool test_snapshot_empty_and_order() {
+    const std::string path = temp_snapshot("empty");
+    {
+        SnapshotWriter writer(path);
+        writer.Finish();
+    }
+    MappedSnapshot empty(path);
+    if (empty.Size() != 0 || empty.Get(AsBytes("k")) || !empty.Scan({}, {}).empty()) return false;
+
+    // Out-of-order keys are refused; an unfinished writer leaves the existing file alone
+    bool threw = false;
+    {
+        SnapshotWriter writer(path);
+        writer.Add(AsBytes("b"), AsBytes("1"));
+        try { writer.Add(AsBytes("a"), AsBytes("2")); } catch (const std::invalid_argument&) { threw = true; }
+    }
+    const bool kept = MappedSnapshot(path).Size() == 0 && !std::filesystem::exists(path + ".tmp");
+    std::filesystem::remove(path);
+    return threw && kept;
+}
+
+static bool test_snapshot_damage() {
+    const std::string path = temp_snapshot("damage");
+    {
+        SnapshotWriter writer(path);
+        for (int i = 0; i < 2000; ++i) writer.Add(key_of(i), val_of(i));
+        writer.Finish();
+    }
+    // Damage a byte inside the first block: lookups there fail, other blocks still serve
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(100);
+        const char byte = static_cast<char>(file.get());
+        file.seekp(100);
+        file.put(static_cast<char>(byte ^ 0x55));
+    }
+    bool ok = false;
+    {
+        MappedSnapshot snapshot(path);
+        try { snapshot.Get(key_of(0)); } catch (const std::runtime_error&) { ok = true; }
+        ok = ok && snapshot.Get(key_of(1999)).has_value();
+    }
+
+    // A truncated file is rejected at open
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    bool rejected = false;
+    try { MappedSnapshot snapshot(path); } catch (const std::runtime_error&) { rejected = true; }
+    std::filesystem::remove(path);
+    return ok && rejected;
+}
+
+static bool test_snapshot_tree_under_writers() {
+    // Even keys stay put while writers churn the odd ones: all of them must be in the snapshot.
+    const std::string path = temp_snapshot("tree");
+    ThreadByteTree tbtree(16, 0.5f, Concurrency::LockFree);
+    const int count = 20000;
+    for (int i = 0; i < count; i += 2) tbtree.put(key_of(i), val_of(i));
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        for (int round = 0; !stop.load(std::memory_order_relaxed); ++round) {
+            const int k = (round * 7919 % count) | 1;
+            if (round % 2) tbtree.put(key_of(k), val_of(k));
+            else tbtree.erase(key_of(k));
+        }
+    });
+    const std::uint64_t written = tbtree.snapshot(path);
+    stop.store(true);
+    writer.join();
+
+    MappedSnapshot snapshot(path);
+    bool ok = snapshot.Size() == written && written >= count / 2;
+    for (int i = 0; i < count && ok; i += 2) {
+        const auto value = snapshot.Get(key_of(i));
+        ok = value && ByteVectorEqual(*value, val_of(i));
+    }
+    std::filesystem::remove(path);
+    return ok;
+}
+
+int main() {
+    int failed = 0;
+    auto run = [&](const char* name, bool (*fn)()) {
+        bool ok = fn();
+        std::cout << (ok ? "OK: " : "FAIL: ") << name << "\n";
+        if (!ok) ++failed;
+    };
+
+    run("snapshot_round_trip", &test_snapshot_round_trip);
+    run("snapshot_empty_and_order", &test_snapshot_empty_and_order);
+    run("snapshot_damage", &test_snapshot_damage);
+    run("snapshot_tree_under_writers", &test_snapshot_tree_under_writers);
+
+    if (failed == 0) {
+        std::cout << "All Snapshot tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << failed << " Snapshot test(s) failed" << std::endl;
+    return 1;
+}
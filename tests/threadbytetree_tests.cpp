@@ -1,15 +1,41 @@
 /*
- * Tests for ThreadByteTree only: basic put/get/update and concurrent writers.
+ * Tests for ThreadByteTree only: basic put/get/update, concurrent writers and zero-copy reads.
  */
 
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <thread>
 
+#include <unistd.h>
+
 #include "ThreadByteTree.h"
 
 using namespace tbt;
 
+// Counts heap allocations so tests can assert that a lookup path allocates nothing.
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
 static ByteVector key_of(int x) {
     // 4-byte big-endian representation to preserve numeric order under lexicographic compare
     ByteVector v(4);
@@ -38,6 +64,11 @@ static bool test_threadbytetree_basic() {
     tbtree.put(key_of(42), val_of(8));
     if (!ByteVectorEqual(tbtree.get(key_of(42)), val_of(8))) return false;
 
+    // Erase
+    if (!tbtree.erase(key_of(42))) return false;
+    if (!tbtree.get(key_of(42)).empty()) return false;
+    if (tbtree.erase(key_of(42))) return false;
+
     return true;
 }
 
@@ -69,6 +100,221 @@ static bool test_threadbytetree_concurrency() {
     return true;
 }
 
+static bool test_threadbytetree_lockfree() {
+    ThreadByteTree tbtree(20, 0.5f, Concurrency::LockFree);
+    const int writers = 4;
+    const int keys = 3000;
+
+    // Overlapping ranges: every key is written by two threads with the same value.
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([w, &tbtree]() {
+            for (int i = (w / 2); i < keys; i += writers / 2) {
+                tbtree.put(key_of(i), val_of(i));
+            }
+        });
+    }
+
+    for (auto &t : threads) t.join();
+
+    for (int i = 0; i < keys; ++i) {
+        auto got = tbtree.get(key_of(i));
+        if (got.empty() || !ByteVectorEqual(got, val_of(i))) {
+            std::cerr << "threadbytetree_lockfree wrong value at " << i << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_threadbytetree_zero_copy() {
+    ThreadByteTree tbtree(16, 0.5f, Concurrency::LockFree);
+    const ByteVector blob(16 * 1024, 0xAB);
+    tbtree.put(key_of(1), blob);
+
+    if (tbtree.get_view(key_of(2))) return false; // missing
+
+    ValueView view = tbtree.get_view(key_of(1));
+    if (!view || !ByteVectorEqual(view.View(), blob)) return false;
+
+    // Another thread overwrites and erases the key while the view is held: the viewed bytes
+    // must stay intact (ASan builds report any reuse of them).
+    std::thread writer([&tbtree]() {
+        for (int i = 0; i < 2000; ++i) {
+            tbtree.put(key_of(1), ByteVector(16 * 1024, static_cast<uint8_t>(i)));
+            if (i % 3 == 0) tbtree.erase(key_of(1));
+        }
+    });
+    writer.join();
+    if (!ByteVectorEqual(view.View(), blob)) return false;
+    view.reset();
+    if (view) return false;
+
+    // get_into reuses the caller's capacity
+    tbtree.put(key_of(3), blob);
+    ByteVector out;
+    out.reserve(64 * 1024);
+    const uint8_t* storage = out.data();
+    if (!tbtree.get_into(key_of(3), out) || !ByteVectorEqual(out, blob) || out.data() != storage) return false;
+    if (tbtree.get_into(key_of(4), out) || !out.empty()) return false;
+    return true;
+}
+
+static bool test_threadbytetree_views() {
+    ThreadByteTree tbtree(16, 0.5f);
+    tbtree.put(std::string_view("user:42"), std::string_view("alice"));
+    if (!ByteVectorEqual(tbtree.get(std::string_view("user:42")), AsBytes("alice"))) return false;
+
+    // Keys that already live in a foreign buffer are used in place
+    const std::string packet = "GET user:42\r\n";
+    const ByteView key = AsBytes(packet).subspan(4, 7);
+    ByteVector out;
+    out.reserve(64);
+    (void)tbtree.get_view(key); // first use registers the thread with the list's epoch
+
+    const std::size_t before = allocations.load();
+    const bool viewed = static_cast<bool>(tbtree.get_view(key));
+    const bool copied = tbtree.get_into(key, out);
+    const bool missing = !tbtree.get_view(AsBytes("user:43"));
+    if (allocations.load() != before) return false;
+
+    if (!viewed || !copied || !missing || !ByteVectorEqual(out, AsBytes("alice"))) return false;
+    return tbtree.erase(std::string_view("user:42")) && tbtree.get(key).empty();
+}
+
+static bool test_threadbytetree_scan() {
+    ThreadByteTree tbtree(16, 0.5f);
+    for (const char* key : {"user:1", "user:2", "user:3", "video:1"}) tbtree.put(std::string_view(key), std::string_view("x"));
+
+    if (tbtree.scan_prefix(AsBytes("user:")).size() != 3) return false;
+    const auto page = tbtree.scan(AsBytes("user:2"), {}, 2);
+    if (page.size() != 2 || page[1].Key != ByteVector(AsBytes("user:3").begin(), AsBytes("user:3").end())) return false;
+    const auto next = tbtree.lower_bound(AsBytes("user:4"));
+    if (!next || !ByteVectorEqual(next->Key, AsBytes("video:1"))) return false;
+
+    int seen = 0;
+    for (auto cursor = tbtree.cursor({}, {}, ScanOrder::Descending); cursor.Valid(); cursor.Next()) ++seen;
+    return seen == 4;
+}
+
+static bool test_threadbytetree_multi() {
+    ThreadByteTree tbtree(16, 0.5f);
+    std::vector<std::pair<ByteVector, ByteVector>> entries;
+    for (int i = 99; i >= 0; --i) entries.emplace_back(key_of(i), val_of(i));
+    tbtree.multi_put(entries);
+
+    const std::vector<ByteVector> keys = {key_of(5), key_of(500), key_of(0)};
+    const auto values = tbtree.multi_get(keys);
+    return values.size() == 3 && values[0] == val_of(5) && !values[1] && values[2] == val_of(0);
+}
+
+static bool test_threadbytetree_bulk_load() {
+    ThreadByteTree tbtree(16, 0.5f);
+    std::vector<std::pair<ByteVector, ByteVector>> entries;
+    for (int i = 0; i < 100; ++i) entries.emplace_back(key_of(i), val_of(i));
+    tbtree.bulk_load(entries);
+
+    tbtree.put(key_of(100), val_of(100));
+    return tbtree.get(key_of(42)) == val_of(42) && tbtree.scan({}, {}).size() == 101;
+}
+
+static bool test_threadbytetree_log_replay() {
+    const std::string path = (std::filesystem::temp_directory_path() / ("tbt_tree_" + std::to_string(::getpid()) + ".log")).string();
+    std::filesystem::remove(path);
+    {
+        ThreadByteTree tbtree(16, 0.5f);
+        if (tbtree.open_log(path) != 0) return false;
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&tbtree, t]() {
+                for (int i = t * 100; i < (t + 1) * 100; ++i) tbtree.put(key_of(i), val_of(i));
+            });
+        }
+        for (auto& writer : writers) writer.join();
+        tbtree.erase(key_of(7));
+        tbtree.put(key_of(8), val_of(88));
+        std::vector<std::pair<ByteVector, ByteVector>> batch = {{key_of(500), val_of(5)}, {key_of(9), val_of(99)}};
+        tbtree.multi_put(batch);
+        if (tbtree.logStats().Records != 404) return false;
+    }
+
+    // A fresh store rebuilt from the log matches the one that wrote it
+    ThreadByteTree recovered(16, 0.5f);
+    const std::uint64_t replayed = recovered.open_log(path);
+    recovered.put(key_of(600), val_of(6));
+    std::filesystem::remove(path);
+    return replayed == 404 && recovered.get(key_of(7)).empty() && recovered.get(key_of(8)) == val_of(88) &&
+           recovered.get(key_of(9)) == val_of(99) && recovered.get(key_of(399)) == val_of(399) &&
+           recovered.scan({}, {}).size() == 401;
+}
+
+static bool test_threadbytetree_rejected_batch_log() {
+    const std::string path = (std::filesystem::temp_directory_path() / ("tbt_rejected_" + std::to_string(::getpid()) + ".log")).string();
+    std::filesystem::remove(path);
+    {
+        ThreadByteTree tbtree(16, 0.5f);
+        tbtree.open_log(path);
+        std::vector<std::pair<ByteVector, ByteVector>> unsorted = {{key_of(2), val_of(2)}, {key_of(1), val_of(1)}};
+        bool threw = false;
+        try { tbtree.bulk_load(unsorted); } catch (const std::invalid_argument&) { threw = true; }
+        // A later write commits whatever is pending; the rejected batch must not be among it
+        tbtree.erase(key_of(3));
+        if (!threw || tbtree.logStats().Records != 1) return false;
+    }
+
+    ThreadByteTree recovered(16, 0.5f);
+    const std::uint64_t replayed = recovered.open_log(path);
+    std::filesystem::remove(path);
+    return replayed == 1 && recovered.scan({}, {}).empty();
+}
+
+static bool test_threadbytetree_evicted_rewrite_log() {
+    const std::string path = (std::filesystem::temp_directory_path() / ("tbt_evicted_" + std::to_string(::getpid()) + ".log")).string();
+    std::filesystem::remove(path);
+    {
+        ThreadByteTree tbtree(16, 0.5f);
+        tbtree.enable_eviction(1); // every entry is over budget: each write evicts what it stored
+        tbtree.open_log(path);
+        const bool stored = tbtree.update(key_of(1), [](std::optional<ByteView>, ByteVector& out) { out = val_of(1); return true; });
+        if (!stored || !tbtree.get(key_of(1)).empty() || tbtree.cacheStats().Evictions == 0) return false;
+    }
+
+    // The write was logged as an erase, not as a put of the value it could no longer read
+    ThreadByteTree recovered(16, 0.5f);
+    const std::uint64_t replayed = recovered.open_log(path);
+    std::filesystem::remove(path);
+    return replayed == 1 && recovered.scan({}, {}).empty();
+}
+
+static bool test_threadbytetree_merge_log() {
+    const std::string path = (std::filesystem::temp_directory_path() / ("tbt_merge_" + std::to_string(::getpid()) + ".log")).string();
+    std::filesystem::remove(path);
+    {
+        ThreadByteTree tbtree(16, 0.5f);
+        tbtree.set_merge_operator(&MergeAddInt64);
+        tbtree.open_log(path);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&tbtree]() {
+                for (int i = 0; i < 500; ++i) tbtree.merge(key_of(i % 10), EncodeInt64(1));
+            });
+        }
+        for (auto& writer : writers) writer.join();
+        if (!tbtree.put_if_absent(key_of(20), val_of(2)) || tbtree.put_if_absent(key_of(20), val_of(3))) return false;
+        if (!tbtree.compare_and_put(key_of(20), ByteView(val_of(2)), val_of(4))) return false;
+        tbtree.update(key_of(21), [](std::optional<ByteView> current, ByteVector& out) { out = {current.has_value() ? uint8_t{0} : uint8_t{7}}; return true; });
+    }
+
+    // Each write is logged as the value it left, so replay needs no merge operator
+    ThreadByteTree recovered(16, 0.5f);
+    recovered.open_log(path);
+    std::filesystem::remove(path);
+    for (int k = 0; k < 10; ++k) {
+        if (DecodeInt64(recovered.get(key_of(k))) != 200) return false;
+    }
+    return recovered.get(key_of(20)) == val_of(4) && recovered.get(key_of(21)) == val_of(7);
+}
+
 int main() {
     int failed = 0;
     auto run = [&](const char* name, bool (*fn)()) {
@@ -79,6 +325,16 @@ int main() {
 
     run("threadbytetree_basic", &test_threadbytetree_basic);
     run("threadbytetree_concurrency", &test_threadbytetree_concurrency);
+    run("threadbytetree_lockfree", &test_threadbytetree_lockfree);
+    run("threadbytetree_zero_copy", &test_threadbytetree_zero_copy);
+    run("threadbytetree_views", &test_threadbytetree_views);
+    run("threadbytetree_scan", &test_threadbytetree_scan);
+    run("threadbytetree_multi", &test_threadbytetree_multi);
+    run("threadbytetree_bulk_load", &test_threadbytetree_bulk_load);
+    run("threadbytetree_log_replay", &test_threadbytetree_log_replay);
+    run("threadbytetree_rejected_batch_log", &test_threadbytetree_rejected_batch_log);
+    run("threadbytetree_evicted_rewrite_log", &test_threadbytetree_evicted_rewrite_log);
+    run("threadbytetree_merge_log", &test_threadbytetree_merge_log);
 
     if (failed == 0) {
         std::cout << "All ThreadByteTree tests passed" << std::endl;
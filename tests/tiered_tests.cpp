@@ -0,0 +1,292 @@
+/*
+ * Tests for TieredThreadByteTree only: reads across memtables and runs, tombstones, flushes and
+ * compactions under small budgets, reopening a directory, and concurrent use.
+ */
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "TieredThreadByteTree.h"
+
+using namespace tbt;
+
+namespace {
+    std::string temp_directory(const char* name) {
+        const auto path = std::filesystem::temp_directory_path() / (std::string("tbt_tiered_") + name + "_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(path);
+        return path.string();
+    }
+
+    ByteVector key_of(int x) {
+        const std::string key = "key:" + std::to_string(1000000 + x);
+        return ByteVector(key.begin(), key.end());
+    }
+
+    ByteVector val_of(int x, int round = 0) {
+        return ByteVector(static_cast<std::size_t>(x % 40 + 1), static_cast<uint8_t>(x + round));
+    }
+
+    // Small memtables, so a few thousand writes go through several flushes and compactions.
+    TieredOptions small_options() {
+        TieredOptions options;
+        options.MemtableBytes = 32 * 1024;
+        options.CompactionTrigger = 3;
+        return options;
+    }
+}
+
+static bool test_tiered_reads_across_levels() {
+    const std::string directory = temp_directory("levels");
+    bool ok = true;
+    {
+        TieredThreadByteTree tree(directory, small_options());
+        const int count = 6000;
+        for (int i = 0; i < count; ++i) tree.put(key_of(i), val_of(i));
+        // Overwrite and erase keys whose first versions are already in runs
+        for (int i = 0; i < count; i += 3) tree.put(key_of(i), val_of(i, 1));
+        for (int i = 1; i < count; i += 3) tree.erase(key_of(i));
+
+        auto check = [&]() {
+            for (int i = 0; i < count; ++i) {
+                ByteVector out;
+                const bool found = tree.get_into(key_of(i), out);
+                if (i % 3 == 0 && !(found && out == val_of(i, 1))) return false;
+                if (i % 3 == 1 && found) return false;
+                if (i % 3 == 2 && !(found && out == val_of(i))) return false;
+            }
+            return tree.get(key_of(count)).empty();
+        };
+        ok = check();
+        tree.flush();
+        ok = ok && check();
+
+        const TieredStats stats = tree.stats();
+        ok = ok && stats.Flushes > 3 && stats.Runs >= 1 && stats.Memtables == 1;
+
+        // Scans merge all levels, skip tombstones and respect bounds and limits
+        const auto page = tree.scan(key_of(100), key_of(200));
+        ok = ok && page.size() == 66 && page.front().Key == key_of(101) && page.back().Key == key_of(198);
+        ok = ok && tree.scan({}, {}).size() == 4000 && tree.scan({}, {}, 5).size() == 5;
+    }
+    std::filesystem::remove_all(directory);
+    return ok;
+}
+
+static bool test_tiered_compaction() {
+    const std::string directory = temp_directory("compaction");
+    bool ok = true;
+    {
+        TieredThreadByteTree tree(directory, small_options());
+        const int count = 20000;
+        for (int i = 0; i < count; ++i) tree.put(key_of(i), val_of(i));
+        for (int i = 0; i < count; i += 2) tree.erase(key_of(i));
+        tree.flush();
+
+        // Give the compactor a moment to catch up: with size tiers growing about threefold, a few
+        // runs per tier are left out of the ~80 flushed
+        auto compacted = [&]() { const TieredStats stats = tree.stats(); return stats.Compactions > 0 && stats.Runs * 5 < stats.Flushes; };
+        for (int wait = 0; wait < 200 && !compacted(); ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ok = compacted();
+        for (int i = 0; i < count && ok; ++i) {
+            ByteVector out;
+            ok = tree.get_into(key_of(i), out) == (i % 2 == 1);
+        }
+    }
+    // Once closed, the directory holds the manifest and one filter per run, nothing else
+    std::size_t tables = 0;
+    std::size_t filters = 0;
+    std::size_t others = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        const auto extension = entry.path().extension();
+        if (extension == ".sst") ++tables;
+        else if (extension == ".filter") ++filters;
+        else if (entry.path().filename() != "MANIFEST") ++others;
+    }
+    std::filesystem::remove_all(directory);
+    return ok && tables > 0 && tables == filters && others == 0;
+}
+
+static bool test_tiered_flush_releases_memtable() {
+    const std::string directory = temp_directory("release");
+    bool ok = true;
+    {
+        TieredThreadByteTree tree(directory);
+        for (int i = 0; i < 1000; ++i) tree.put(key_of(i), val_of(i));
+        // A reader pinned while the flush publishes keeps the replaced Version alive past it
+        std::atomic<bool> done{false};
+        std::thread reader([&]() {
+            while (!done.load()) ok = ok && tree.get(key_of(7)) == val_of(7);
+        });
+        tree.flush();
+        done.store(true);
+        reader.join();
+
+        // No write follows: the flushed memtable must still be released, without another publish
+        for (int wait = 0; wait < 200 && tree.stats().RetiredVersions > 0; ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        const TieredStats stats = tree.stats();
+        ok = ok && stats.Flushes == 1 && stats.RetiredVersions == 0 && tree.get(key_of(7)) == val_of(7);
+    }
+    std::filesystem::remove_all(directory);
+    return ok;
+}
+
+static bool test_tiered_filters_skip_runs() {
+    const std::string directory = temp_directory("filters");
+    bool ok = true;
+    TieredStats stats{};
+    {
+        TieredThreadByteTree tree(directory, small_options());
+        for (int i = 0; i < 5000; ++i) tree.put(key_of(i), val_of(i));
+        tree.flush();
+        for (int i = 5000; i < 15000 && ok; ++i) ok = tree.get(key_of(i)).empty();
+        stats = tree.stats();
+    }
+    std::filesystem::remove_all(directory);
+    // Nearly every run probe of a missing key stops at the filter
+    return ok && stats.Runs > 0 && stats.FilterSkips >= 10000 && stats.FilterFalsePositives * 20 < stats.FilterSkips;
+}
+
+static bool test_tiered_reopen() {
+    const std::string directory = temp_directory("reopen");
+    {
+        TieredThreadByteTree tree(directory, small_options());
+        for (int i = 0; i < 3000; ++i) tree.put(key_of(i), val_of(i));
+        for (int i = 0; i < 3000; i += 5) tree.erase(key_of(i));
+        // Destruction flushes what is still in memory
+    }
+    // Leftovers of an interrupted flush are cleaned up, a lost filter is rebuilt
+    std::ofstream(directory + "/run-999999.sst.tmp") << "partial";
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".filter") {
+            std::filesystem::remove(entry.path());
+            break;
+        }
+    }
+
+    bool ok = true;
+    {
+        TieredThreadByteTree tree(directory, small_options());
+        for (int i = 0; i < 3000 && ok; ++i) {
+            ByteVector out;
+            const bool found = tree.get_into(key_of(i), out);
+            ok = i % 5 == 0 ? !found : (found && out == val_of(i));
+        }
+        ok = ok && !std::filesystem::exists(directory + "/run-999999.sst.tmp");
+    }
+
+    // A damaged manifest is refused
+    std::ofstream(directory + "/MANIFEST") << "garbage\n";
+    bool threw = false;
+    try { TieredThreadByteTree tree(directory, small_options()); } catch (const std::runtime_error&) { threw = true; }
+    std::filesystem::remove_all(directory);
+    return ok && threw;
+}
+
+static bool test_tiered_concurrent() {
+    const std::string directory = temp_directory("concurrent");
+    TieredOptions options = small_options();
+    options.Mode = Concurrency::LockFree;
+    std::atomic<bool> ok{true};
+    {
+        TieredThreadByteTree tree(directory, options);
+        const int writers = 4;
+        const int perWriter = 3000;
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+        for (int w = 0; w < writers; ++w) {
+            threads.emplace_back([&, w]() {
+                for (int i = w; i < writers * perWriter; i += writers) tree.put(key_of(i), val_of(i));
+            });
+        }
+        // Readers only check that whatever they see is the right value
+        std::thread reader([&]() {
+            ByteVector out;
+            for (int i = 0; !done.load(); i = (i + 7919) % (writers * perWriter)) {
+                if (tree.get_into(key_of(i), out) && out != val_of(i)) ok = false;
+            }
+        });
+        for (auto& thread : threads) thread.join();
+        done = true;
+        reader.join();
+        tree.flush();
+
+        for (int i = 0; i < writers * perWriter && ok; ++i) {
+            ByteVector out;
+            if (!tree.get_into(key_of(i), out) || out != val_of(i)) ok = false;
+        }
+    }
+    std::filesystem::remove_all(directory);
+    return ok;
+}
+
+static bool test_tiered_concurrent_readers() {
+    const std::string directory = temp_directory("readers");
+    TieredOptions options = small_options();
+    options.CompactionTrigger = 1000; // the set of runs stays fixed once flushed
+    std::atomic<bool> ok{true};
+    TieredStats stats{};
+    {
+        TieredThreadByteTree tree(directory, options);
+        for (int i = 0; i < 4000; ++i) tree.put(key_of(i), val_of(i));
+        tree.flush();
+        const std::size_t runs = tree.stats().Runs;
+
+        // Lock-free readers on several threads: every probe of every run is counted exactly once
+        const int readers = 4;
+        const int perReader = 2000;
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+                ByteVector out;
+                for (int i = 0; i < perReader; ++i) {
+                    if (tree.get_into(key_of(10000 + r * perReader + i), out)) ok = false;
+                    if (!tree.get_into(key_of((r * 7919 + i) % 4000), out) || out != val_of((r * 7919 + i) % 4000)) ok = false;
+                }
+            });
+        }
+        // Versions keep being replaced while they read
+        for (int i = 4000; i < 6000; ++i) tree.put(key_of(i), val_of(i));
+        for (auto& thread : threads) thread.join();
+        tree.flush();
+        stats = tree.stats();
+        ok = ok && runs > 0 && stats.FilterSkips + stats.FilterFalsePositives >= readers * perReader * runs;
+    }
+    std::filesystem::remove_all(directory);
+    return ok;
+}
+
+int main() {
+    int failed = 0;
+    auto run = [&](const char* name, bool (*fn)()) {
+        bool ok = fn();
+        std::cout << (ok ? "OK: " : "FAIL: ") << name << "\n";
+        if (!ok) ++failed;
+    };
+
+    run("tiered_reads_across_levels", &test_tiered_reads_across_levels);
+    run("tiered_compaction", &test_tiered_compaction);
+    run("tiered_flush_releases_memtable", &test_tiered_flush_releases_memtable);
+    run("tiered_filters_skip_runs", &test_tiered_filters_skip_runs);
+    run("tiered_reopen", &test_tiered_reopen);
+    run("tiered_concurrent", &test_tiered_concurrent);
+    run("tiered_concurrent_readers", &test_tiered_concurrent_readers);
+
+    if (failed == 0) {
+        std::cout << "All Tiered tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << failed << " Tiered test(s) failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,213 @@
+/*
+ * Tests for WriteAheadLog only: record round trip, torn and corrupt tails, group commit under
+ * concurrent writers, and the interval sync policy.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "include/wal.h"
+
+using namespace tbt;
+
+namespace {
+    std::string temp_log(const char* name) {
+        const auto path = std::filesystem::temp_directory_path() / (std::string("tbt_wal_") + name + "_" + std::to_string(::getpid()) + ".log");
+        std::filesystem::remove(path);
+        return path.string();
+    }
+
+    struct Replayed {
+        std::vector<WalRecordType> types;
+        std::vector<std::string> keys;
+        std::vector<std::string> values;
+    };
+
+    Replayed replay(const std::string& path, std::uint64_t& count) {
+        Replayed out;
+        count = WriteAheadLog::Replay(path, [&out](const WalRecord& record) {
+            out.types.push_back(record.Type);
+            out.keys.emplace_back(record.Key.begin(), record.Key.end());
+            out.values.emplace_back(record.Value.begin(), record.Value.end());
+        });
+        return out;
+    }
+}
+
+static bool test_wal_crc32c() {
+    // Reference value of CRC-32C for the ASCII digits 1..9
+    return Crc32c(AsBytes("123456789")) == 0xE3069283u && Crc32c({}) == 0;
+}
+
+static bool test_wal_round_trip() {
+    const std::string path = temp_log("round_trip");
+    {
+        WriteAheadLog log(path);
+        const std::string big(100000, 'v');
+        const WalRecord batch[] = {
+            {WalRecordType::Put, AsBytes("a"), AsBytes("1")},
+            {WalRecordType::Put, AsBytes("b"), AsBytes(big)},
+            {WalRecordType::Erase, AsBytes("a"), {}},
+        };
+        log.Commit(log.Append(batch));
+        const WalRecord empty{WalRecordType::Put, {}, {}};
+        log.Commit(log.Append({&empty, 1}));
+        const WalStats stats = log.Stats();
+        if (stats.Records != 4 || stats.Syncs != 2 || stats.Writes != 2) return false;
+    }
+
+    std::uint64_t count = 0;
+    const Replayed replayed = replay(path, count);
+    std::filesystem::remove(path);
+    return count == 4 && replayed.keys[1] == "b" && replayed.values[1].size() == 100000 &&
+           replayed.types[2] == WalRecordType::Erase && replayed.keys[3].empty();
+}
+
+static bool test_wal_torn_tail() {
+    const std::string path = temp_log("torn_tail");
+    {
+        WriteAheadLog log(path, {SyncPolicy::None});
+        for (int i = 0; i < 10; ++i) {
+            const std::string key = "key" + std::to_string(i);
+            const WalRecord record{WalRecordType::Put, AsBytes(key), AsBytes("value")};
+            log.Commit(log.Append({&record, 1}));
+        }
+    }
+    // A crash in the middle of the last record leaves it cut short
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 3);
+
+    std::uint64_t count = 0;
+    replay(path, count);
+    if (count != 9 || std::filesystem::file_size(path) >= size - 3) return false;
+
+    // Records appended after recovery follow the last intact one
+    {
+        WriteAheadLog log(path);
+        const WalRecord record{WalRecordType::Put, AsBytes("after"), AsBytes("crash")};
+        log.Commit(log.Append({&record, 1}));
+    }
+    const Replayed replayed = replay(path, count);
+    std::filesystem::remove(path);
+    return count == 10 && replayed.keys.back() == "after";
+}
+
+static bool test_wal_corrupt_record() {
+    const std::string path = temp_log("corrupt");
+    {
+        WriteAheadLog log(path);
+        for (int i = 0; i < 3; ++i) {
+            const WalRecord record{WalRecordType::Put, AsBytes("k"), AsBytes("vvvv")};
+            log.Commit(log.Append({&record, 1}));
+        }
+    }
+    // Flip a value byte of the second record: replay stops before it
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(18 + 15);
+        file.put('X');
+    }
+    std::uint64_t count = 0;
+    replay(path, count);
+    std::filesystem::remove(path);
+    return count == 1;
+}
+
+static bool test_wal_group_commit() {
+    // Concurrent writers waiting for fdatasync share syncs: fewer syncs than records.
+    const std::string path = temp_log("group_commit");
+    const int threads = 8;
+    const int perThread = 200;
+    WalStats stats{};
+    {
+        WriteAheadLog log(path);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&log, t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    const std::string key = std::to_string(t) + ":" + std::to_string(i);
+                    const WalRecord record{WalRecordType::Put, AsBytes(key), AsBytes(key)};
+                    log.Commit(log.Append({&record, 1}));
+                }
+            });
+        }
+        for (auto& writer : writers) writer.join();
+        stats = log.Stats();
+    }
+
+    std::uint64_t count = 0;
+    const Replayed replayed = replay(path, count);
+    std::filesystem::remove(path);
+    if (count != threads * perThread || stats.Records != count) return false;
+    // Per writer, records replay in the order they were committed
+    std::vector<int> next(threads, 0);
+    for (const std::string& key : replayed.keys) {
+        const int t = std::stoi(key.substr(0, key.find(':')));
+        if (std::stoi(key.substr(key.find(':') + 1)) != next[static_cast<std::size_t>(t)]++) return false;
+    }
+    return stats.Syncs < stats.Records;
+}
+
+static bool test_wal_interval_sync() {
+    const std::string path = temp_log("interval");
+    WriteAheadLog log(path, {SyncPolicy::Interval, std::chrono::milliseconds(5)});
+    const WalRecord record{WalRecordType::Put, AsBytes("k"), AsBytes("v")};
+    log.Commit(log.Append({&record, 1}));
+    // Written to the OS at commit, synced by the background thread shortly after
+    bool synced = false;
+    for (int i = 0; i < 400 && !synced; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        synced = log.Stats().Syncs > 0;
+    }
+    std::uint64_t count = 0;
+    replay(path, count);
+    std::filesystem::remove(path);
+    return synced && count == 1;
+}
+
+static bool test_wal_rejects_bad_interval() {
+    const std::string path = temp_log("bad_interval");
+    for (const auto interval : {std::chrono::milliseconds(0), std::chrono::milliseconds(-5)}) {
+        bool threw = false;
+        try { WriteAheadLog log(path, {SyncPolicy::Interval, interval}); } catch (const std::invalid_argument&) { threw = true; }
+        if (!threw || std::filesystem::exists(path)) return false;
+    }
+    // Only the Interval policy uses it
+    { WriteAheadLog log(path, {SyncPolicy::None, std::chrono::milliseconds(0)}); }
+    std::filesystem::remove(path);
+    return true;
+}
+
+int main() {
+    int failed = 0;
+    auto run = [&](const char* name, bool (*fn)()) {
+        bool ok = fn();
+        std::cout << (ok ? "OK: " : "FAIL: ") << name << "\n";
+        if (!ok) ++failed;
+    };
+
+    run("wal_crc32c", &test_wal_crc32c);
+    run("wal_round_trip", &test_wal_round_trip);
+    run("wal_torn_tail", &test_wal_torn_tail);
+    run("wal_corrupt_record", &test_wal_corrupt_record);
+    run("wal_group_commit", &test_wal_group_commit);
+    run("wal_interval_sync", &test_wal_interval_sync);
+    run("wal_rejects_bad_interval", &test_wal_rejects_bad_interval);
+
+    if (failed == 0) {
+        std::cout << "All WAL tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << failed << " WAL test(s) failed" << std::endl;
+    return 1;
+}